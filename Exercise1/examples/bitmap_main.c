@@ -0,0 +1,191 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "bf.h"
+#include "ht_table.h"
+#include "sht_table.h"
+#include "bitmap_index.h"
+#include <assert.h>
+
+#define RECORDS_NUM 200000 // you can change it if you want
+#define DELETES 20000
+#define BUCKETS 1000
+#define INDEX_BUCKETS 64
+#define FILE_NAME "bitmap_data.db"
+#define CITY_BITMAP "bitmap_city.db"
+#define NAME_BITMAP "bitmap_name.db"
+#define CITY_INDEX "bitmap_sht_city.db"
+
+#define CALL_OR_DIE(call)     \
+  {                           \
+    BF_ErrorCode code = call; \
+    if (code != BF_OK) {      \
+      BF_PrintError(code);    \
+      exit(code);             \
+    }                         \
+  }
+
+static long elapsed(struct timespec start, struct timespec end) {
+  return (end.tv_sec - start.tv_sec) * 1000000L + (end.tv_nsec - start.tv_nsec) / 1000;
+}
+
+// The bitmap indexes follow the primary file through the callbacks of HT_DeleteEntry, like an index of rids
+typedef struct {
+  BM_info* city;
+  BM_info* name;
+} Bitmaps;
+
+static void unindex(int key, Record* record, int rid, void* context) {
+  Bitmaps* bitmaps = context;
+  int error = BM_DeleteEntry(bitmaps->city, *record, rid);
+  assert(error == 0);
+  error = BM_DeleteEntry(bitmaps->name, *record, rid);
+  assert(error == 0);
+}
+
+static void reindex(Record* old, int oldRid, Record* updated, int newRid, void* context) {
+  Bitmaps* bitmaps = context;
+  int error = BM_DeleteEntry(bitmaps->city, *old, oldRid);
+  assert(error == 0);
+  error = BM_DeleteEntry(bitmaps->name, *old, oldRid);
+  assert(error == 0);
+  error = BM_InsertEntry(bitmaps->city, *updated, newRid);
+  assert(error == 0);
+  error = BM_InsertEntry(bitmaps->name, *updated, newRid);
+  assert(error == 0);
+}
+
+static void countMaria(Record* record, int rid, void* context) {
+  if (strcmp(record->name, "Maria") == 0) (*(long int*) context)++;
+}
+
+static void checkOrder(int rid, void* context) {
+  int* last = context;
+  assert(rid > *last);
+  *last = rid;
+}
+
+// city = 'Tokyo' AND name = 'Maria', city = 'Tokyo' OR name = 'Maria' and NOT city = 'Tokyo', from the bitmaps only
+static void query(Bitmaps* bitmaps, Record** live) {
+  long int both = 0, either = 0, notTokyo = 0, records = 0;
+  for (int id = 0; id < RECORDS_NUM; id++) {
+    if (live[id] == NULL) continue;
+    bool tokyo = strcmp(live[id]->city, "Tokyo") == 0;
+    bool maria = strcmp(live[id]->name, "Maria") == 0;
+    both += tokyo && maria;
+    either += tokyo || maria;
+    notTokyo += !tokyo;
+    records++;
+  }
+
+  struct timespec start, end;
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  BM_Bitmap* tokyo = BM_Lookup(bitmaps->city, "Tokyo");
+  BM_Bitmap* maria = BM_Lookup(bitmaps->name, "Maria");
+  BM_Bitmap* and = BM_And(tokyo, maria);
+  long int count = BM_Count(and);
+  clock_gettime(CLOCK_MONOTONIC, &end);
+  fprintf(stderr, "Bitmaps: %ld records with city = 'Tokyo' AND name = 'Maria' in %ld us\n", count, elapsed(start, end));
+  assert(count == both);
+
+  BM_Bitmap* or = BM_Or(tokyo, maria);
+  BM_Bitmap* not = BM_Not(bitmaps->city, tokyo);
+  assert(BM_Count(or) == either);
+  assert(BM_Count(not) == notTokyo);
+  assert(BM_Count(tokyo) + BM_Count(not) == records);
+
+  int last = -1;
+  BM_ForEach(and, checkOrder, &last);
+
+  BM_Free(tokyo);
+  BM_Free(maria);
+  BM_Free(and);
+  BM_Free(or);
+  BM_Free(not);
+}
+
+int main() {
+  BF_Init(LRU);
+
+  Record* records = malloc(sizeof(Record) * RECORDS_NUM);
+  Record** live = malloc(sizeof(Record*) * RECORDS_NUM);
+  srand(12569874);
+  for (int i = 0; i < RECORDS_NUM; i++) {
+    records[i] = randomRecord();
+    live[records[i].id] = &records[i];
+  }
+
+  int error = HT_CreateFile(FILE_NAME, BUCKETS);
+  assert(error == 0);
+  HT_info* info = HT_OpenFile(FILE_NAME);
+  error = HT_BulkLoad(info, records, RECORDS_NUM);
+  assert(error == 0);
+  error = HT_CloseFile(info);
+  assert(error == 0);
+
+  // A covering hash index on the city answers the same count, one entry per record
+  error = BM_CreateIndex(CITY_BITMAP, FILE_NAME, CITY);
+  assert(error == 0);
+  error = BM_CreateIndex(NAME_BITMAP, FILE_NAME, NAME);
+  assert(error == 0);
+  SHT_options options = { 0 };
+  options.key = RECORD_KEY(CITY);
+  options.rids = true;
+  options.include = RECORD_KEY(NAME);
+  error = SHT_CreateSecondaryIndexWithOptions(CITY_INDEX, INDEX_BUCKETS, FILE_NAME, options);
+  assert(error == 0);
+  StatisticsBM(CITY_BITMAP);
+
+  info = HT_OpenFile(FILE_NAME);
+  Bitmaps bitmaps = { BM_OpenIndex(CITY_BITMAP), BM_OpenIndex(NAME_BITMAP) };
+  SHT_info* index = SHT_OpenSecondaryIndex(CITY_INDEX);
+  assert(bitmaps.city != NULL && bitmaps.name != NULL && index != NULL);
+
+  struct timespec start, end;
+  long int covered = 0;
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  int blocksRead = SHT_SecondaryGetCovered(index, "Tokyo", RECORD_KEY(CITY) | RECORD_KEY(NAME), countMaria, &covered);
+  clock_gettime(CLOCK_MONOTONIC, &end);
+  fprintf(stderr, "Hash index: %ld records with city = 'Tokyo' AND name = 'Maria' in %ld us, %d index blocks read\n",
+    covered, elapsed(start, end), blocksRead);
+  query(&bitmaps, live);
+
+  int bitmapBlocks, nameBlocks, indexBlocks;
+  CALL_OR_DIE(BF_GetBlockCounter(bitmaps.city->fileDesc, &bitmapBlocks));
+  CALL_OR_DIE(BF_GetBlockCounter(bitmaps.name->fileDesc, &nameBlocks));
+  CALL_OR_DIE(BF_GetBlockCounter(index->fileDesc, &indexBlocks));
+  fprintf(stderr, "Index blocks: %d for the city bitmaps, %d for the name bitmaps, %d for the hash index on the city\n",
+    bitmapBlocks, nameBlocks, indexBlocks);
+  error = SHT_CloseSecondaryIndex(index);
+  assert(error == 0);
+
+  // Deleted records leave their bitmaps, the ones that fill the holes move their bits
+  for (int i = 0; i < DELETES; i++) {
+    int id = rand() % RECORDS_NUM;
+    int deleted = HT_DeleteEntry(info, id, unindex, reindex, &bitmaps);
+    assert(deleted == (live[id] != NULL));
+    live[id] = NULL;
+  }
+  query(&bitmaps, live);
+  error = BM_CloseIndex(bitmaps.city);
+  assert(error == 0);
+  error = BM_CloseIndex(bitmaps.name);
+  assert(error == 0);
+
+  // Reopened, the bitmaps are read back from their chains
+  bitmaps.city = BM_OpenIndex(CITY_BITMAP);
+  bitmaps.name = BM_OpenIndex(NAME_BITMAP);
+  query(&bitmaps, live);
+  fprintf(stderr, "After %d deletes and a reopen, every count matches the records\n", DELETES);
+
+  error = BM_CloseIndex(bitmaps.city);
+  assert(error == 0);
+  error = BM_CloseIndex(bitmaps.name);
+  assert(error == 0);
+  error = HT_CloseFile(info);
+  assert(error == 0);
+  free(records);
+  free(live);
+  BF_Close();
+}
@@ -0,0 +1,85 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "bf.h"
+#include "ht_table.h"
+#include "sht_table.h"
+#include <assert.h>
+
+#define RECORDS_NUM 5000 // you can change it if you want
+#define BUCKETS 64
+#define FILTER_BYTES 128  // 1024 bits for about 80 ids per bucket
+#define LOOKUPS 1000
+#define FILE_NAME "data.db"
+#define INDEX_NAME "index.db"
+
+#define CALL_OR_DIE(call)     \
+  {                           \
+    BF_ErrorCode code = call; \
+    if (code != BF_OK) {      \
+      BF_PrintError(code);    \
+      exit(code);             \
+    }                         \
+  }
+
+int main() {
+  BF_Init(LRU);
+
+  // The same records, once without and once with Bloom filters
+  for (int filterBytes = 0; filterBytes <= FILTER_BYTES; filterBytes += FILTER_BYTES) {
+    HT_options options = { 0 };
+    options.filterBytes = filterBytes;
+    SHT_options indexOptions = { 0 };
+    indexOptions.filterBytes = filterBytes;
+
+    remove(FILE_NAME);
+    remove(INDEX_NAME);
+    int error = HT_CreateFileWithOptions(FILE_NAME, BUCKETS, options);
+    assert(error == 0);
+    error = SHT_CreateSecondaryIndexWithOptions(INDEX_NAME, BUCKETS, FILE_NAME, indexOptions);
+    assert(error == 0);
+    HT_info* info = HT_OpenFile(FILE_NAME);
+    SHT_info* index_info = SHT_OpenSecondaryIndex(INDEX_NAME);
+    assert(info != NULL && index_info != NULL);
+
+    srand(12569874);
+    for (int id = 0; id < RECORDS_NUM; ++id) {
+      Record record = randomRecord();
+      record.id = id;
+      int block_id = HT_InsertEntry(info, record);
+      assert(block_id != -1);
+      SHT_SecondaryInsertEntry(index_info, record, block_id);
+    }
+
+    // Ids past RECORDS_NUM and names that were never inserted are all misses
+    int blocksRead = 0, falsePositives = 0;
+    for (int i = 0; i < LOOKUPS; i++) {
+      int id = RECORDS_NUM + rand();
+      int blocks = HT_GetAllEntries(info, &id);
+      blocksRead += blocks;
+      if (filterBytes > 0 && blocks > 1) falsePositives++;
+    }
+    printf("Filter bytes %d: blocks read per missing id %.2f", filterBytes, (double) blocksRead / LOOKUPS);
+    if (filterBytes > 0) printf(", false positives %.1f%%", 100.0 * falsePositives / LOOKUPS);
+    printf("\n");
+
+    // A missing name reads no primary block either way, the filter saves the walk of the index chain
+    char name[15];
+    struct timespec start, end;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (int i = 0; i < LOOKUPS; i++) {
+      sprintf(name, "Nobody%d", i);
+      int blocks = SHT_SecondaryGetAllEntries(info, index_info, name);
+      assert(blocks == 0);
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    long ns = (end.tv_sec - start.tv_sec) * 1000000000L + (end.tv_nsec - start.tv_nsec);
+    printf("Filter bytes %d: %ld ns per missing name\n", filterBytes, ns / LOOKUPS);
+
+    SHT_CloseSecondaryIndex(index_info);
+    HT_CloseFile(info);
+  }
+
+  BF_Close();
+}
@@ -0,0 +1,98 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "bf.h"
+#include "bpt_file.h"
+#include <assert.h>
+
+#define RECORDS_NUM 100000 // you can change it if you want
+#define RANGES 100
+#define INSERT_FILE_NAME "bpt_insert.db"
+#define BULK_FILE_NAME "bpt_bulk.db"
+
+#define CALL_OR_DIE(call)     \
+  {                           \
+    BF_ErrorCode code = call; \
+    if (code != BF_OK) {      \
+      BF_PrintError(code);    \
+      exit(code);             \
+    }                         \
+  }
+
+// What a range scan has seen so far
+typedef struct {
+  int records;
+  int last;
+} Scan;
+
+static void countRecord(Record* record, int blockId, void* context) {
+  Scan* scan = context;
+  assert(scan->records == 0 || record->id >= scan->last);
+  scan->last = record->id;
+  scan->records++;
+}
+
+// Range queries over 1% of the ids, each should read about 1% of the blocks
+static void rangeQueries(BPT_info* info, const char* name) {
+  int blocks;
+  CALL_OR_DIE(BF_GetBlockCounter(info->fileDesc, &blocks));
+
+  int width = RECORDS_NUM / 100;
+  long int blocksRead = 0;
+  for (int i = 0; i < RANGES; i++) {
+    int low = rand() % (RECORDS_NUM - width);
+    Scan scan = { 0, 0 };
+    int read = BPT_RangeScan(info, low, low + width - 1, countRecord, &scan);
+    assert(read > 0 && scan.records == width);
+    blocksRead += read;
+  }
+  printf("%s: height %d, %d blocks, a 1%% range reads %.1f blocks (%.2f%% of the file)\n", name, info->height,
+    blocks, (double) blocksRead / RANGES, 100.0 * blocksRead / RANGES / blocks);
+}
+
+int main() {
+  BF_Init(LRU);
+
+  // The ids come out in order, a shuffled copy is inserted one by one
+  Record* records = malloc(sizeof(Record) * RECORDS_NUM);
+  Record* shuffled = malloc(sizeof(Record) * RECORDS_NUM);
+  srand(12569874);
+  for (int i = 0; i < RECORDS_NUM; i++)
+    shuffled[i] = records[i] = randomRecord();
+  for (int i = RECORDS_NUM - 1; i > 0; i--) {
+    int j = rand() % (i + 1);
+    Record swap = shuffled[i]; shuffled[i] = shuffled[j]; shuffled[j] = swap;
+  }
+
+  int error = BPT_CreateFile(INSERT_FILE_NAME);
+  assert(error == 0);
+  BPT_info* inserted = BPT_OpenFile(INSERT_FILE_NAME);
+  assert(inserted != NULL);
+  for (int i = 0; i < RECORDS_NUM; i++) {
+    int block = BPT_InsertEntry(inserted, shuffled[i]);
+    assert(block != -1);
+  }
+  rangeQueries(inserted, "Inserted");
+
+  error = BPT_CreateFile(BULK_FILE_NAME);
+  assert(error == 0);
+  BPT_info* loaded = BPT_OpenFile(BULK_FILE_NAME);
+  assert(loaded != NULL);
+  error = BPT_BulkLoad(loaded, records, RECORDS_NUM);
+  assert(error == 0);
+  rangeQueries(loaded, "Bulk loaded");
+
+  printf("RUN GetAllEntries\n");
+  int id = rand() % RECORDS_NUM;
+  printf("Blocks read: %d\n", BPT_GetAllEntries(loaded, &id));
+
+  BPT_CloseFile(inserted);
+  BPT_CloseFile(loaded);
+
+  TreeStatisticsBPT(INSERT_FILE_NAME);
+  TreeStatisticsBPT(BULK_FILE_NAME);
+
+  free(records);
+  free(shuffled);
+  BF_Close();
+}
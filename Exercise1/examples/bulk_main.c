@@ -0,0 +1,77 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "bf.h"
+#include "ht_table.h"
+#include <assert.h>
+
+#define RECORDS_NUM 200000 // you can change it if you want
+#define BUCKETS 1000
+#define INSERT_FILE "insert.db"
+#define BULK_FILE "bulk.db"
+
+#define CALL_OR_DIE(call)     \
+  {                           \
+    BF_ErrorCode code = call; \
+    if (code != BF_OK) {      \
+      BF_PrintError(code);    \
+      exit(code);             \
+    }                         \
+  }
+
+static long elapsed(struct timespec start, struct timespec end) {
+  return (end.tv_sec - start.tv_sec) * 1000000000L + (end.tv_nsec - start.tv_nsec);
+}
+
+int main() {
+  BF_Init(LRU);
+
+  Record* records = malloc(sizeof(Record) * RECORDS_NUM);
+  srand(12569874);
+  for (int i = 0; i < RECORDS_NUM; i++)
+    records[i] = randomRecord();
+
+  struct timespec start, end;
+
+  // One record at a time
+  int error = HT_CreateFile(INSERT_FILE, BUCKETS);
+  assert(error == 0);
+  HT_info* info = HT_OpenFile(INSERT_FILE);
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  for (int i = 0; i < RECORDS_NUM; i++) {
+    int block = HT_InsertEntry(info, records[i]);
+    assert(block != -1);
+  }
+  HT_CloseFile(info);
+  clock_gettime(CLOCK_MONOTONIC, &end);
+  long inserted = elapsed(start, end);
+
+  // All records at once
+  error = HT_CreateFile(BULK_FILE, BUCKETS);
+  assert(error == 0);
+  info = HT_OpenFile(BULK_FILE);
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  error = HT_BulkLoad(info, records, RECORDS_NUM);
+  assert(error == 0);
+  HT_CloseFile(info);
+  clock_gettime(CLOCK_MONOTONIC, &end);
+  long loaded = elapsed(start, end);
+
+  // Both files hold the same records
+  info = HT_OpenFile(BULK_FILE);
+  for (int i = 0; i < 1000; i++) {
+    Record record;
+    int id = rand() % RECORDS_NUM;
+    int blocksRead = HT_GetEntry(info, id, &record);
+    assert(blocksRead > 0);
+    assert(strcmp(record.name, records[id].name) == 0);
+  }
+  HT_CloseFile(info);
+
+  printf("HT_InsertEntry: %ld ms for %d records\n", inserted / 1000000, RECORDS_NUM);
+  printf("HT_BulkLoad:    %ld ms for %d records\n", loaded / 1000000, RECORDS_NUM);
+
+  free(records);
+  BF_Close();
+}
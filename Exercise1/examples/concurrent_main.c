@@ -0,0 +1,195 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <pthread.h>
+#include "bf.h"
+#include "ht_table.h"
+#include "sht_table.h"
+#include <assert.h>
+
+#define RECORDS_NUM 20000 // you can change it if you want
+#define BUCKETS 256
+#define MAX_THREADS 8
+#define UNIQUE_KEYS 2000
+#define NAMES 12
+
+#define CALL_OR_DIE(call)     \
+  {                           \
+    BF_ErrorCode code = call; \
+    if (code != BF_OK) {      \
+      BF_PrintError(code);    \
+      exit(code);             \
+    }                         \
+  }
+
+// The files a run inserts into, and the block every record landed in
+typedef struct {
+  HT_info* info;
+  SHT_info* index;
+  Record* records;
+  int* blocks;
+} Run;
+
+// One producer inserts records [first, first + count) of the run
+typedef struct {
+  Run* run;
+  int first;
+  int count;
+  int inserted;
+} Producer;
+
+static void* produce(void* argument) {
+  Producer* producer = argument;
+  Run* run = producer->run;
+  for (int i = producer->first; i < producer->first + producer->count; i++) {
+    int block_id = HT_InsertEntry(run->info, run->records[i]);
+    if (block_id == -1) continue;
+    producer->inserted++;
+    if (run->blocks != NULL) run->blocks[i] = block_id;
+    if (run->index != NULL) {
+      int error = SHT_SecondaryInsertEntry(run->index, run->records[i], block_id);
+      assert(error == 0);
+    }
+  }
+  return NULL;
+}
+
+// Inserts count records with threads producers, each taking every record or an equal share of them
+static int produceAll(Run* run, int count, int threads, bool shared) {
+  pthread_t workers[MAX_THREADS];
+  Producer producers[MAX_THREADS];
+  for (int t = 0; t < threads; t++) {
+    producers[t].run = run;
+    producers[t].first = shared ? 0 : t * (count / threads);
+    producers[t].count = shared ? count : (t == threads - 1 ? count - producers[t].first : count / threads);
+    producers[t].inserted = 0;
+    int error = pthread_create(&workers[t], NULL, produce, &producers[t]);
+    assert(error == 0);
+  }
+
+  int inserted = 0;
+  for (int t = 0; t < threads; t++) {
+    pthread_join(workers[t], NULL);
+    inserted += producers[t].inserted;
+  }
+  return inserted;
+}
+
+static long elapsed(struct timespec start, struct timespec end) {
+  return (end.tv_sec - start.tv_sec) * 1000000L + (end.tv_nsec - start.tv_nsec) / 1000;
+}
+
+static void countRecord(int key, Record* record, int rid, void* context) {
+  (*(int*) context)++;
+}
+
+static int compareInts(const void* a, const void* b) {
+  return *(const int*) a - *(const int*) b;
+}
+
+// Every record is found once, in the block its insert returned, and the index has every <name, block>
+// pair of the inserts exactly once: a lookup reads one primary block per pair
+static void check(Run* run, const char** names) {
+  int scanned = 0;
+  int blocksRead = HT_ScanEntries(run->info, countRecord, &scanned);
+  assert(blocksRead != -1);
+  assert(scanned == RECORDS_NUM);
+
+  for (int i = 0; i < RECORDS_NUM; i++) {
+    Record record;
+    blocksRead = HT_GetEntry(run->info, run->records[i].id, &record);
+    assert(blocksRead == run->blocks[i]);
+    assert(strcmp(record.name, run->records[i].name) == 0 && strcmp(record.city, run->records[i].city) == 0);
+  }
+
+  int* blocks = malloc(sizeof(int) * RECORDS_NUM);
+  for (int n = 0; n < NAMES && names[n] != NULL; n++) {
+    int count = 0;
+    for (int i = 0; i < RECORDS_NUM; i++)
+      if (strcmp(run->records[i].name, names[n]) == 0) blocks[count++] = run->blocks[i];
+    qsort(blocks, count, sizeof(int), compareInts);
+
+    int pairs = 0;
+    for (int i = 0; i < count; i++)
+      if (i == 0 || blocks[i] != blocks[i - 1]) pairs++;
+    blocksRead = SHT_SecondaryGetAllEntries(run->info, run->index, (char*) names[n]);
+    assert(blocksRead == pairs);
+  }
+  free(blocks);
+}
+
+// Runs print every insert, so the timings go to stderr: ./build/concurrent_main [threads] > /dev/null
+int main(int argc, char** argv) {
+  int maxThreads = argc > 1 ? atoi(argv[1]) : 4;
+  if (maxThreads < 1 || maxThreads > MAX_THREADS) maxThreads = 4;
+  BF_Init(LRU);
+
+  Record* records = malloc(sizeof(Record) * RECORDS_NUM);
+  const char* names[NAMES] = { NULL };
+  srand(12569874);
+  for (int i = 0; i < RECORDS_NUM; i++) {
+    records[i] = randomRecord();
+    for (int n = 0; n < NAMES; n++) {
+      if (names[n] != NULL && strcmp(names[n], records[i].name) != 0) continue;
+      names[n] = records[i].name;
+      break;
+    }
+  }
+
+  HT_options options = { 0 };
+  options.hash = MURMUR_HASH;
+  options.fingerprints = true;
+  SHT_options indexOptions = { 0 };
+  indexOptions.fingerprints = true;
+
+  Run runs[MAX_THREADS + 1];
+  int count = 0;
+  for (int threads = 1; threads <= maxThreads; threads *= 2, count++) {
+    char fileName[32], indexName[32];
+    sprintf(fileName, "concurrent_%d.db", threads);
+    sprintf(indexName, "concurrent_index_%d.db", threads);
+    int error = HT_CreateFileWithOptions(fileName, BUCKETS, options);
+    assert(error == 0);
+    error = SHT_CreateSecondaryIndexWithOptions(indexName, BUCKETS, fileName, indexOptions);
+    assert(error == 0);
+
+    Run* run = &runs[count];
+    run->info = HT_OpenFile(fileName);
+    run->index = SHT_OpenSecondaryIndex(indexName);
+    run->records = records;
+    run->blocks = malloc(sizeof(int) * RECORDS_NUM);
+
+    struct timespec start, end;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    int inserted = produceAll(run, RECORDS_NUM, threads, false);
+    assert(inserted == RECORDS_NUM);
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    long micros = elapsed(start, end);
+    fprintf(stderr, "%d producer(s): %ld us, %ld inserts/s\n", threads, micros, RECORDS_NUM * 1000000L / (micros + 1));
+
+    check(run, names);
+  }
+  fprintf(stderr, "Every file and index is consistent with its inserts\n");
+
+  // Every producer tries to insert the same keys, each of them must go in exactly once
+  options.unique = true;
+  int error = HT_CreateFileWithOptions("concurrent_unique.db", BUCKETS, options);
+  assert(error == 0);
+  Run unique = { HT_OpenFile("concurrent_unique.db"), NULL, records, NULL };
+  int inserted = produceAll(&unique, UNIQUE_KEYS, maxThreads, true);
+  int scanned = 0;
+  int blocksRead = HT_ScanEntries(unique.info, countRecord, &scanned);
+  assert(blocksRead != -1);
+  fprintf(stderr, "Unique file: %d of %d racing inserts went in, %d records\n", inserted, UNIQUE_KEYS * maxThreads, scanned);
+  assert(inserted == UNIQUE_KEYS && scanned == UNIQUE_KEYS);
+  HT_CloseFile(unique.info);
+
+  for (int r = 0; r < count; r++) {
+    SHT_CloseSecondaryIndex(runs[r].index);
+    HT_CloseFile(runs[r].info);
+    free(runs[r].blocks);
+  }
+  free(records);
+  BF_Close();
+}
@@ -0,0 +1,130 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "bf.h"
+#include "ht_table.h"
+#include "sht_table.h"
+#include <assert.h>
+
+#define RECORDS_NUM 50000 // you can change it if you want
+#define BUCKETS 256
+#define INDEX_BUCKETS 16
+#define FILE_NAME "covering_data.db"
+#define INDEX_NAME "covering_index.db"
+
+#define CALL_OR_DIE(call)     \
+  {                           \
+    BF_ErrorCode code = call; \
+    if (code != BF_OK) {      \
+      BF_PrintError(code);    \
+      exit(code);             \
+    }                         \
+  }
+
+// The ids of everyone with a name, as the covering index hands them over
+typedef struct {
+  long int sum;
+  int count;
+} Ids;
+
+static void collectId(Record* record, int rid, void* context) {
+  Ids* ids = context;
+  ids->sum += record->id;
+  ids->count++;
+}
+
+// The files whose covering index follows the primary file through deletes and updates
+typedef struct {
+  HT_info* info;
+  SHT_info* index;
+} Files;
+
+static void unindex(int key, Record* record, int rid, void* context) {
+  Files* files = context;
+  int error = SHT_SecondaryDeleteEntry(files->info, files->index, *record, rid);
+  assert(error == 0);
+}
+
+static void reindex(Record* old, int oldRid, Record* updated, int newRid, void* context) {
+  Files* files = context;
+  int error = SHT_SecondaryDeleteEntry(files->info, files->index, *old, oldRid);
+  assert(error == 0);
+  error = SHT_SecondaryInsertEntry(files->index, *updated, newRid);
+  assert(error == 0);
+}
+
+// Lookups through the primary file print every record, so the results go to stderr: ./build/covering_main > /dev/null
+int main() {
+  BF_Init(LRU);
+
+  // The index holds the id and the city of every record next to its name
+  int error = HT_CreateFile(FILE_NAME, BUCKETS);
+  assert(error == 0);
+  SHT_options options = { 0 };
+  options.rids = true;
+  options.include = RECORD_KEY(ID) | RECORD_KEY(CITY);
+  error = SHT_CreateSecondaryIndexWithOptions(INDEX_NAME, INDEX_BUCKETS, FILE_NAME, options);
+  assert(error == 0);
+
+  Files files;
+  files.info = HT_OpenFile(FILE_NAME);
+  files.index = SHT_OpenSecondaryIndex(INDEX_NAME);
+
+  Record* records = malloc(sizeof(Record) * RECORDS_NUM);
+  char* alive = malloc(RECORDS_NUM);
+  srand(12569874);
+  for (int i = 0; i < RECORDS_NUM; i++) {
+    records[i] = randomRecord();
+    alive[i] = 1;
+    int rid;
+    HT_InsertEntryWithRid(files.info, records[i], &rid);
+    error = SHT_SecondaryInsertEntry(files.index, records[i], rid);
+    assert(error == 0);
+  }
+
+  // Some records go away and some move to another name, the index keeps up through the callbacks
+  for (int id = 0; id < RECORDS_NUM; id += 7) {
+    int deleted = HT_DeleteEntry(files.info, id, unindex, reindex, &files);
+    assert(deleted == 1);
+    alive[id] = 0;
+  }
+  for (int id = 3; id < RECORDS_NUM; id += 11) {
+    if (!alive[id]) continue;
+    Record record = randomRecord();
+    record.id = id;
+    int updated = HT_UpdateEntry(files.info, id, record, reindex, &files);
+    assert(updated == 1);
+    records[id] = record;
+  }
+
+  // "The ids of everyone named X": the index alone against the index and the primary blocks
+  char* name = records[1].name;
+  Ids expected = { 0, 0 };
+  for (int id = 0; id < RECORDS_NUM; id++) {
+    if (!alive[id] || strcmp(records[id].name, name) != 0) continue;
+    expected.sum += id;
+    expected.count++;
+  }
+
+  Ids ids = { 0, 0 };
+  int indexBlocks = SHT_SecondaryGetCovered(files.index, name, RECORD_KEY(ID), collectId, &ids);
+  assert(indexBlocks > 0 && ids.count == expected.count && ids.sum == expected.sum);
+  int primaryBlocks = SHT_SecondaryGetAllEntries(files.info, files.index, name);
+  int blocksRead = SHT_SecondaryGetCovered(files.index, name, RECORD_KEY(SURNAME), collectId, &ids);
+  assert(blocksRead == -1);
+
+  int blocks;
+  CALL_OR_DIE(BF_GetBlockCounter(files.index->fileDesc, &blocks));
+  fprintf(stderr, "%d records named %s\n", ids.count, name);
+  fprintf(stderr, "Index only:            %d index blocks\n", indexBlocks);
+  fprintf(stderr, "Index and primary file: %d index blocks + %d primary blocks\n", indexBlocks, primaryBlocks);
+  fprintf(stderr, "The index takes %d blocks for %d records\n", blocks, RECORDS_NUM);
+
+  error = SHT_CloseSecondaryIndex(files.index);
+  assert(error == 0);
+  error = HT_CloseFile(files.info);
+  assert(error == 0);
+  free(records);
+  free(alive);
+  BF_Close();
+}
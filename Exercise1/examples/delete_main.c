@@ -0,0 +1,132 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "bf.h"
+#include "ht_table.h"
+#include "sht_table.h"
+#include <assert.h>
+
+#define RECORDS_NUM 5000 // you can change it if you want
+#define ROUNDS 5
+#define BUCKETS 50
+#define FILE_NAME "data.db"
+#define INDEX_NAME "index.db"
+#define RID_INDEX_NAME "rid_index.db"
+
+#define CALL_OR_DIE(call)     \
+  {                           \
+    BF_ErrorCode code = call; \
+    if (code != BF_OK) {      \
+      BF_PrintError(code);    \
+      exit(code);             \
+    }                         \
+  }
+
+// The files whose secondary indexes follow the primary file, one of blocks and one of rids
+typedef struct {
+  HT_info* info;
+  SHT_info* index;
+  SHT_info* ridIndex;
+} Files;
+
+static void unindex(int key, Record* record, int rid, void* context) {
+  Files* files = context;
+  int error = SHT_SecondaryDeleteEntry(files->info, files->index, *record, HT_RID_BLOCK(rid));
+  assert(error == 0);
+  error = SHT_SecondaryDeleteEntry(files->info, files->ridIndex, *record, rid);
+  assert(error == 0);
+}
+
+// A record that moved, even to another slot of the same block, is reported with its old and new rid
+static void reindex(Record* old, int oldRid, Record* updated, int newRid, void* context) {
+  Files* files = context;
+  int error = SHT_SecondaryDeleteEntry(files->info, files->index, *old, HT_RID_BLOCK(oldRid));
+  assert(error == 0);
+  error = SHT_SecondaryInsertEntry(files->index, *updated, HT_RID_BLOCK(newRid));
+  assert(error == 0);
+  error = SHT_SecondaryDeleteEntry(files->info, files->ridIndex, *old, oldRid);
+  assert(error == 0);
+  error = SHT_SecondaryInsertEntry(files->ridIndex, *updated, newRid);
+  assert(error == 0);
+}
+
+static void insert(Files* files, Record record) {
+  int rid;
+  int block_id = HT_InsertEntryWithRid(files->info, record, &rid);
+  assert(block_id == HT_RID_BLOCK(rid));
+  int error = SHT_SecondaryInsertEntry(files->index, record, block_id);
+  assert(error == 0);
+  error = SHT_SecondaryInsertEntry(files->ridIndex, record, rid);
+  assert(error == 0);
+}
+
+int main() {
+  BF_Init(LRU);
+
+  int error = HT_CreateFile(FILE_NAME, BUCKETS);
+  assert(error == 0);
+  error = SHT_CreateSecondaryIndex(INDEX_NAME, BUCKETS, FILE_NAME);
+  assert(error == 0);
+  SHT_options options = { 0 };
+  options.rids = true;
+  error = SHT_CreateSecondaryIndexWithOptions(RID_INDEX_NAME, BUCKETS, FILE_NAME, options);
+  assert(error == 0);
+  Files files;
+  files.info = HT_OpenFile(FILE_NAME);
+  files.index = SHT_OpenSecondaryIndex(INDEX_NAME);
+  files.ridIndex = SHT_OpenSecondaryIndex(RID_INDEX_NAME);
+
+  Record* records = malloc(sizeof(Record) * RECORDS_NUM);
+  srand(12569874);
+  for (int i = 0; i < RECORDS_NUM; i++) {
+    records[i] = randomRecord();
+    insert(&files, records[i]);
+  }
+
+  int blocks;
+  CALL_OR_DIE(BF_GetBlockCounter(files.info->fileDesc, &blocks));
+  printf("Blocks after the inserts: %d\n", blocks);
+
+  // Every round deletes half of the records, updates a quarter and inserts the deleted ones again
+  for (int round = 0; round < ROUNDS; round++) {
+    for (int id = round % 2; id < RECORDS_NUM; id += 2) {
+      int deleted = HT_DeleteEntry(files.info, id, unindex, reindex, &files);
+      assert(deleted == 1);
+    }
+
+    for (int id = 1 - round % 2; id < RECORDS_NUM; id += 4) {
+      Record record = randomRecord();
+      record.id = id;
+      int updated = HT_UpdateEntry(files.info, id, record, reindex, &files);
+      assert(updated == 1);
+      records[id] = record;
+    }
+
+    for (int id = round % 2; id < RECORDS_NUM; id += 2)
+      insert(&files, records[id]);
+
+    CALL_OR_DIE(BF_GetBlockCounter(files.info->fileDesc, &blocks));
+    printf("Blocks after round %d: %d\n", round + 1, blocks);
+  }
+
+  // The primary file holds the latest version of every record
+  for (int id = 0; id < RECORDS_NUM; id++) {
+    Record record;
+    int blocksRead = HT_GetEntry(files.info, id, &record);
+    assert(blocksRead > 0);
+    assert(strcmp(record.name, records[id].name) == 0 && strcmp(record.city, records[id].city) == 0);
+  }
+
+  // Both indexes lead to the same primary blocks, the rids straight to the records
+  printf("RUN SecondaryGetAllEntries: %s\n", records[0].name);
+  int blocksRead = SHT_SecondaryGetAllEntries(files.info, files.index, records[0].name);
+  printf("RUN SecondaryGetAllEntries with rids: %s\n", records[0].name);
+  int ridBlocksRead = SHT_SecondaryGetAllEntries(files.info, files.ridIndex, records[0].name);
+  assert(ridBlocksRead == blocksRead);
+
+  SHT_CloseSecondaryIndex(files.index);
+  SHT_CloseSecondaryIndex(files.ridIndex);
+  HT_CloseFile(files.info);
+  free(records);
+  BF_Close();
+}
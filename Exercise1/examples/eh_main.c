@@ -0,0 +1,61 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "bf.h"
+#include "eh_table.h"
+#include <assert.h>
+
+#define RECORDS_NUM 100000 // you can change it if you want
+#define LOOKUPS 1000
+#define FILE_NAME "data.db"
+
+#define CALL_OR_DIE(call)     \
+  {                           \
+    BF_ErrorCode code = call; \
+    if (code != BF_OK) {      \
+      BF_PrintError(code);    \
+      exit(code);             \
+    }                         \
+  }
+
+int main() {
+  BF_Init(LRU);
+
+  EH_CreateFile(FILE_NAME, 1);
+
+  EH_info* info = EH_OpenFile(FILE_NAME);
+  assert(info != NULL);
+
+  srand(12569874);
+  printf("Insert Entries\n");
+
+  // Every time the file grows 10x, check how many blocks a lookup reads
+  int checkpoint = 1000;
+  for (int id = 0; id < RECORDS_NUM; ++id) {
+    Record record = randomRecord();
+    int block = EH_InsertEntry(info, record);
+    assert(block != -1);
+
+    if (id + 1 == checkpoint) {
+      int blocksRead = 0;
+      for (int i = 0; i < LOOKUPS; i++) {
+        int key = rand() % (id + 1);
+        blocksRead += EH_GetAllEntries(info, &key);
+      }
+      printf("Records: %d \t global depth: %d \t buckets: %d \t blocks read per lookup: %.2f\n",
+        id + 1, info->globalDepth, info->buckets, (double) blocksRead / LOOKUPS);
+      checkpoint *= 10;
+    }
+  }
+
+  printf("RUN PrintAllEntries\n");
+  int id = rand() % RECORDS_NUM;
+  EH_GetAllEntries(info, &id);
+
+  EH_CloseFile(info);
+
+  HashStatisticsEH(FILE_NAME);
+
+  BF_Close();
+}
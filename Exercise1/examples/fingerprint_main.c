@@ -0,0 +1,87 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "bf.h"
+#include "ht_table.h"
+#include "sht_table.h"
+#include <assert.h>
+
+#define RECORDS_NUM 5000 // you can change it if you want
+#define BUCKETS 10
+#define LOOKUPS 2000
+#define FILE_NAME "data.db"
+#define INDEX_NAME "index.db"
+
+#define CALL_OR_DIE(call)     \
+  {                           \
+    BF_ErrorCode code = call; \
+    if (code != BF_OK) {      \
+      BF_PrintError(code);    \
+      exit(code);             \
+    }                         \
+  }
+
+static long elapsed(struct timespec start, struct timespec end) {
+  return (end.tv_sec - start.tv_sec) * 1000000000L + (end.tv_nsec - start.tv_nsec);
+}
+
+int main() {
+  BF_Init(LRU);
+
+  // The same records in encoded blocks, once without and once with fingerprints
+  for (int fingerprints = 0; fingerprints <= 1; fingerprints++) {
+    HT_options options = { 0 };
+    options.format = ENCODED_FORMAT;
+    options.fingerprints = fingerprints;
+    SHT_options indexOptions = { 0 };
+    indexOptions.fingerprints = fingerprints;
+
+    remove(FILE_NAME);
+    remove(INDEX_NAME);
+    int error = HT_CreateFileWithOptions(FILE_NAME, BUCKETS, options);
+    assert(error == 0);
+    error = SHT_CreateSecondaryIndexWithOptions(INDEX_NAME, BUCKETS, FILE_NAME, indexOptions);
+    assert(error == 0);
+    HT_info* info = HT_OpenFile(FILE_NAME);
+    SHT_info* index_info = SHT_OpenSecondaryIndex(INDEX_NAME);
+    assert(info != NULL && index_info != NULL);
+
+    srand(12569874);
+    for (int id = 0; id < RECORDS_NUM; ++id) {
+      Record record = randomRecord();
+      record.id = id;
+      int block_id = HT_InsertEntry(info, record);
+      assert(block_id != -1);
+      SHT_SecondaryInsertEntry(index_info, record, block_id);
+    }
+
+    // Missing keys probe every block of their chain and print nothing
+    int blocksRead = 0;
+    struct timespec start, end;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (int i = 0; i < LOOKUPS; i++) {
+      int id = RECORDS_NUM + i;
+      blocksRead += HT_GetAllEntries(info, &id);
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    printf("Fingerprints %d: %d records per block, %.1f ns per block probed for a missing id\n",
+      fingerprints, info->recordsPerBlock, (double) elapsed(start, end) / blocksRead);
+
+    char name[15];
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (int i = 0; i < LOOKUPS; i++) {
+      sprintf(name, "Nobody%d", i);
+      int blocks = SHT_SecondaryGetAllEntries(info, index_info, name);
+      assert(blocks == 0);
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    printf("Fingerprints %d: %d entries per block, %ld ns per missing name\n",
+      fingerprints, index_info->recordsPerBlock, elapsed(start, end) / LOOKUPS);
+
+    SHT_CloseSecondaryIndex(index_info);
+    HT_CloseFile(info);
+  }
+
+  BF_Close();
+}
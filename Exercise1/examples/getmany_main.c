@@ -0,0 +1,79 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "bf.h"
+#include "ht_table.h"
+#include <assert.h>
+
+#define RECORDS_NUM 20000 // you can change it if you want
+#define BUCKETS 100
+#define BATCH 500
+#define BATCHES 20
+#define FILE_NAME "data.db"
+
+#define CALL_OR_DIE(call)     \
+  {                           \
+    BF_ErrorCode code = call; \
+    if (code != BF_OK) {      \
+      BF_PrintError(code);    \
+      exit(code);             \
+    }                         \
+  }
+
+static long elapsed(struct timespec start, struct timespec end) {
+  return (end.tv_sec - start.tv_sec) * 1000000000L + (end.tv_nsec - start.tv_nsec);
+}
+
+// Counts the records delivered by HT_GetMany
+static void countRecord(int key, Record* record, int rid, void* context) {
+  assert(record->id == key);
+  (*(int*) context)++;
+}
+
+int main() {
+  BF_Init(LRU);
+
+  HT_options options = { 0 };
+  options.unique = true;
+  int error = HT_CreateFileWithOptions(FILE_NAME, BUCKETS, options);
+  assert(error == 0);
+
+  HT_info* info = HT_OpenFile(FILE_NAME);
+  assert(info != NULL);
+
+  srand(12569874);
+  for (int id = 0; id < RECORDS_NUM; ++id) {
+    int block = HT_InsertEntry(info, randomRecord());
+    assert(block != -1);
+  }
+
+  int keys[BATCH];
+  long oneByOne = 0, batched = 0;
+  int blocksOneByOne = 0, blocksBatched = 0;
+
+  for (int b = 0; b < BATCHES; b++) {
+    for (int i = 0; i < BATCH; i++)
+      keys[i] = rand() % RECORDS_NUM;
+
+    struct timespec start, end;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (int i = 0; i < BATCH; i++)
+      blocksOneByOne += HT_GetAllEntries(info, &keys[i]);
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    oneByOne += elapsed(start, end);
+
+    int found = 0;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    blocksBatched += HT_GetMany(info, keys, BATCH, countRecord, &found);
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    batched += elapsed(start, end);
+    assert(found == BATCH);
+  }
+
+  printf("HT_GetAllEntries per key: %ld us per batch of %d, %d blocks read\n", oneByOne / BATCHES / 1000, BATCH, blocksOneByOne / BATCHES);
+  printf("HT_GetMany:               %ld us per batch of %d, %d blocks read\n", batched / BATCHES / 1000, BATCH, blocksBatched / BATCHES);
+
+  HT_CloseFile(info);
+  BF_Close();
+}
@@ -0,0 +1,117 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <math.h>
+#include "bf.h"
+#include "ht_table.h"
+#include "hash_function.h"
+#include <assert.h>
+
+#define RECORDS_NUM 10000 // you can change it if you want
+#define BUCKETS 1024
+#define ID_STRIDE 64      // Clustered ids, every 64th value
+#define STRING_KEYS 100000
+#define HASH_CALLS 10000000
+#define LOOKUPS 1000
+#define FILE_NAME "data.db"
+
+#define CALL_OR_DIE(call)     \
+  {                           \
+    BF_ErrorCode code = call; \
+    if (code != BF_OK) {      \
+      BF_PrintError(code);    \
+      exit(code);             \
+    }                         \
+  }
+
+static long elapsed(struct timespec start, struct timespec end) {
+  return (end.tv_sec - start.tv_sec) * 1000000000L + (end.tv_nsec - start.tv_nsec);
+}
+
+// Prints how evenly keys fell into the buckets: the fullest bucket against the mean, empty buckets, stddev
+static void printSkew(const char* label, int* counts, int buckets, int keys) {
+  int max = 0, empty = 0;
+  double mean = (double) keys / buckets, variance = 0;
+  for (int i = 0; i < buckets; i++) {
+    if (counts[i] > max) max = counts[i];
+    if (counts[i] == 0) empty++;
+    variance += (counts[i] - mean) * (counts[i] - mean);
+  }
+  printf("  %-8s max/mean %6.2f \t empty %5d \t stddev %7.2f", label, max / mean, empty, sqrt(variance / buckets));
+}
+
+int main() {
+  BF_Init(LRU);
+
+  int* counts = malloc(sizeof(int) * BUCKETS);
+  char key[16];
+
+  for (Hash_Function f = DEFAULT_HASH; f < HASH_FUNCTIONS; f++) {
+    printf("%s\n", HF_Name(f));
+
+    // Bucket skew of clustered ids and of short strings, for a power of two and for a prime number of buckets
+    int bucketCounts[2] = { BUCKETS, 1021 };
+    for (int b = 0; b < 2; b++) {
+      memset(counts, 0, sizeof(int) * BUCKETS);
+      for (int i = 0; i < RECORDS_NUM; i++)
+        counts[HF_Reduce(f, HF_HashInt(f, i * ID_STRIDE), bucketCounts[b])]++;
+      printSkew("ids", counts, bucketCounts[b], RECORDS_NUM);
+
+      memset(counts, 0, sizeof(int) * BUCKETS);
+      for (int i = 0; i < STRING_KEYS; i++) {
+        sprintf(key, "name%d", i);
+        counts[HF_Reduce(f, HF_HashString(f, key), bucketCounts[b])]++;
+      }
+      printSkew("strings", counts, bucketCounts[b], STRING_KEYS);
+      printf("\t (%d buckets)\n", bucketCounts[b]);
+    }
+
+    // Cost of the hash function alone
+    struct timespec start, end;
+    unsigned int sink = 0;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (int i = 0; i < HASH_CALLS; i++)
+      sink += HF_Reduce(f, HF_HashInt(f, i), BUCKETS);
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    printf("  %.2f ns per id hash", (double) elapsed(start, end) / HASH_CALLS);
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (int i = 0; i < HASH_CALLS; i++)
+      sink += HF_Reduce(f, HF_HashString(f, "Konstantina"), BUCKETS) + i;
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    printf(" \t %.2f ns per string hash (%u)\n", (double) elapsed(start, end) / HASH_CALLS, sink & 1);
+
+    // Lookup cost on a hash file with clustered ids
+    HT_options options = { 0 };
+    options.hash = f;
+    remove(FILE_NAME);
+    int error = HT_CreateFileWithOptions(FILE_NAME, BUCKETS, options);
+    assert(error == 0);
+    HT_info* info = HT_OpenFile(FILE_NAME);
+    assert(info != NULL);
+
+    srand(12569874);
+    for (int i = 0; i < RECORDS_NUM; i++) {
+      Record record = randomRecord();
+      record.id = i * ID_STRIDE;
+      int block = HT_InsertEntry(info, record);
+      assert(block != -1);
+    }
+
+    int blocksRead = 0;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (int i = 0; i < LOOKUPS; i++) {
+      int id = (rand() % RECORDS_NUM) * ID_STRIDE;
+      blocksRead += HT_GetAllEntries(info, &id);
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    printf("  Blocks read per lookup: %.2f \t %.0f ns per lookup\n",
+      (double) blocksRead / LOOKUPS, (double) elapsed(start, end) / LOOKUPS);
+
+    HT_CloseFile(info);
+  }
+
+  free(counts);
+  BF_Close();
+}
@@ -0,0 +1,98 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "bf.h"
+#include "ht_table.h"
+#include "sht_table.h"
+#include <assert.h>
+
+#define RECORDS_NUM 200000 // you can change it if you want
+#define BUCKETS 1000
+#define INDEX_BUCKETS 64
+#define NAMES 12
+#define FILE_NAME "build_data.db"
+#define INSERT_INDEX_NAME "build_insert.db"
+#define BUILD_INDEX_NAME "build_index.db"
+
+#define CALL_OR_DIE(call)     \
+  {                           \
+    BF_ErrorCode code = call; \
+    if (code != BF_OK) {      \
+      BF_PrintError(code);    \
+      exit(code);             \
+    }                         \
+  }
+
+static long elapsed(struct timespec start, struct timespec end) {
+  return (end.tv_sec - start.tv_sec) * 1000000000L + (end.tv_nsec - start.tv_nsec);
+}
+
+// The index of the insert path gets one entry per record, the way an application adds it next to HT_InsertEntry
+static void indexRecord(int key, Record* record, int rid, void* context) {
+  int error = SHT_SecondaryInsertEntry(context, *record, HT_RID_BLOCK(rid));
+  assert(error == 0);
+}
+
+// Lookups print every record, so the results go to stderr: ./build/index_build_main > /dev/null
+int main() {
+  BF_Init(LRU);
+
+  Record* records = malloc(sizeof(Record) * RECORDS_NUM);
+  srand(12569874);
+  for (int i = 0; i < RECORDS_NUM; i++)
+    records[i] = randomRecord();
+
+  // The primary file exists, with all of its records, before any index
+  int error = HT_CreateFile(FILE_NAME, BUCKETS);
+  assert(error == 0);
+  HT_info* info = HT_OpenFile(FILE_NAME);
+  error = HT_BulkLoad(info, records, RECORDS_NUM);
+  assert(error == 0);
+  error = HT_CloseFile(info);
+  assert(error == 0);
+
+  struct timespec start, end;
+
+  // One entry at a time, from a scan of the file
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  error = SHT_CreateSecondaryIndex(INSERT_INDEX_NAME, INDEX_BUCKETS, NULL);
+  assert(error == 0);
+  info = HT_OpenFile(FILE_NAME);
+  SHT_info* inserted = SHT_OpenSecondaryIndex(INSERT_INDEX_NAME);
+  int blocksRead = HT_ScanEntries(info, indexRecord, inserted);
+  assert(blocksRead != -1);
+  clock_gettime(CLOCK_MONOTONIC, &end);
+  long insertTime = elapsed(start, end);
+
+  // Built from the file by SHT_CreateSecondaryIndex
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  error = SHT_CreateSecondaryIndex(BUILD_INDEX_NAME, INDEX_BUCKETS, FILE_NAME);
+  assert(error == 0);
+  clock_gettime(CLOCK_MONOTONIC, &end);
+  long buildTime = elapsed(start, end);
+  SHT_info* built = SHT_OpenSecondaryIndex(BUILD_INDEX_NAME);
+
+  // Both indexes lead to the same primary blocks for every name
+  for (int i = 0; i < NAMES; i++) {
+    char* name = records[i].name;
+    int builtBlocks = SHT_SecondaryGetAllEntries(info, built, name);
+    int insertedBlocks = SHT_SecondaryGetAllEntries(info, inserted, name);
+    assert(builtBlocks == insertedBlocks);
+  }
+
+  int insertBlocks, buildBlocks;
+  CALL_OR_DIE(BF_GetBlockCounter(inserted->fileDesc, &insertBlocks));
+  CALL_OR_DIE(BF_GetBlockCounter(built->fileDesc, &buildBlocks));
+  fprintf(stderr, "SHT_SecondaryInsertEntry: %ld ms, %d index blocks\n", insertTime / 1000000, insertBlocks);
+  fprintf(stderr, "SHT_CreateSecondaryIndex: %ld ms, %d index blocks\n", buildTime / 1000000, buildBlocks);
+
+  error = SHT_CloseSecondaryIndex(inserted);
+  assert(error == 0);
+  error = SHT_CloseSecondaryIndex(built);
+  assert(error == 0);
+  error = HT_CloseFile(info);
+  assert(error == 0);
+  free(records);
+  BF_Close();
+}
@@ -0,0 +1,71 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "bf.h"
+#include "ht_table.h"
+#include <assert.h>
+
+#define RECORDS_NUM 20000 // you can change it if you want
+#define BUCKETS 256
+#define LOOKUPS 10000
+#define FILE_NAME "key.db"
+
+#define CALL_OR_DIE(call)     \
+  {                           \
+    BF_ErrorCode code = call; \
+    if (code != BF_OK) {      \
+      BF_PrintError(code);    \
+      exit(code);             \
+    }                         \
+  }
+
+static long elapsed(struct timespec start, struct timespec end) {
+  return (end.tv_sec - start.tv_sec) * 1000000000L + (end.tv_nsec - start.tv_nsec);
+}
+
+int main() {
+  BF_Init(LRU);
+
+  Record* records = malloc(sizeof(Record) * RECORDS_NUM);
+  srand(12569874);
+  for (int i = 0; i < RECORDS_NUM; i++)
+    records[i] = randomRecord();
+
+  // A composite key: every (name, surname) pair is a bucket key
+  HT_options options = { 0 };
+  options.key = RECORD_KEY(NAME) | RECORD_KEY(SURNAME);
+  options.hash = MURMUR_HASH;
+  options.fingerprints = true;
+  int error = HT_CreateFileWithOptions(FILE_NAME, BUCKETS, options);
+  assert(error == 0);
+  HT_info* info = HT_OpenFile(FILE_NAME);
+  error = HT_BulkLoad(info, records, RECORDS_NUM);
+  assert(error == 0);
+
+  // Only the key attributes of the probe are read
+  Record key;
+  strcpy(key.name, records[0].name);
+  strcpy(key.surname, records[0].surname);
+  printf("RUN GetAllEntriesByKey: ");
+  RK_Print(info->key, &key);
+  printf("\n");
+  int blocks = HT_GetAllEntriesByKey(info, &key);
+  printf("Blocks read: %d\n", blocks);
+
+  struct timespec start, end;
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  for (int i = 0; i < LOOKUPS; i++) {
+    Record found;
+    Record* probe = &records[rand() % RECORDS_NUM];
+    int blocksRead = HT_GetEntryByKey(info, probe, &found);
+    assert(blocksRead > 0);
+    assert(strcmp(found.name, probe->name) == 0 && strcmp(found.surname, probe->surname) == 0);
+  }
+  clock_gettime(CLOCK_MONOTONIC, &end);
+  printf("HT_GetEntryByKey: %ld ns per lookup\n", elapsed(start, end) / LOOKUPS);
+
+  HT_CloseFile(info);
+  free(records);
+  BF_Close();
+}
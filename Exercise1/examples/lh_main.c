@@ -0,0 +1,79 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "bf.h"
+#include "lh_table.h"
+#include <assert.h>
+
+#define RECORDS_NUM 100000 // you can change it if you want
+#define INITIAL_BUCKETS 4
+#define MAX_LOAD 80
+#define LOOKUPS 1000
+#define FILE_NAME "data.db"
+
+#define CALL_OR_DIE(call)     \
+  {                           \
+    BF_ErrorCode code = call; \
+    if (code != BF_OK) {      \
+      BF_PrintError(code);    \
+      exit(code);             \
+    }                         \
+  }
+
+static int compareLatencies(const void* a, const void* b) {
+  long x = *(const long*) a, y = *(const long*) b;
+  return (x > y) - (x < y);
+}
+
+static long percentile(long* sorted, int n, double p) {
+  int i = (int) (p / 100.0 * (n - 1));
+  return sorted[i];
+}
+
+int main() {
+  BF_Init(LRU);
+
+  LH_CreateFile(FILE_NAME, INITIAL_BUCKETS, MAX_LOAD);
+
+  LH_info* info = LH_OpenFile(FILE_NAME);
+  assert(info != NULL);
+
+  long* latencies = malloc(sizeof(long) * RECORDS_NUM);
+
+  srand(12569874);
+  printf("Insert Entries\n");
+  for (int id = 0; id < RECORDS_NUM; ++id) {
+    Record record = randomRecord();
+
+    struct timespec start, end;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    int block = LH_InsertEntry(info, record);
+    assert(block != -1);
+    clock_gettime(CLOCK_MONOTONIC, &end);
+
+    latencies[id] = (end.tv_sec - start.tv_sec) * 1000000000L + (end.tv_nsec - start.tv_nsec);
+  }
+
+  printf("Buckets grew from %d to %d (%dx)\n", INITIAL_BUCKETS, info->numBuckets, info->numBuckets / INITIAL_BUCKETS);
+
+  qsort(latencies, RECORDS_NUM, sizeof(long), compareLatencies);
+  printf("Insert latency (ns): p50 %ld \t p90 %ld \t p99 %ld \t p99.9 %ld \t max %ld\n",
+    percentile(latencies, RECORDS_NUM, 50), percentile(latencies, RECORDS_NUM, 90),
+    percentile(latencies, RECORDS_NUM, 99), percentile(latencies, RECORDS_NUM, 99.9),
+    latencies[RECORDS_NUM - 1]);
+  free(latencies);
+
+  int blocksRead = 0;
+  for (int i = 0; i < LOOKUPS; i++) {
+    int key = rand() % RECORDS_NUM;
+    blocksRead += LH_GetAllEntries(info, &key);
+  }
+  printf("Blocks read per lookup: %.2f\n", (double) blocksRead / LOOKUPS);
+
+  LH_CloseFile(info);
+
+  HashStatisticsLH(FILE_NAME);
+
+  BF_Close();
+}
@@ -0,0 +1,128 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "bf.h"
+#include "lsm_tree.h"
+#include <assert.h>
+
+#define RECORDS_NUM 200000 // you can change it if you want
+#define UPDATES 20000
+#define DELETES 20000
+#define LOOKUPS 10000
+#define FILE_NAME "lsm.db"
+
+#define CALL_OR_DIE(call)     \
+  {                           \
+    BF_ErrorCode code = call; \
+    if (code != BF_OK) {      \
+      BF_PrintError(code);    \
+      exit(code);             \
+    }                         \
+  }
+
+static long elapsed(struct timespec start, struct timespec end) {
+  return (end.tv_sec - start.tv_sec) * 1000000L + (end.tv_nsec - start.tv_nsec) / 1000;
+}
+
+// Every id is looked up and must match the last write to it, live is NULL where the id was deleted
+static void check(LSM_info* info, Record** live) {
+  for (int id = 0; id < RECORDS_NUM; id++) {
+    Record record;
+    int found = LSM_GetEntry(info, id, &record);
+    assert(found == (live[id] != NULL));
+    if (found) assert(strcmp(record.city, live[id]->city) == 0 && strcmp(record.name, live[id]->name) == 0);
+  }
+}
+
+// Blocks a lookup reads on average, for ids that exist and for ids that never did
+static void lookups(LSM_info* info) {
+  long int hits = 0, misses = 0;
+  for (int i = 0; i < LOOKUPS; i++) {
+    int id = rand() % RECORDS_NUM;
+    int absent = RECORDS_NUM + id;
+    hits += LSM_GetAllEntries(info, &id);
+    misses += LSM_GetAllEntries(info, &absent);
+  }
+  fprintf(stderr, "Lookups read %.2f blocks for an id, %.3f for an id that is not there (%d runs)\n",
+    (double) hits / LOOKUPS, (double) misses / LOOKUPS, info->runCount);
+}
+
+// Lookups print the records they find, so the results go to stderr: ./build/lsm_main > /dev/null
+int main() {
+  BF_Init(LRU);
+
+  // The ids come out in order and are written in random order
+  Record* records = malloc(sizeof(Record) * RECORDS_NUM);
+  Record* updates = malloc(sizeof(Record) * UPDATES);
+  Record** live = malloc(sizeof(Record*) * RECORDS_NUM);
+  srand(12569874);
+  for (int i = 0; i < RECORDS_NUM; i++)
+    records[i] = randomRecord();
+  for (int i = RECORDS_NUM - 1; i > 0; i--) {
+    int j = rand() % (i + 1);
+    Record swap = records[i]; records[i] = records[j]; records[j] = swap;
+  }
+  for (int i = 0; i < RECORDS_NUM; i++)
+    live[records[i].id] = &records[i];
+
+  LSM_options options = { 0 };
+  int error = LSM_CreateFile(FILE_NAME, options);
+  assert(error == 0);
+  LSM_info* info = LSM_OpenFile(FILE_NAME);
+  assert(info != NULL);
+
+  struct timespec start, end;
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  for (int i = 0; i < RECORDS_NUM; i++) {
+    error = LSM_InsertEntry(info, records[i]);
+    assert(error == 0);
+  }
+
+  // Some records change city, some go away
+  for (int i = 0; i < UPDATES; i++) {
+    int id = rand() % RECORDS_NUM;
+    updates[i] = randomRecord();
+    updates[i].id = id;
+    live[id] = &updates[i];
+    error = LSM_InsertEntry(info, updates[i]);
+    assert(error == 0);
+  }
+  for (int i = 0; i < DELETES; i++) {
+    int id = rand() % RECORDS_NUM;
+    live[id] = NULL;
+    error = LSM_DeleteEntry(info, id);
+    assert(error == 0);
+  }
+  error = LSM_Flush(info);
+  assert(error == 0);
+  clock_gettime(CLOCK_MONOTONIC, &end);
+
+  long micros = elapsed(start, end);
+  long writes = RECORDS_NUM + UPDATES + DELETES;
+  double megabytes = (double) info->blocksWritten * BF_BLOCK_SIZE / (1024 * 1024);
+  fprintf(stderr, "%ld writes in %ld us: %ld writes/s, %.1f MB/s of run blocks\n",
+    writes, micros, writes * 1000000L / (micros + 1), megabytes * 1000000 / (micros + 1));
+  fprintf(stderr, "%ld flushes, %ld compactions, write amplification %.2f\n", info->flushes, info->compactions,
+    (double) info->blocksWritten * BF_BLOCK_SIZE / (writes * sizeof(Record)));
+
+  check(info, live);
+  lookups(info);
+  error = LSM_CloseFile(info);
+  assert(error == 0);
+
+  // The runs and the manifest are all that a reopened file has
+  info = LSM_OpenFile(FILE_NAME);
+  assert(info != NULL);
+  check(info, live);
+  fprintf(stderr, "Every id matches its last write, before and after reopening\n");
+  error = LSM_CloseFile(info);
+  assert(error == 0);
+
+  StatisticsLSM(FILE_NAME);
+
+  free(records);
+  free(updates);
+  free(live);
+  BF_Close();
+}
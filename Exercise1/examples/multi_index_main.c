@@ -0,0 +1,174 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "bf.h"
+#include "ht_table.h"
+#include "sht_table.h"
+#include <assert.h>
+
+#define RECORDS_NUM 100000 // you can change it if you want
+#define BATCH 1000
+#define UPDATES 2000
+#define DELETES 2000
+#define BUCKETS 500
+#define INDEX_BUCKETS 64
+#define FILE_NAME "multi_data.db"
+#define NAME_INDEX "multi_name.db"
+#define SURNAME_INDEX "multi_surname.db"
+#define CITY_INDEX "multi_city.db"
+#define CHECK_INDEX "multi_check.db"
+#define MANUAL_FILE_NAME "manual_data.db"
+#define MANUAL_NAME_INDEX "manual_name.db"
+#define MANUAL_SURNAME_INDEX "manual_surname.db"
+#define MANUAL_CITY_INDEX "manual_city.db"
+
+static long elapsed(struct timespec start, struct timespec end) {
+  return (end.tv_sec - start.tv_sec) * 1000000000L + (end.tv_nsec - start.tv_nsec);
+}
+
+// A primary file with an index of blocks on the name and indexes of rids on the surname and the city,
+// the one on the city covering the id
+static void create(char* fileName, char* nameIndex, char* surnameIndex, char* cityIndex) {
+  int error = HT_CreateFile(fileName, BUCKETS);
+  assert(error == 0);
+  SHT_options options = { 0 };
+  error = SHT_CreateSecondaryIndexWithOptions(nameIndex, INDEX_BUCKETS, fileName, options);
+  assert(error == 0);
+  options.key = RECORD_KEY(SURNAME);
+  options.rids = true;
+  error = SHT_CreateSecondaryIndexWithOptions(surnameIndex, INDEX_BUCKETS, fileName, options);
+  assert(error == 0);
+  options.key = RECORD_KEY(CITY);
+  options.include = RECORD_KEY(ID);
+  error = SHT_CreateSecondaryIndexWithOptions(cityIndex, INDEX_BUCKETS, fileName, options);
+  assert(error == 0);
+}
+
+static void countRecord(Record* record, int rid, void* context) {
+  (*(int*) context)++;
+}
+
+// Every surname and city of the live records is counted from its index without the primary file
+static void check(SHT_files* files, Record** live) {
+  SHT_info* surnames = files->indexes[1];
+  SHT_info* cities = files->indexes[2];
+  for (int id = 0; id < 50; id++) {
+    Record* record = live[id];
+    if (record == NULL) continue;
+
+    int expectSurname = 0, expectCity = 0;
+    for (int other = 0; other < RECORDS_NUM; other++) {
+      if (live[other] == NULL) continue;
+      if (strcmp(live[other]->surname, record->surname) == 0) expectSurname++;
+      if (strcmp(live[other]->city, record->city) == 0) expectCity++;
+    }
+
+    int foundSurname = 0, foundCity = 0;
+    int blocksRead = SHT_SecondaryGetCovered(surnames, record->surname, RECORD_KEY(SURNAME), countRecord, &foundSurname);
+    assert(blocksRead != -1);
+    blocksRead = SHT_SecondaryGetCovered(cities, record->city, RECORD_KEY(ID) | RECORD_KEY(CITY), countRecord, &foundCity);
+    assert(blocksRead != -1);
+    assert(foundSurname == expectSurname && foundCity == expectCity);
+  }
+}
+
+// Lookups print every record, so the results go to stderr: ./build/multi_index_main > /dev/null
+int main() {
+  BF_Init(LRU);
+
+  Record* records = malloc(sizeof(Record) * RECORDS_NUM);
+  Record* updates = malloc(sizeof(Record) * UPDATES);
+  Record** live = malloc(sizeof(Record*) * RECORDS_NUM);
+  srand(12569874);
+  for (int i = 0; i < RECORDS_NUM; i++) {
+    records[i] = randomRecord();
+    live[records[i].id] = &records[i];
+  }
+
+  // The indexes are registered in the primary header, SHT_OpenFiles finds all three
+  create(FILE_NAME, NAME_INDEX, SURNAME_INDEX, CITY_INDEX);
+  create(MANUAL_FILE_NAME, MANUAL_NAME_INDEX, MANUAL_SURNAME_INDEX, MANUAL_CITY_INDEX);
+  SHT_files* files = SHT_OpenFiles(FILE_NAME);
+  SHT_files* manual = SHT_OpenFiles(MANUAL_FILE_NAME);
+  assert(files != NULL && files->indexCount == 3);
+  assert(manual != NULL && manual->indexCount == 3);
+
+  struct timespec start, end;
+
+  // One call per batch of records, every index gets the batch grouped by bucket
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  for (int i = 0; i < RECORDS_NUM; i += BATCH) {
+    int error = SHT_InsertEntries(files, records + i, RECORDS_NUM - i < BATCH ? RECORDS_NUM - i : BATCH);
+    assert(error == 0);
+  }
+  clock_gettime(CLOCK_MONOTONIC, &end);
+  long batchTime = elapsed(start, end);
+
+  // The calls an application makes for every record without SHT_InsertEntries
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  for (int i = 0; i < RECORDS_NUM; i++) {
+    int rid;
+    int block = HT_InsertEntryWithRid(manual->info, records[i], &rid);
+    assert(block != -1);
+    int error = SHT_SecondaryInsertEntry(manual->indexes[0], records[i], HT_RID_BLOCK(rid));
+    assert(error == 0);
+    error = SHT_SecondaryInsertEntry(manual->indexes[1], records[i], rid);
+    assert(error == 0);
+    error = SHT_SecondaryInsertEntry(manual->indexes[2], records[i], rid);
+    assert(error == 0);
+  }
+  clock_gettime(CLOCK_MONOTONIC, &end);
+  long manualTime = elapsed(start, end);
+
+  fprintf(stderr, "Record at a time, 4 calls per record: %ld ms\n", manualTime / 1000000);
+  fprintf(stderr, "SHT_InsertEntries, %d records per call: %ld ms\n", BATCH, batchTime / 1000000);
+  check(files, live);
+  check(manual, live);
+
+  // Some records change surname and city, some go away, and every index follows
+  for (int i = 0; i < UPDATES; i++) {
+    int id = rand() % RECORDS_NUM;
+    updates[i] = randomRecord();
+    updates[i].id = id;
+    live[id] = &updates[i];
+    int updated = SHT_UpdateEntry(files, id, updates[i]);
+    assert(updated == 1);
+  }
+  for (int i = 0; i < DELETES; i++) {
+    int id = rand() % RECORDS_NUM;
+    int deleted = SHT_DeleteEntry(files, id);
+    assert(deleted == (live[id] != NULL));
+    live[id] = NULL;
+  }
+  int error = SHT_CloseFiles(files);
+  assert(error == 0);
+
+  // Reopened, the indexes agree with the live records, and the index of blocks with a fresh one
+  files = SHT_OpenFiles(FILE_NAME);
+  assert(files != NULL && files->indexCount == 3);
+  check(files, live);
+  SHT_options options = { 0 };
+  error = SHT_Reorganize(CHECK_INDEX, INDEX_BUCKETS, files->info, options);
+  assert(error == 0);
+  SHT_info* fresh = SHT_OpenSecondaryIndex(CHECK_INDEX);
+  for (int id = 0; id < 20; id++) {
+    if (live[id] == NULL) continue;
+    char* name = live[id]->name;
+    int indexBlocks = SHT_SecondaryGetAllEntries(files->info, files->indexes[0], name);
+    int freshBlocks = SHT_SecondaryGetAllEntries(files->info, fresh, name);
+    assert(indexBlocks == freshBlocks);
+  }
+  fprintf(stderr, "After %d updates and %d deletes, every index matches the primary file\n", UPDATES, DELETES);
+
+  error = SHT_CloseSecondaryIndex(fresh);
+  assert(error == 0);
+  error = SHT_CloseFiles(files);
+  assert(error == 0);
+  error = SHT_CloseFiles(manual);
+  assert(error == 0);
+  free(records);
+  free(updates);
+  free(live);
+  BF_Close();
+}
@@ -0,0 +1,119 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "bf.h"
+#include "ht_table.h"
+#include "sht_table.h"
+#include <assert.h>
+
+#define RECORDS_NUM 50000 // you can change it if you want
+#define BUCKETS 256
+#define INDEX_BUCKETS 16
+#define NAMES 12
+#define FILE_NAME "posting_data.db"
+#define PLAIN_INDEX_NAME "posting_plain.db"
+#define POSTING_INDEX_NAME "posting_lists.db"
+#define RID_INDEX_NAME "posting_rids.db"
+
+#define CALL_OR_DIE(call)     \
+  {                           \
+    BF_ErrorCode code = call; \
+    if (code != BF_OK) {      \
+      BF_PrintError(code);    \
+      exit(code);             \
+    }                         \
+  }
+
+static long elapsed(struct timespec start, struct timespec end) {
+  return (end.tv_sec - start.tv_sec) * 1000000L + (end.tv_nsec - start.tv_nsec) / 1000;
+}
+
+// Looks every name up and reports the size of the index and the time the lookups took
+static void report(HT_info* info, SHT_info* index, const char* layout, const char** names, int* found) {
+  int blocks;
+  CALL_OR_DIE(BF_GetBlockCounter(index->fileDesc, &blocks));
+
+  struct timespec start, end;
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  for (int n = 0; n < NAMES && names[n] != NULL; n++) {
+    int blocksRead = SHT_SecondaryGetAllEntries(info, index, (char*) names[n]);
+    if (found[n] == -1) found[n] = blocksRead;
+    assert(blocksRead == found[n]);
+  }
+  clock_gettime(CLOCK_MONOTONIC, &end);
+  fprintf(stderr, "%-28s %6d index blocks (%7d bytes), lookups of every name in %ld us\n",
+    layout, blocks, blocks * BF_BLOCK_SIZE, elapsed(start, end));
+}
+
+// Lookups print every record, so the results go to stderr: ./build/posting_main > /dev/null
+int main() {
+  BF_Init(LRU);
+
+  int error = HT_CreateFile(FILE_NAME, BUCKETS);
+  assert(error == 0);
+  SHT_options options = { 0 };
+  error = SHT_CreateSecondaryIndexWithOptions(PLAIN_INDEX_NAME, INDEX_BUCKETS, FILE_NAME, options);
+  assert(error == 0);
+  options.rids = true;
+  error = SHT_CreateSecondaryIndexWithOptions(RID_INDEX_NAME, INDEX_BUCKETS, FILE_NAME, options);
+  assert(error == 0);
+  options.rids = false;
+  options.postings = true;
+  error = SHT_CreateSecondaryIndexWithOptions(POSTING_INDEX_NAME, INDEX_BUCKETS, FILE_NAME, options);
+  assert(error == 0);
+
+  HT_info* info = HT_OpenFile(FILE_NAME);
+  SHT_info* plain = SHT_OpenSecondaryIndex(PLAIN_INDEX_NAME);
+  SHT_info* postings = SHT_OpenSecondaryIndex(POSTING_INDEX_NAME);
+  SHT_info* rids = SHT_OpenSecondaryIndex(RID_INDEX_NAME);
+
+  // record.c has a handful of names, every name is in thousands of primary blocks
+  const char* names[NAMES] = { NULL };
+  char stored[NAMES][16];
+  srand(12569874);
+  for (int i = 0; i < RECORDS_NUM; i++) {
+    Record record = randomRecord();
+    int rid;
+    int block_id = HT_InsertEntryWithRid(info, record, &rid);
+    error = SHT_SecondaryInsertEntry(plain, record, block_id);
+    assert(error == 0);
+    error = SHT_SecondaryInsertEntry(postings, record, block_id);
+    assert(error == 0);
+    error = SHT_SecondaryInsertEntry(rids, record, rid);
+    assert(error == 0);
+
+    for (int n = 0; n < NAMES; n++) {
+      if (names[n] != NULL && strcmp(names[n], record.name) != 0) continue;
+      if (names[n] == NULL) names[n] = strcpy(stored[n], record.name);
+      break;
+    }
+  }
+
+  // Every layout must find the same primary blocks
+  int found[NAMES];
+  for (int n = 0; n < NAMES; n++) found[n] = -1;
+  report(info, plain, "One entry per <name, block>", names, found);
+  report(info, postings, "Posting lists", names, found);
+
+  // The same blocks are read, but only the slot of every match is decoded
+  report(info, rids, "One entry per <name, rid>", names, found);
+
+  // Rebuilt, the blocks of every name are sorted and the differences take a byte each
+  error = SHT_CloseSecondaryIndex(postings);
+  assert(error == 0);
+  error = SHT_Reorganize(POSTING_INDEX_NAME, INDEX_BUCKETS, info, options);
+  assert(error == 0);
+  postings = SHT_OpenSecondaryIndex(POSTING_INDEX_NAME);
+  report(info, postings, "Posting lists, reorganized", names, found);
+
+  error = SHT_CloseSecondaryIndex(plain);
+  assert(error == 0);
+  error = SHT_CloseSecondaryIndex(postings);
+  assert(error == 0);
+  error = SHT_CloseSecondaryIndex(rids);
+  assert(error == 0);
+  error = HT_CloseFile(info);
+  assert(error == 0);
+  BF_Close();
+}
@@ -0,0 +1,92 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "bf.h"
+#include "ht_table.h"
+#include "sht_table.h"
+#include <assert.h>
+
+#define RECORDS_NUM 20000 // you can change it if you want
+#define OLD_BUCKETS 10
+#define NEW_BUCKETS 512
+#define LOOKUPS 1000
+#define LOOKUP_SEED 42
+#define FILE_NAME "reorg.db"
+#define INDEX_NAME "reorg_index.db"
+
+#define CALL_OR_DIE(call)     \
+  {                           \
+    BF_ErrorCode code = call; \
+    if (code != BF_OK) {      \
+      BF_PrintError(code);    \
+      exit(code);             \
+    }                         \
+  }
+
+static void ignore(int key, Record* record, int rid, void* context) {}
+
+// Blocks read to find the same LOOKUPS random ids, one at a time
+static int lookups(HT_info* info) {
+  int blocks = 0;
+  srand(LOOKUP_SEED);
+  for (int i = 0; i < LOOKUPS; i++) {
+    int id = rand() % RECORDS_NUM;
+    Record record;
+    int blocksRead = HT_GetEntry(info, id, &record);
+    assert(blocksRead > 0 && record.id == id);
+    blocks += HT_GetMany(info, &id, 1, ignore, NULL);
+  }
+  return blocks;
+}
+
+int main() {
+  BF_Init(LRU);
+
+  // A file that has outgrown its buckets
+  int error = HT_CreateFile(FILE_NAME, OLD_BUCKETS);
+  assert(error == 0);
+  error = SHT_CreateSecondaryIndex(INDEX_NAME, OLD_BUCKETS, FILE_NAME);
+  assert(error == 0);
+  HT_info* info = HT_OpenFile(FILE_NAME);
+  SHT_info* index = SHT_OpenSecondaryIndex(INDEX_NAME);
+  srand(12569874);
+  for (int i = 0; i < RECORDS_NUM; i++) {
+    Record record = randomRecord();
+    int block_id = HT_InsertEntry(info, record);
+    assert(block_id != -1);
+    error = SHT_SecondaryInsertEntry(index, record, block_id);
+    assert(error == 0);
+  }
+  SHT_CloseSecondaryIndex(index);
+
+  int before = lookups(info);
+  int scanBefore = HT_ScanEntries(info, ignore, NULL);
+
+  // Rebuild with more buckets and a better hash function
+  HT_options options = { 0 };
+  options.hash = MURMUR_HASH;
+  error = HT_Reorganize(info, FILE_NAME, NEW_BUCKETS, options);
+  assert(error == 0);
+
+  // The handle opened before the swap still reads the old file
+  int during = lookups(info);
+  assert(during == before);
+  HT_CloseFile(info);
+
+  info = HT_OpenFile(FILE_NAME);
+  int after = lookups(info);
+  int scanAfter = HT_ScanEntries(info, ignore, NULL);
+
+  // The index follows the new block numbers
+  SHT_options indexOptions = { 0 };
+  indexOptions.hash = MURMUR_HASH;
+  error = SHT_Reorganize(INDEX_NAME, NEW_BUCKETS, info, indexOptions);
+  assert(error == 0);
+  HT_CloseFile(info);
+
+  printf("%d buckets, %s: %.2f blocks per lookup, %d blocks scanned\n", OLD_BUCKETS, HF_Name(DEFAULT_HASH), (double) before / LOOKUPS, scanBefore);
+  printf("%d buckets, %s: %.2f blocks per lookup, %d blocks scanned\n", NEW_BUCKETS, HF_Name(MURMUR_HASH), (double) after / LOOKUPS, scanAfter);
+
+  BF_Close();
+}
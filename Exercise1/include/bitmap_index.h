@@ -0,0 +1,107 @@
+#ifndef BITMAP_INDEX_H
+#define BITMAP_INDEX_H
+#include <record.h>
+#include <stdbool.h>
+
+/* Ευρετήριο bitmap για ένα πεδίο με λίγες διαφορετικές τιμές (name, surname ή
+city) ενός αρχείου κατακερματισμού. Για κάθε τιμή κρατιέται ένα bitmap με ένα bit
+για κάθε θέση εγγραφής του πρωτεύοντος αρχείου: η εγγραφή με RID <block, slot>
+έχει θέση (block << slotBits) | slot, ώστε οι θέσεις ενός block να είναι
+συνεχόμενες. Τα bitmaps συμπιέζονται όπως στα roaring bitmaps: οι θέσεις
+χωρίζονται σε τμήματα των 2^16 και κάθε τμήμα είναι ένας ταξινομημένος πίνακας
+από τα χαμηλά 16 bits των θέσεών του, αν έχει ως 4096, αλλιώς ένα πλήρες bitmap
+1024 λέξεων των 64 bits.
+
+	"Tokyo"	| key 0: bitmap, 1024 words	| key 1: array [3, 17, 40 ...]	| key 3: ...
+	"Paris"	| key 0: array [5, 9 ...]		| key 2: bitmap, 1024 words		|
+
+Οι τομές, οι ενώσεις και τα συμπληρώματα γίνονται τμήμα προς τμήμα, με πράξεις σε
+ολόκληρες λέξεις, και οι αναζητήσεις δεν διαβάζουν το πρωτεύον αρχείο. Όσο το
+ευρετήριο είναι ανοιχτό, τα bitmaps του βρίσκονται στη μνήμη, και όσα άλλαξαν
+γράφονται πίσω στο κλείσιμο, το καθένα στη δική του αλυσίδα blocks (block_chain.h). */
+
+// Bytes of a value, the longest of the indexable fields
+#define BM_VALUE_SIZE 20
+
+typedef struct BM_Bitmap BM_Bitmap;
+
+// A distinct value of the attribute and where its bitmap is stored, in the chain of valuesBlock
+typedef struct {
+    char value[BM_VALUE_SIZE];
+    int bitmapBlock;        // First block of the chain with the bitmap, -1 before it is first written
+} BM_value;
+
+typedef struct {
+    int fileDesc;
+    bool isHeapFile;
+    bool isHashFile;
+    bool isBitmapFile;
+    Record_Attribute attribute; // The indexed field, NAME, SURNAME or CITY
+    int slotBits;           // Bits of the slot in the position of a record, the block takes the rest
+    int valueCount;         // At most DICTIONARY_SIZE
+    int valuesBlock;        // First block of the chain with the BM_value of every value
+    BM_value* values;       // Valid only while the index is open
+    BM_Bitmap** bitmaps;    // The bitmap of every value, valid only while the index is open
+} BM_info;
+
+/*Η συνάρτηση BM_CreateIndex δημιουργεί ένα ευρετήριο bitmap με όνομα bfileName στο
+πεδίο attribute (NAME, SURNAME ή CITY) του αρχείου κατακερματισμού fileName, και το
+χτίζει από τις εγγραφές που έχει ήδη. Το fileName δεν πρέπει να είναι ανοιχτό.
+Σε περίπτωση που εκτελεστεί επιτυχώς, επιστρέφεται 0, ενώ σε διαφορετική περίπτωση -1.*/
+int BM_CreateIndex(
+    char* bfileName, /* όνομα αρχείου του ευρετηρίου*/
+    char* fileName, /* όνομα αρχείου πρωτεύοντος ευρετηρίου*/
+    Record_Attribute attribute /* το πεδίο του ευρετηρίου*/);
+
+/*Η συνάρτηση BM_OpenIndex ανοίγει το ευρετήριο bfileName και φορτώνει στη μνήμη τα
+bitmaps όλων των τιμών του. Σε περίπτωση σφάλματος, ή αν το αρχείο δεν είναι
+ευρετήριο bitmap, επιστρέφεται NULL.*/
+BM_info* BM_OpenIndex(char* bfileName /* όνομα αρχείου του ευρετηρίου*/);
+
+/*Η συνάρτηση BM_CloseIndex γράφει τα bitmaps που άλλαξαν, κλείνει το ευρετήριο και
+αποδεσμεύει τη μνήμη της header_info. Σε περίπτωση που εκτελεστεί επιτυχώς,
+επιστρέφεται 0, αλλιώς -1.*/
+int BM_CloseIndex(BM_info* header_info);
+
+/*Η συνάρτηση BM_InsertEntry σημειώνει τη θέση της εγγραφής record, με RID rid, στο
+bitmap της τιμής της. Σε επιτυχία επιστρέφεται 0, αλλιώς -1, και αν το πεδίο έχει
+ήδη DICTIONARY_SIZE διαφορετικές τιμές.*/
+int BM_InsertEntry(BM_info* header_info, Record record, int rid);
+
+/*Η συνάρτηση BM_DeleteEntry σβήνει τη θέση της εγγραφής record, που είχε RID rid, από
+το bitmap της τιμής της. Όπως τα ευρετήρια με rids (sht_table.h), το ευρετήριο
+ενημερώνεται από τις callbacks των HT_DeleteEntry και HT_UpdateEntry, με το παλιό rid
+εδώ και το νέο στη BM_InsertEntry. Σε επιτυχία επιστρέφεται 0, αλλιώς -1.*/
+int BM_DeleteEntry(BM_info* header_info, Record record, int rid);
+
+/*Η συνάρτηση BM_Lookup επιστρέφει ένα αντίγραφο του bitmap των εγγραφών με τιμή
+value, άδειο αν δεν υπάρχει καμία, ή NULL αν δεν υπάρχει μνήμη. Το αποτέλεσμα
+αποδεσμεύεται με τη BM_Free.*/
+BM_Bitmap* BM_Lookup(BM_info* header_info, char* value);
+
+/*Οι συναρτήσεις BM_And και BM_Or επιστρέφουν ένα νέο bitmap με την τομή και την
+ένωση των a και b, που πρέπει να αφορούν το ίδιο πρωτεύον αρχείο, ακόμα και από
+ευρετήρια διαφορετικών πεδίων. Επιστρέφουν NULL σε περίπτωση λάθους.*/
+BM_Bitmap* BM_And(const BM_Bitmap* a, const BM_Bitmap* b);
+
+BM_Bitmap* BM_Or(const BM_Bitmap* a, const BM_Bitmap* b);
+
+/*Η συνάρτηση BM_Not επιστρέφει ένα νέο bitmap με τις εγγραφές του ευρετηρίου
+header_info που δεν είναι στο a, ή NULL σε περίπτωση λάθους.*/
+BM_Bitmap* BM_Not(BM_info* header_info, const BM_Bitmap* a);
+
+// Η συνάρτηση BM_Count επιστρέφει το πλήθος των εγγραφών του bitmap
+long int BM_Count(const BM_Bitmap* bitmap);
+
+// Καλείται από τη BM_ForEach για κάθε εγγραφή, με το RID της και τον δείκτη context
+typedef void (*BM_Callback)(int rid, void* context);
+
+/*Η συνάρτηση BM_ForEach καλεί την callback για το RID κάθε εγγραφής του bitmap, με
+αύξουσα σειρά, ώστε κάθε block του πρωτεύοντος αρχείου να χρειάζεται μία ανάγνωση.*/
+void BM_ForEach(const BM_Bitmap* bitmap, BM_Callback callback, void* context);
+
+void BM_Free(BM_Bitmap* bitmap);
+
+int StatisticsBM(char* filename);
+
+#endif // BITMAP_INDEX_H
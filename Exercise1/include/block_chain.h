@@ -0,0 +1,36 @@
+#ifndef BLOCK_CHAIN_H
+#define BLOCK_CHAIN_H
+#include "bf.h"
+
+/* Μια αλυσίδα από blocks μέσα σε ένα αρχείο, στην οποία αποθηκεύονται
+μεταδεδομένα μεταβλητού μεγέθους (λεξικά, καταλόγοι κάδων κ.λπ.) που
+δεν χωράνε στο πρώτο block του αρχείου.
+
+	_____________________________________		_____________________________________
+	|				|					|		|				|					|
+	| BC_block_info	|	bytes of data	| ---->	| BC_block_info	|	bytes of data	| ----> -1
+	|_______________|___________________|		|_______________|___________________|
+*/
+typedef struct {
+    int nextBlock;  // Next block of the chain, -1 for the last one
+    int bytes;      // Bytes of data stored in this block
+} BC_block_info;
+
+#define BC_BLOCK_CAPACITY (BF_BLOCK_SIZE - (int) sizeof(BC_block_info))
+
+// Tested Call, prints the error of a BF call and returns -1, or 0 for BF_OK. Every file links this one
+int TC(BF_ErrorCode error);
+
+/*Η συνάρτηση BC_Write γράφει size bytes από το data στην αλυσίδα που ξεκινάει
+από το block *firstBlock του αρχείου fileDesc. Τα blocks της υπάρχουσας αλυσίδας
+επαναχρησιμοποιούνται και, αν δεν επαρκούν, δεσμεύονται καινούρια. Αν το
+*firstBlock είναι -1, δημιουργείται νέα αλυσίδα και ο αριθμός του πρώτου της
+block επιστρέφεται στο *firstBlock. Σε επιτυχία επιστρέφεται 0, αλλιώς -1.*/
+int BC_Write(int fileDesc, int* firstBlock, const char* data, int size);
+
+/*Η συνάρτηση BC_Read διαβάζει όλα τα δεδομένα της αλυσίδας που ξεκινάει από
+το block firstBlock σε ένα buffer που δεσμεύεται με malloc, το οποίο επιστρέφεται
+στο *data μαζί με το μέγεθός του στο *size. Σε επιτυχία επιστρέφεται 0, αλλιώς -1.*/
+int BC_Read(int fileDesc, int firstBlock, char** data, int* size);
+
+#endif // BLOCK_CHAIN_H
@@ -0,0 +1,42 @@
+#ifndef BLOOM_FILTER_H
+#define BLOOM_FILTER_H
+#include "bf.h"
+
+/* Φίλτρα Bloom ανά κάδο για ένα αρχείο κατακερματισμού. Κάθε κάδος έχει ένα
+φίλτρο filterBytes bytes και τα φίλτρα αποθηκεύονται με τη σειρά των κάδων σε
+συνεχόμενα blocks φίλτρων, BF_BLOCK_SIZE / filterBytes φίλτρα ανά block, ώστε
+ένα φίλτρο να μη μοιράζεται ποτέ σε δύο blocks.
+
+	_____________________________________________
+	|			|			|		|			|
+	| bucket 0	| bucket 1	|  ...	| bucket k	|   (block firstBlock, firstBlock + 1, ...)
+	|___________|___________|_______|___________|
+
+Ένα αρνητικό αποτέλεσμα σημαίνει ότι το κλειδί σίγουρα δεν υπάρχει στον κάδο,
+ενώ ένα θετικό ότι μπορεί να υπάρχει. Τα φίλτρα δεν υποστηρίζουν διαγραφή. */
+
+// Bits set for every key, the false positive rate is lowest near (bits / keys) * ln 2
+#define BLOOM_HASHES 3
+
+/*Οι συναρτήσεις BLOOM_Set και BLOOM_Test προσθέτουν και ελέγχουν την τιμή
+κατακερματισμού hash σε ένα φίλτρο filterBytes bytes που βρίσκεται ήδη στη μνήμη,
+με τα ίδια bits που χρησιμοποιούν τα φίλτρα των κάδων. Η BLOOM_Test επιστρέφει
+0 αν το κλειδί σίγουρα δεν υπάρχει και 1 αν μπορεί να υπάρχει.*/
+void BLOOM_Set(unsigned char* filter, int filterBytes, unsigned int hash);
+int BLOOM_Test(const unsigned char* filter, int filterBytes, unsigned int hash);
+
+/*Η συνάρτηση BLOOM_CreateFilters δεσμεύει στο τέλος του αρχείου fileDesc τα
+άδεια blocks φίλτρων για buckets κάδους και επιστρέφει τον αριθμό του πρώτου στο
+*firstBlock. Σε επιτυχία επιστρέφεται 0, αλλιώς -1.*/
+int BLOOM_CreateFilters(int fileDesc, int buckets, int filterBytes, int* firstBlock);
+
+/*Η συνάρτηση BLOOM_Add προσθέτει την τιμή κατακερματισμού hash ενός κλειδιού
+στο φίλτρο του κάδου bucket. Σε επιτυχία επιστρέφεται 0, αλλιώς -1.*/
+int BLOOM_Add(int fileDesc, int firstBlock, int filterBytes, int bucket, unsigned int hash);
+
+/*Η συνάρτηση BLOOM_MayContain ελέγχει το φίλτρο του κάδου bucket, διαβάζοντας
+ένα block. Επιστρέφει 0 αν το κλειδί με τιμή κατακερματισμού hash σίγουρα δεν
+υπάρχει στον κάδο, 1 αν μπορεί να υπάρχει, και -1 σε περίπτωση λάθους.*/
+int BLOOM_MayContain(int fileDesc, int firstBlock, int filterBytes, int bucket, unsigned int hash);
+
+#endif // BLOOM_FILTER_H
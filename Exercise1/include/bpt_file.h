@@ -0,0 +1,85 @@
+#ifndef BPT_FILE_H
+#define BPT_FILE_H
+#include <record.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+// Upper bound of the height of a tree, far above what a file of 2^31 blocks can reach
+#define BPT_MAX_HEIGHT 16
+
+/* Η δομή BPT_info κρατάει μεταδεδομένα που σχετίζονται με ένα αρχείο
+δέντρου B+ με κλειδί το id. Οι εγγραφές βρίσκονται μόνο στα φύλλα,
+ταξινομημένες κατά id, και κάθε φύλλο δείχνει στο επόμενο, ώστε μια
+αναζήτηση διαστήματος να διαβάζει τα φύλλα του διαστήματος με τη σειρά.
+Οι εσωτερικοί κόμβοι έχουν μόνο κλειδιά και αριθμούς blocks παιδιών. */
+typedef struct {
+    int fileDesc;
+    bool isHeapFile;
+    bool isHashFile;
+    bool isTreeFile;
+    int root;               // Block of the root, a leaf while the tree has height 1
+    int height;             // Levels of the tree, the leaves included
+    int firstLeaf;          // Leftmost leaf, where a scan of the whole file starts
+    int recordsPerLeaf;
+    int keysPerNode;        // Keys of a full internal node, which has one more child
+    long int records;       // Records in the file
+} BPT_info;
+
+// Η δομή BPT_block_info βρίσκεται στην αρχή κάθε κόμβου
+typedef struct {
+    bool isLeaf;
+    int count;              // Records of a leaf, keys of an internal node
+    int nextBlock;          // Next leaf in key order, -1 for the last one and for internal nodes
+} BPT_block_info;
+
+// Καλείται από την BPT_RangeScan για κάθε εγγραφή του διαστήματος, με τη σειρά του id
+typedef void (*BPT_Callback)(Record* record, int blockId, void* context);
+
+/*Η συνάρτηση BPT_CreateFile χρησιμοποιείται για τη δημιουργία και κατάλληλη
+αρχικοποίηση ενός άδειου αρχείου δέντρου B+ με όνομα fileName, του οποίου η
+ρίζα είναι ένα άδειο φύλλο. Σε περίπτωση που εκτελεστεί επιτυχώς, επιστρέφεται 0,
+ενώ σε διαφορετική περίπτωση -1.*/
+int BPT_CreateFile(char *fileName /*όνομα αρχείου*/);
+
+/*Η συνάρτηση BPT_OpenFile ανοίγει το αρχείο με όνομα fileName και διαβάζει
+την πληροφορία του πρώτου block. Αν το αρχείο δεν είναι αρχείο δέντρου B+,
+ή συμβεί οποιοδήποτε σφάλμα, επιστρέφεται NULL.*/
+BPT_info* BPT_OpenFile(char *fileName /*όνομα αρχείου*/);
+
+/*Η συνάρτηση BPT_CloseFile γράφει την επικεφαλίδα στο αρχείο και το κλείνει,
+αποδεσμεύοντας τη μνήμη της header_info. Σε περίπτωση που εκτελεστεί επιτυχώς,
+επιστρέφεται 0, αλλιώς -1.*/
+int BPT_CloseFile(BPT_info* header_info);
+
+/*Η συνάρτηση BPT_InsertEntry εισάγει την εγγραφή record στο φύλλο όπου ανήκει το
+id της, μετά από όσες έχουν ήδη το ίδιο id. Ένα γεμάτο φύλλο διασπάται σε δύο και
+η διάσπαση ανεβαίνει όσο χρειάζεται, ως και τη ρίζα. Επιστρέφεται ο αριθμός του
+block στο οποίο έγινε η εισαγωγή, ενώ σε διαφορετική περίπτωση -1. Προσοχή: μια
+μεταγενέστερη διάσπαση μπορεί να μετακινήσει την εγγραφή σε άλλο block.*/
+int BPT_InsertEntry(BPT_info* header_info, Record record);
+
+/*Η συνάρτηση BPT_BulkLoad φορτώνει σε ένα άδειο αρχείο τις n εγγραφές records,
+που πρέπει να είναι ταξινομημένες κατά id. Τα φύλλα γεμίζουν πλήρως από αριστερά
+προς τα δεξιά και κάθε επίπεδο εσωτερικών κόμβων χτίζεται καθώς γεμίζει το από
+κάτω του, ώστε κάθε block να γράφεται μία φορά. Σε επιτυχία επιστρέφεται 0, ενώ
+αν το αρχείο δεν είναι άδειο, οι εγγραφές δεν είναι ταξινομημένες ή συμβεί
+σφάλμα, επιστρέφεται -1.*/
+int BPT_BulkLoad(BPT_info* header_info, const Record* records, size_t n);
+
+/*Η συνάρτηση BPT_GetAllEntries εκτυπώνει όλες τις εγγραφές με id ίσο με value
+και επιστρέφει το πλήθος των blocks που διαβάστηκαν, ή -1 σε περίπτωση λάθους.*/
+int BPT_GetAllEntries(BPT_info* header_info, int* value);
+
+/*Η συνάρτηση BPT_RangeScan καλεί την callback για κάθε εγγραφή με id στο [low, high],
+με αύξουσα σειρά id, ή την εκτυπώνει αν η callback είναι NULL. Διαβάζονται μόνο
+τα blocks του μονοπατιού προς το πρώτο φύλλο και τα φύλλα του διαστήματος.
+Επιστρέφει το πλήθος των blocks που διαβάστηκαν, ή -1 σε περίπτωση λάθους.*/
+int BPT_RangeScan(BPT_info* header_info, /*επικεφαλίδα του αρχείου*/
+    int low, /*μικρότερο id του διαστήματος*/
+    int high, /*μεγαλύτερο id του διαστήματος*/
+    BPT_Callback callback, /*καλείται για κάθε εγγραφή του διαστήματος*/
+    void* context /*περνάει αυτούσιο στην callback*/);
+
+int TreeStatisticsBPT(char* filename);
+
+#endif // BPT_FILE_H
@@ -0,0 +1,65 @@
+#ifndef EH_TABLE_H
+#define EH_TABLE_H
+#include <record.h>
+#include <stdbool.h>
+
+// Upper bound of the global depth, the directory never grows past 2^EH_MAX_DEPTH entries (4 MB)
+#define EH_MAX_DEPTH 20
+
+/* Η δομή EH_info κρατάει μεταδεδομένα που σχετίζονται με το αρχείο
+επεκτατού κατακερματισμού (extendible hashing). Ο κατάλογος έχει
+2^globalDepth θέσεις, κάθε μία με τον αριθμό του block του κάδου της,
+και αποθηκεύεται σε μια αλυσίδα από blocks (block_chain.h). */
+typedef struct {
+    int fileDesc;
+    bool isHeapFile;
+    bool isHashFile;
+    int recordsPerBlock;
+    int globalDepth;        // The directory has 2^globalDepth entries
+    int buckets;            // Distinct bucket blocks the directory points to
+    int directoryBlock;     // First block of the directory chain
+    int* directory;         // In-memory directory, valid only while the file is open
+} EH_info;
+
+// Η δομή EH_block_info κρατάει μεταδεδομένα που σχετίζονται με ένα κάδο
+typedef struct {
+    int localDepth;         // Hash bits shared by every record of the bucket
+    int recordsCount;       // Max ammount it can hold
+    int currentRecords;     // How many it currently holds
+    int nextBlock;          // Overflow block, chained when no split up to EH_MAX_DEPTH would separate the records
+} EH_block_info;
+
+/*Η συνάρτηση EH_CreateFile χρησιμοποιείται για τη δημιουργία και κατάλληλη
+αρχικοποίηση ενός άδειου αρχείου επεκτατού κατακερματισμού με όνομα fileName,
+με 2^depth αρχικούς κάδους. Σε περίπτωση που εκτελεστεί επιτυχώς, επιστρέφεται 0,
+ενώ σε διαφορετική περίπτωση -1.*/
+int EH_CreateFile(
+    char *fileName,     /*όνομα αρχείου*/
+    int depth           /*αρχικό ολικό βάθος*/);
+
+/*Η συνάρτηση EH_OpenFile ανοίγει το αρχείο με όνομα fileName, διαβάζει
+την πληροφορία του πρώτου block και φορτώνει τον κατάλογο στη μνήμη.
+Σε περίπτωση σφάλματος επιστρέφεται NULL.*/
+EH_info* EH_OpenFile(char *fileName /*όνομα αρχείου*/);
+
+/*Η συνάρτηση EH_CloseFile γράφει τον κατάλογο και την επικεφαλίδα στο
+αρχείο και το κλείνει, αποδεσμεύοντας τη μνήμη της header_info.
+Σε περίπτωση που εκτελεστεί επιτυχώς, επιστρέφεται 0, αλλιώς -1.*/
+int EH_CloseFile(EH_info* header_info);
+
+/*Η συνάρτηση EH_InsertEntry εισάγει την εγγραφή record στο αρχείο. Όταν ο
+κάδος γεμίσει, διασπάται σε δύο και, αν χρειαστεί, ο κατάλογος διπλασιάζεται. Αν
+καμία διάσπαση ως το EH_MAX_DEPTH δεν θα χώριζε τις εγγραφές του (π.χ. όλες έχουν
+το ίδιο id), ο κάδος αποκτά ένα block υπερχείλισης αντί να διασπαστεί.
+Επιστρέφεται ο αριθμός του block στο οποίο έγινε η εισαγωγή, ενώ σε διαφορετική
+περίπτωση -1. Προσοχή: μια μεταγενέστερη διάσπαση μπορεί να μετακινήσει την
+εγγραφή σε άλλο block.*/
+int EH_InsertEntry(EH_info* header_info, Record record);
+
+/*Η συνάρτηση EH_GetAllEntries εκτυπώνει όλες τις εγγραφές με id ίσο με value
+και επιστρέφει το πλήθος των blocks που διαβάστηκαν, ή -1 σε περίπτωση λάθους.*/
+int EH_GetAllEntries(EH_info* header_info, int* value);
+
+int HashStatisticsEH(char* filename);
+
+#endif // EH_TABLE_H
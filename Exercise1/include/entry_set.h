@@ -0,0 +1,27 @@
+#ifndef ENTRY_SET_H
+#define ENTRY_SET_H
+
+/* Ένα σύνολο από ζεύγη <key, value> στη μνήμη, με ανοιχτή διευθυνσιοδότηση και
+γραμμική αναζήτηση, για ελέγχους ύπαρξης σε O(1) χωρίς ανάγνωση blocks. Ένα
+ευρετήριο κρατάει σε αυτό ζεύγη <αποτύπωμα ονόματος, block> όσο είναι ανοιχτό.
+Το value δεν μπορεί να είναι -1, που σημαδεύει τις άδειες θέσεις. Το σύνολο δεν
+είναι thread-safe, ο καλών το προστατεύει με τα δικά του latches. */
+
+typedef struct Entry_Set Entry_Set;
+
+// Η συνάρτηση ES_Create δημιουργεί ένα άδειο σύνολο, ή επιστρέφει NULL αν δεν υπάρχει μνήμη
+Entry_Set* ES_Create(void);
+
+void ES_Destroy(Entry_Set* set);
+
+/*Η συνάρτηση ES_Insert προσθέτει το ζεύγος <key, value> στο σύνολο. Επιστρέφει 1 αν
+προστέθηκε, 0 αν υπήρχε ήδη και -1 αν δεν υπάρχει μνήμη για να μεγαλώσει το σύνολο.*/
+int ES_Insert(Entry_Set* set, unsigned long long key, int value);
+
+// Η συνάρτηση ES_Contains επιστρέφει 1 αν το ζεύγος <key, value> υπάρχει στο σύνολο, αλλιώς 0
+int ES_Contains(const Entry_Set* set, unsigned long long key, int value);
+
+// Η συνάρτηση ES_Remove αφαιρεί το ζεύγος <key, value>, αν υπάρχει
+void ES_Remove(Entry_Set* set, unsigned long long key, int value);
+
+#endif // ENTRY_SET_H
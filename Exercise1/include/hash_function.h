@@ -0,0 +1,52 @@
+#ifndef HASH_FUNCTION_H
+#define HASH_FUNCTION_H
+
+/* Οι συναρτήσεις κατακερματισμού που μπορεί να χρησιμοποιήσει ένα αρχείο
+κατακερματισμού. Η επιλογή αποθηκεύεται στην επικεφαλίδα του αρχείου, ώστε
+κάθε άνοιγμα να βρίσκει τους ίδιους κάδους.
+DEFAULT_HASH: key % buckets για ακέραιους και djb2 % buckets για συμβολοσειρές.
+FIBONACCI_HASH: πολλαπλασιασμός με το 2^64 / φ (πολλαπλασιαστικός κατακερματισμός).
+MURMUR_HASH: ο τελικός αναμίκτης (finalizer) του murmur3.
+XXHASH: ο αλγόριθμος xxHash32.
+CRC32C_HASH: CRC32C (Castagnoli), με την εντολή crc32 του SSE4.2 όπου υπάρχει.
+Για συμβολοσειρές, οι FIBONACCI_HASH και MURMUR_HASH αναμιγνύουν την τιμή djb2. */
+typedef enum Hash_Function {
+  DEFAULT_HASH,
+  FIBONACCI_HASH,
+  MURMUR_HASH,
+  XXHASH,
+  CRC32C_HASH
+} Hash_Function;
+
+#define HASH_FUNCTIONS 5
+
+// Η συνάρτηση HF_Name επιστρέφει το όνομα της συνάρτησης function, για εκτυπώσεις
+const char* HF_Name(Hash_Function function);
+
+// Η συνάρτηση HF_HashInt επιστρέφει την τιμή κατακερματισμού του ακεραίου key
+unsigned int HF_HashInt(Hash_Function function, int key);
+
+/* Η συνάρτηση HF_HashString επιστρέφει την τιμή κατακερματισμού της
+συμβολοσειράς value, που τερματίζεται με '\0'. */
+unsigned int HF_HashString(Hash_Function function, const char* value);
+
+/* Η συνάρτηση HF_Reduce αντιστοιχίζει την τιμή hash σε έναν κάδο στο [0, buckets).
+Για DEFAULT_HASH χρησιμοποιείται το υπόλοιπο, όπως πάντα. Για τις υπόλοιπες,
+αν το buckets είναι δύναμη του 2 κρατιούνται τα χαμηλά bits (μάσκα), αλλιώς
+χρησιμοποιείται η μέθοδος fast range, (hash * buckets) >> 32, χωρίς διαίρεση. */
+unsigned int HF_Reduce(Hash_Function function, unsigned int hash, int buckets);
+
+// Bytes of a fingerprint array, a multiple of the 16 bytes compared at once
+#define HF_TAG_BYTES(count) (((count) + 15) / 16 * 16)
+
+/* Η συνάρτηση HF_Fingerprint επιστρέφει ένα αποτύπωμα (fingerprint) ενός byte
+για την τιμή κατακερματισμού hash, ανεξάρτητο από τα bits που επιλέγουν τον κάδο.*/
+unsigned char HF_Fingerprint(unsigned int hash);
+
+/* Η συνάρτηση HF_MatchTags συγκρίνει το tag με τα πρώτα count αποτυπώματα του
+πίνακα tags, 16 τη φορά με SSE2 όπου υπάρχει, και επιστρέφει μια μάσκα με το
+bit i ενεργό αν tags[i] == tag. Ο πίνακας πρέπει να έχει HF_TAG_BYTES(count) bytes.
+Η μάσκα έχει 64 bits, οπότε πρέπει 0 <= count <= 64.*/
+unsigned long long HF_MatchTags(const unsigned char* tags, int count, unsigned char tag);
+
+#endif // HASH_FUNCTION_H
@@ -15,8 +15,17 @@ typedef struct {
     bool isHash;
     int lastBlock;
     int nextBlock;
+    Record_Format format;           // How records are laid out inside the blocks
+    int dictionaryBlock;            // First block of the dictionary chain (ENCODED_FORMAT), -1 if none
+    Record_Dictionary* dictionary;  // In-memory dictionary, valid only while the file is open
 } HP_info;
 
+// Επιλογές δημιουργίας ενός αρχείου σωρού. Τα πεδία που δεν ορίζονται
+// (μηδενικά) αντιστοιχούν στη συμπεριφορά της HP_CreateFile.
+typedef struct {
+    Record_Format format;
+} HP_options;
+
 // Η δομή HP_block_info κρατάει μεταδεδομένα που σχετίζονται με το μπλοκ
 typedef struct {
     int currentRecords;
@@ -35,6 +44,14 @@ int TC(BF_ErrorCode error);
 int HP_CreateFile(
     char *fileName /*όνομα αρχείου*/);
 
+/*Η συνάρτηση HP_CreateFileWithOptions λειτουργεί όπως η HP_CreateFile, αλλά
+δέχεται επιπλέον τις επιλογές options του αρχείου (π.χ. τη μορφή των εγγραφών).
+Σε περίπτωση που εκτελεστεί επιτυχώς, επιστρέφεται 0, ενώ σε διαφορετική
+περίπτωση -1.*/
+int HP_CreateFileWithOptions(
+    char *fileName, /*όνομα αρχείου*/
+    HP_options options /*επιλογές του αρχείου*/);
+
 /* Η συνάρτηση HP_OpenFile ανοίγει το αρχείο με όνομα filename και
 διαβάζει από το πρώτο μπλοκ την πληροφορία που αφορά το αρχείο σωρού.
 Κατόπιν, ενημερώνεται μια δομή που κρατάτε όσες πληροφορίες κρίνονται
@@ -2,9 +2,10 @@
 #define HT_TABLE_H
 #include <record.h>
 #include <stdbool.h>
-
-#define MAX_BUCKETS 30
-
+#include <stddef.h>
+#include "hash_function.h"
+#include "record_key.h"
+#include "latch.h"
 
 typedef struct {
     // Να το συμπληρώσετε
@@ -13,12 +14,48 @@ typedef struct {
     bool isHeapFile;
     bool isHashFile;
     int recordsPerBlock;
-    // int* hashTable;
-    int hashTable[MAX_BUCKETS];
+    Record_Format format;           // How records are laid out inside the blocks
+    int dictionaryBlock;            // First block of the dictionary chain (ENCODED_FORMAT), -1 if none
+    Record_Dictionary* dictionary;  // In-memory dictionary, valid only while the file is open
+    Hash_Function hashFunction;     // Maps a key to its bucket, fixed at creation
+    Record_Key key;                 // Attributes the records are hashed and looked up on, fixed at creation
+    const Key_Operations* keyOps;   // Hash and comparison specialized for key, valid only while the file is open
+    int filterBytes;                // Bytes of the Bloom filter of every bucket, 0 if there are none
+    int filterBlock;                // First of the consecutive filter blocks (bloom_filter.h)
+    int tagBytes;                   // Fingerprint bytes ahead of the records of every block, 0 if none
+    bool unique;                    // Every key is stored at most once, lookups stop at the first hit
+    int freeBlock;                  // First block emptied by deletes, chained through nextBlock, -1 if none
+    int directoryBlock;             // First block of the chain that stores hashTable
+    int* hashTable;                 // Head block of every bucket, valid only while the file is open
+    Latch_Table* latches;           // Bucket and file latches (latch.h), valid only while the file is open
+    int indexBlock;                 // First block of the chain that stores indexNames, -1 if none
+    int indexCount;                 // Secondary indexes registered for the file
+    char* indexNames;               // Their file names, HT_INDEX_NAME_SIZE bytes each, valid only while the file is open
 } HT_info;
 
+// Bytes of the name of a registered secondary index, with its terminating '\0'
+#define HT_INDEX_NAME_SIZE 64
+
+// Επιλογές δημιουργίας ενός αρχείου κατακερματισμού. Τα πεδία που δεν
+// ορίζονται (μηδενικά) αντιστοιχούν στη συμπεριφορά της HT_CreateFile.
+typedef struct {
+    Record_Format format;
+    Hash_Function hash;
+    int filterBytes;    // Bloom filter bytes per bucket, at most BF_BLOCK_SIZE
+    bool fingerprints;  // One byte fingerprint per record in every block (FIXED and ENCODED formats)
+    bool unique;        // Reject the insertion of a key that already exists
+    Record_Key key;     // Attributes of the key (record_key.h), the id if 0
+} HT_options;
+
 int TC(BF_ErrorCode error);
 
+/* Το RID μιας εγγραφής: ο αριθμός του block της και η θέση (slot) της μέσα σε αυτό,
+σε έναν ακέραιο. Τα blocks ως 2^23 - 1 και οι θέσεις ως 255 χωράνε. */
+#define HT_RID_SLOT_BITS 8
+#define HT_RID(block, slot) ((block) << HT_RID_SLOT_BITS | (slot))
+#define HT_RID_BLOCK(rid) ((rid) >> HT_RID_SLOT_BITS)
+#define HT_RID_SLOT(rid) ((rid) & ((1 << HT_RID_SLOT_BITS) - 1))
+
 int HashStatisticsHT(char* filename);
 
 typedef struct
@@ -48,6 +85,14 @@ int HT_CreateFile(
     char *fileName, 	/*όνομα αρχείου*/
     int buckets         /*αριθμός από buckets*/);
 
+/*Η συνάρτηση HT_CreateFileWithOptions λειτουργεί όπως η HT_CreateFile, αλλά
+δέχεται επιπλέον τις επιλογές options του αρχείου (π.χ. τη μορφή των εγγραφών).
+Σε περίπτωση που εκτελεστεί επιτυχώς, επιστρέφεται 0, ενώ σε διαφορετική περίπτωση -1.*/
+int HT_CreateFileWithOptions(
+    char *fileName,     /*όνομα αρχείου*/
+    int buckets,        /*αριθμός από buckets*/
+    HT_options options  /*επιλογές του αρχείου*/);
+
 /*Η συνάρτηση HT_OpenFile ανοίγει το αρχείο με όνομα filename
 και διαβάζει από το πρώτο μπλοκ την πληροφορία που αφορά το
 αρχείο κατακερματισμού. Κατόπιν, ενημερώνεται μια δομή που κρατάτε
@@ -70,10 +115,22 @@ int HT_CloseFile(HT_info* header_info );
 στο αρχείο κατακερματισμού. Οι πληροφορίες που αφορούν το αρχείο βρίσκονται στη
 δομή header_info, ενώ η εγγραφή προς εισαγωγή προσδιορίζεται από τη δομή record.
 Σε περίπτωση που εκτελεστεί επιτυχώς, επιστρέφετε τον αριθμό του block στο οποίο
-έγινε η εισαγωγή (blockId) , ενώ σε διαφορετική περίπτωση -1.*/
+έγινε η εισαγωγή (blockId) , ενώ σε διαφορετική περίπτωση -1. Σε αρχεία με
+μοναδικά κλειδιά (HT_options.unique), η εισαγωγή ενός κλειδιού που υπάρχει ήδη αποτυγχάνει.
+Η συνάρτηση μπορεί να καλείται ταυτόχρονα από πολλά νήματα για το ίδιο ανοιχτό αρχείο,
+μαζί με τις HT_GetAllEntries, HT_GetEntry (και τις ByKey εκδοχές τους) και HT_GetMany:
+κλειδώνεται μόνο ο κάδος της εγγραφής (latch.h). Οι υπόλοιπες συναρτήσεις θέλουν
+αποκλειστική πρόσβαση.*/
 int HT_InsertEntry(HT_info* header_info, /*επικεφαλίδα του αρχείου*/
     Record record /*δομή που προσδιορίζει την εγγραφή*/);
 
+/*Η συνάρτηση HT_InsertEntryWithRid λειτουργεί όπως η HT_InsertEntry και επιπλέον
+επιστρέφει στο *rid το RID της εγγραφής, για τα ευρετήρια που δείχνουν σε εγγραφές
+και όχι σε blocks.*/
+int HT_InsertEntryWithRid(HT_info* header_info, /*επικεφαλίδα του αρχείου*/
+    Record record, /*δομή που προσδιορίζει την εγγραφή*/
+    int* rid /*το RID της εγγραφής που εισήχθη*/);
+
 /* Η συνάρτηση αυτή χρησιμοποιείται για την εκτύπωση όλων των εγγραφών που υπάρχουν
 στο αρχείο κατακερματισμού οι οποίες έχουν τιμή στο πεδίο-κλειδί ίση με value.
 Η πρώτη δομή δίνει πληροφορία για το αρχείο κατακερματισμού, όπως αυτή είχε επιστραφεί
@@ -84,6 +141,152 @@ int HT_InsertEntry(HT_info* header_info, /*επικεφαλίδα του αρχ
 int HT_GetAllEntries(HT_info* header_info, /*επικεφαλίδα του αρχείου*/
 	int* value /*τιμή του πεδίου-κλειδιού προς αναζήτηση*/);
 
+/*Η συνάρτηση HT_GetEntry αναζητά μια εγγραφή με τιμή στο πεδίο-κλειδί ίση με value,
+ξεκινώντας από το νεότερο block του κάδου, και σταματάει στην πρώτη που θα βρει,
+την οποία επιστρέφει στο record. Σε αρχεία με μοναδικά κλειδιά είναι η μόνη.
+Επιστρέφει τον αριθμό του block της εγγραφής, 0 αν δεν υπάρχει, ή -1 σε περίπτωση λάθους.*/
+int HT_GetEntry(HT_info* header_info, /*επικεφαλίδα του αρχείου*/
+	int value, /*τιμή του πεδίου-κλειδιού προς αναζήτηση*/
+	Record* record /*η εγγραφή που βρέθηκε*/);
+
+/* Οι συναρτήσεις που δέχονται την τιμή value ως int αφορούν αρχεία με κλειδί το id
+(HT_options.key), αλλιώς επιστρέφουν -1. Για οποιοδήποτε κλειδί, οι αντίστοιχες
+συναρτήσεις ByKey δέχονται μια εγγραφή key, από την οποία διαβάζονται μόνο τα πεδία
+του κλειδιού, π.χ. name και surname για RECORD_KEY(NAME) | RECORD_KEY(SURNAME).*/
+
+/*Η συνάρτηση HT_GetAllEntriesByKey λειτουργεί όπως η HT_GetAllEntries, για τις
+εγγραφές με τις ίδιες τιμές με την key στα πεδία του κλειδιού του αρχείου.*/
+int HT_GetAllEntriesByKey(HT_info* header_info, /*επικεφαλίδα του αρχείου*/
+	Record* key /*οι τιμές των πεδίων του κλειδιού προς αναζήτηση*/);
+
+/*Η συνάρτηση HT_GetEntryByKey λειτουργεί όπως η HT_GetEntry, για μια εγγραφή με
+τις ίδιες τιμές με την key στα πεδία του κλειδιού του αρχείου.*/
+int HT_GetEntryByKey(HT_info* header_info, /*επικεφαλίδα του αρχείου*/
+	Record* key, /*οι τιμές των πεδίων του κλειδιού προς αναζήτηση*/
+	Record* record /*η εγγραφή που βρέθηκε*/);
+
+/*Η συνάρτηση HT_BulkLoad εισάγει μαζικά τις n εγγραφές του πίνακα records, χωρίς
+εκτυπώσεις. Οι εγγραφές χωρίζονται πρώτα στη μνήμη ανά κάδο και κάθε κάδος γεμίζει
+με τη σειρά πλήρη blocks που δεσμεύονται συνεχόμενα. Σε αρχεία με μοναδικά κλειδιά,
+αν κάποιο κλειδί επαναλαμβάνεται ή υπάρχει ήδη, δεν εισάγεται καμία εγγραφή. Σε περίπτωση
+που εκτελεστεί επιτυχώς, επιστρέφεται 0, ενώ σε διαφορετική περίπτωση -1.*/
+int HT_BulkLoad(HT_info* header_info, /*επικεφαλίδα του αρχείου*/
+	const Record* records, /*οι εγγραφές προς εισαγωγή*/
+	size_t n /*το πλήθος τους*/);
+
+// Καλείται από τις HT_GetMany, HT_ScanEntries και HT_DeleteEntry για κάθε εγγραφή, με το id
+// key, την εγγραφή record, το RID της (HT_RID_BLOCK για το block) και τον δείκτη context του καλούντος.
+typedef void (*HT_Callback)(int key, Record* record, int rid, void* context);
+
+// Καλείται από τις HT_UpdateEntry και HT_DeleteEntry για κάθε εγγραφή που άλλαξε ή
+// μετακινήθηκε, ακόμα και σε άλλη θέση του ίδιου block, με την παλιά εγγραφή old και
+// το RID oldRid που είχε, και τη νέα εγγραφή updated και το RID newRid της.
+typedef void (*HT_UpdateCallback)(Record* old, int oldRid, Record* updated, int newRid, void* context);
+
+/*Η συνάρτηση HT_DeleteEntry διαγράφει τις εγγραφές με τιμή στο πεδίο-κλειδί ίση
+με value (σε αρχεία με μοναδικά κλειδιά, τη μία). Κάθε κενό γεμίζει με την
+τελευταία εγγραφή του νεότερου block (κεφαλή) του κάδου, ώστε μόνο αυτό να έχει
+ελεύθερο χώρο, και μια κεφαλή που αδειάζει βγαίνει από την αλυσίδα και μπαίνει
+σε μια λίστα ελεύθερων blocks, από την οποία παίρνουν πρώτα οι επόμενες
+εισαγωγές. Για κάθε εγγραφή που διαγράφηκε καλείται η removed και για κάθε
+εγγραφή που άλλαξε θέση η moved (όσες δεν είναι NULL), ώστε να ενημερωθούν τα
+δευτερεύοντα ευρετήρια. Επιστρέφει το πλήθος των εγγραφών που διαγράφηκαν, ή -1
+σε περίπτωση λάθους.*/
+int HT_DeleteEntry(HT_info* header_info, /*επικεφαλίδα του αρχείου*/
+	int value, /*τιμή του πεδίου-κλειδιού προς διαγραφή*/
+	HT_Callback removed, /*καλείται για κάθε εγγραφή που διαγράφηκε*/
+	HT_UpdateCallback moved, /*καλείται για κάθε εγγραφή που μετακινήθηκε*/
+	void* context /*περνάει αυτούσιο στις callbacks*/);
+
+/*Η συνάρτηση HT_DeleteEntryByKey λειτουργεί όπως η HT_DeleteEntry, για τις
+εγγραφές με τις ίδιες τιμές με την key στα πεδία του κλειδιού του αρχείου.*/
+int HT_DeleteEntryByKey(HT_info* header_info, /*επικεφαλίδα του αρχείου*/
+	Record* key, /*οι τιμές των πεδίων του κλειδιού προς διαγραφή*/
+	HT_Callback removed, /*καλείται για κάθε εγγραφή που διαγράφηκε*/
+	HT_UpdateCallback moved, /*καλείται για κάθε εγγραφή που μετακινήθηκε*/
+	void* context /*περνάει αυτούσιο στις callbacks*/);
+
+/*Η συνάρτηση HT_UpdateEntry αντικαθιστά τις εγγραφές με τιμή στο πεδίο-κλειδί
+ίση με value (σε αρχεία με μοναδικά κλειδιά, τη μία) με την record, στη θέση
+τους. Το record.id πρέπει να είναι ίσο με value. Μόνο στο SLOTTED_FORMAT, μια
+μεγαλύτερη εγγραφή που δεν χωράει πια στο block της μετακινείται στην κεφαλή
+του κάδου. Για κάθε εγγραφή που άλλαξε καλείται η callback (αν δεν είναι NULL),
+ώστε να ενημερωθούν τα δευτερεύοντα ευρετήρια. Επιστρέφει το πλήθος των
+εγγραφών που άλλαξαν, ή -1 σε περίπτωση λάθους.*/
+int HT_UpdateEntry(HT_info* header_info, /*επικεφαλίδα του αρχείου*/
+	int value, /*τιμή του πεδίου-κλειδιού προς ενημέρωση*/
+	Record record, /*η νέα εγγραφή*/
+	HT_UpdateCallback callback, /*καλείται για κάθε εγγραφή που άλλαξε*/
+	void* context /*περνάει αυτούσιο στην callback*/);
+
+/*Η συνάρτηση HT_UpdateEntryByKey λειτουργεί όπως η HT_UpdateEntry, για τις
+εγγραφές με τις ίδιες τιμές με την record στα πεδία του κλειδιού του αρχείου.*/
+int HT_UpdateEntryByKey(HT_info* header_info, /*επικεφαλίδα του αρχείου*/
+	Record record, /*η νέα εγγραφή, με το κλειδί των εγγραφών προς ενημέρωση*/
+	HT_UpdateCallback callback, /*καλείται για κάθε εγγραφή που άλλαξε*/
+	void* context /*περνάει αυτούσιο στην callback*/);
+
+/*Η συνάρτηση HT_GetMany αναζητά μαζί τα n κλειδιά του πίνακα keys. Τα κλειδιά
+ομαδοποιούνται ανά κάδο και η αλυσίδα κάθε κάδου διασχίζεται μία φορά για όλα τα
+κλειδιά του. Για κάθε εγγραφή που βρίσκεται καλείται η callback, χωρίς εκτυπώσεις,
+με τη σειρά των κάδων και όχι των κλειδιών. Όπως η HT_GetEntry, μπορεί να καλείται
+ταυτόχρονα με την HT_InsertEntry (latch.h). Η callback καλείται με τον κάδο της
+εγγραφής κλειδωμένο, οπότε δεν πρέπει να εισάγει στο ίδιο αρχείο. Επιστρέφει το
+πλήθος των blocks που διαβάστηκαν, ή -1 σε περίπτωση λάθους.*/
+int HT_GetMany(HT_info* header_info, /*επικεφαλίδα του αρχείου*/
+	const int* keys, /*τα κλειδιά προς αναζήτηση*/
+	size_t n, /*το πλήθος τους*/
+	HT_Callback callback, /*καλείται για κάθε εγγραφή που βρέθηκε*/
+	void* context /*περνάει αυτούσιο στην callback*/);
+
+/*Η συνάρτηση HT_ScanEntries καλεί την callback για κάθε εγγραφή του αρχείου, κάδο
+προς κάδο. Επιστρέφει το πλήθος των blocks που διαβάστηκαν, ή -1 σε περίπτωση λάθους.*/
+int HT_ScanEntries(HT_info* header_info, /*επικεφαλίδα του αρχείου*/
+	HT_Callback callback, /*καλείται για κάθε εγγραφή*/
+	void* context /*περνάει αυτούσιο στην callback*/);
+
+/*Η συνάρτηση HT_ScanBuckets λειτουργεί όπως η HT_ScanEntries, για τους κάδους
+first ως last - 1. Μπορεί να καλείται ταυτόχρονα από πολλά νήματα, για
+διαφορετικά διαστήματα κάδων, όσο το αρχείο δεν αλλάζει.*/
+int HT_ScanBuckets(HT_info* header_info, /*επικεφαλίδα του αρχείου*/
+	int first, /*ο πρώτος κάδος*/
+	int last, /*ο κάδος μετά τον τελευταίο*/
+	HT_Callback callback, /*καλείται για κάθε εγγραφή*/
+	void* context /*περνάει αυτούσιο στην callback*/);
+
+/*Η συνάρτηση HT_Reorganize ξαναχτίζει το ανοιχτό αρχείο κατακερματισμού
+fileName, με επικεφαλίδα header_info, με buckets κάδους και τις επιλογές options
+(π.χ. άλλη συνάρτηση κατακερματισμού ή άλλο κλειδί). Οι εγγραφές διαβάζονται μέσω του
+header_info και το νέο αρχείο γράφεται δίπλα στο παλιό με την HT_BulkLoad, με
+τις αλυσίδες κάθε κάδου σε συνεχόμενα blocks. Στο τέλος αντικαθιστά το παλιό
+ατομικά (rename). Όσοι έχουν ήδη ανοίξει το αρχείο, όπως και το header_info,
+συνεχίζουν να διαβάζουν το παλιό μέχρι να το κλείσουν και να το ανοίξουν ξανά,
+ενώ εισαγωγές σε αυτό δεν περνάνε στο νέο. Οι αριθμοί των blocks αλλάζουν, άρα
+τα δευτερεύοντα ευρετήρια του αρχείου πρέπει να ξαναχτιστούν με την
+SHT_Reorganize. Σε επιτυχία επιστρέφεται 0, αλλιώς -1 και το αρχείο μένει ως είχε.*/
+int HT_Reorganize(HT_info* header_info, /*επικεφαλίδα του αρχείου*/
+	char* fileName, /*όνομα αρχείου*/
+	int buckets, /*νέος αριθμός από buckets*/
+	HT_options options /*επιλογές του νέου αρχείου*/);
+
+/*Η συνάρτηση HT_RegisterIndex καταχωρεί στην επικεφαλίδα του αρχείου το
+δευτερεύον ευρετήριο με όνομα αρχείου indexName, ώστε να ανοίγει και να
+ενημερώνεται μαζί με το αρχείο (SHT_OpenFiles). Η επικεφαλίδα γράφεται στο
+HT_CloseFile. Επιστρέφει 0, ή -1 αν το όνομα δεν χωράει σε HT_INDEX_NAME_SIZE
+bytes ή δεν υπάρχει μνήμη. Ένα όνομα που υπάρχει ήδη δεν καταχωρείται ξανά.*/
+int HT_RegisterIndex(HT_info* header_info, /*επικεφαλίδα του αρχείου*/
+	const char* indexName /*όνομα αρχείου του ευρετηρίου*/);
+
+/*Η συνάρτηση HT_UnregisterIndex αφαιρεί το ευρετήριο indexName από την
+επικεφαλίδα του αρχείου. Επιστρέφει 1 αν ήταν καταχωρημένο, αλλιώς 0.*/
+int HT_UnregisterIndex(HT_info* header_info, /*επικεφαλίδα του αρχείου*/
+	const char* indexName /*όνομα αρχείου του ευρετηρίου*/);
+
+/*Η συνάρτηση HT_BlockRecord διαβάζει την i-οστή εγγραφή (0 <= i < currentRecords)
+του block κάδου με δεδομένα blockData, σύμφωνα με τη μορφή εγγραφών του αρχείου,
+και την επιστρέφει στο record. Επιστρέφει 0, ή -1 αν η θέση i είναι άδεια.*/
+int HT_BlockRecord(HT_info* header_info, char* blockData, int i, Record* record);
+
 int HashStatistics (char* filename);
 
 #endif // HT_FILE_H
@@ -0,0 +1,50 @@
+#ifndef LATCH_H
+#define LATCH_H
+#include "bf.h"
+
+/* Μάνδαλα (latches) για ταυτόχρονες εισαγωγές από πολλά νήματα σε ένα ανοιχτό
+αρχείο κατακερματισμού. Κάθε ανοιχτό αρχείο έχει έναν πίνακα LATCH_STRIPES
+μανδάλων και ο κάδος b προστατεύεται από το μάνδαλο b % LATCH_STRIPES (lock
+striping), οπότε εισαγωγές σε διαφορετικούς κάδους προχωρούν παράλληλα.
+Ένα μάνδαλο αρχείου προστατεύει την κατάσταση που μοιράζονται όλοι οι κάδοι
+(λίστα ελεύθερων blocks, λεξικό). Το επίπεδο BF δεν είναι ασφαλές για νήματα,
+γι' αυτό οι κλήσεις του από τα νήματα περνούν από ένα κοινό μάνδαλο για όλη τη
+διεργασία, το οποίο κρατιέται μόνο όσο διαρκεί η κλήση. Τα δεδομένα ενός
+καρφιτσωμένου (pinned) block δεν μετακινούνται, οπότε διαβάζονται και γράφονται
+έξω από αυτό, υπό το μάνδαλο του κάδου τους.
+
+Η σειρά απόκτησης είναι πάντα: κάδος, αρχείο, BF. */
+
+// Latches per file, a power of 2 so that a bucket picks its stripe with a mask
+#define LATCH_STRIPES 64
+
+typedef struct Latch_Table Latch_Table;
+
+// Reads and installs the head of a bucket in an in-memory directory, so that a reader never sees a torn value
+#define LATCH_LOAD(location) __atomic_load_n(&(location), __ATOMIC_ACQUIRE)
+#define LATCH_STORE(location, value) __atomic_store_n(&(location), (value), __ATOMIC_RELEASE)
+
+/*Η συνάρτηση LATCH_Create δημιουργεί τον πίνακα μανδάλων ενός ανοιχτού αρχείου.
+Επιστρέφει NULL σε περίπτωση λάθους.*/
+Latch_Table* LATCH_Create(void);
+
+// Η συνάρτηση LATCH_Destroy αποδεσμεύει τον πίνακα latches, κανένα νήμα δεν πρέπει να τον κρατάει
+void LATCH_Destroy(Latch_Table* latches);
+
+// Οι συναρτήσεις LATCH_LockBucket και LATCH_UnlockBucket κλειδώνουν και ξεκλειδώνουν τον κάδο bucket
+void LATCH_LockBucket(Latch_Table* latches, int bucket);
+void LATCH_UnlockBucket(Latch_Table* latches, int bucket);
+
+// Οι συναρτήσεις LATCH_LockFile και LATCH_UnlockFile κλειδώνουν και ξεκλειδώνουν την κοινή κατάσταση του αρχείου
+void LATCH_LockFile(Latch_Table* latches);
+void LATCH_UnlockFile(Latch_Table* latches);
+
+/* Οι παρακάτω συναρτήσεις καλούν τις αντίστοιχες του επιπέδου BF υπό το κοινό
+μάνδαλο. Η LATCH_AllocateBlock επιστρέφει επιπλέον στο *blockId τον αριθμό του
+block που δεσμεύτηκε, χωρίς να μπορεί να παρεμβληθεί δέσμευση άλλου νήματος.*/
+BF_ErrorCode LATCH_GetBlock(int fileDesc, int blockId, BF_Block* block);
+BF_ErrorCode LATCH_AllocateBlock(int fileDesc, BF_Block* block, int* blockId);
+BF_ErrorCode LATCH_UnpinBlock(BF_Block* block);
+void LATCH_SetDirty(BF_Block* block);
+
+#endif // LATCH_H
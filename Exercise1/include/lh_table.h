@@ -0,0 +1,59 @@
+#ifndef LH_TABLE_H
+#define LH_TABLE_H
+#include <record.h>
+#include <stdbool.h>
+#include "bf.h"
+#include "ht_table.h"
+
+/* Η δομή LH_info κρατάει μεταδεδομένα που σχετίζονται με το αρχείο γραμμικού
+κατακερματισμού (linear hashing). Οι κάδοι είναι αλυσίδες από blocks με την
+ίδια μορφή (HT_block_info) και την ίδια αντίστροφη αλυσίδωση με το αρχείο HT.
+Όταν ο συντελεστής πλήρωσης ξεπεράσει το maxLoad, διασπάται ένας μόνο κάδος,
+αυτός στον οποίο δείχνει ο δείκτης διάσπασης next, με κυκλική σειρά. */
+typedef struct {
+    int fileDesc;
+    bool isHeapFile;
+    bool isHashFile;
+    int recordsPerBlock;
+    int initialBuckets;     // N0, buckets at creation time
+    int level;              // Completed rounds of splits, a round doubles N0 * 2^level
+    int next;               // Split pointer, the next bucket to be split in this round
+    int numBuckets;         // N0 * 2^level + next
+    int records;            // Records in the file, for the load factor
+    int maxLoad;            // Split when records exceed maxLoad% of the bucket capacity
+    int directoryBlock;     // First block of the chain that stores hashTable
+    int capacity;           // Allocated entries of hashTable
+    int* hashTable;         // Head block of every bucket, valid only while the file is open
+} LH_info;
+
+/*Η συνάρτηση LH_CreateFile δημιουργεί ένα άδειο αρχείο γραμμικού κατακερματισμού
+με όνομα fileName και buckets αρχικούς κάδους. Ο κάδος next διασπάται όταν οι εγγραφές
+ξεπεράσουν το maxLoad τοις εκατό της χωρητικότητας των κάδων. Σε περίπτωση που
+εκτελεστεί επιτυχώς, επιστρέφεται 0, ενώ σε διαφορετική περίπτωση -1.*/
+int LH_CreateFile(
+    char *fileName,     /*όνομα αρχείου*/
+    int buckets,        /*αρχικός αριθμός από buckets*/
+    int maxLoad         /*μέγιστος συντελεστής πλήρωσης (%)*/);
+
+/*Η συνάρτηση LH_OpenFile ανοίγει το αρχείο με όνομα fileName και φορτώνει στη
+μνήμη τον πίνακα των κάδων. Σε περίπτωση σφάλματος επιστρέφεται NULL.*/
+LH_info* LH_OpenFile(char *fileName /*όνομα αρχείου*/);
+
+/*Η συνάρτηση LH_CloseFile γράφει τον πίνακα των κάδων και την επικεφαλίδα στο
+αρχείο και το κλείνει, αποδεσμεύοντας τη μνήμη της header_info. Σε περίπτωση
+που εκτελεστεί επιτυχώς, επιστρέφεται 0, αλλιώς -1.*/
+int LH_CloseFile(LH_info* header_info);
+
+/*Η συνάρτηση LH_InsertEntry εισάγει την εγγραφή record στο αρχείο και, αν
+ξεπεραστεί ο συντελεστής πλήρωσης, διασπά τον κάδο next. Επιστρέφεται ο αριθμός
+του block στο οποίο έγινε η εισαγωγή, ενώ σε διαφορετική περίπτωση -1. Μια
+μεταγενέστερη διάσπαση μπορεί να μετακινήσει την εγγραφή σε άλλο block.*/
+int LH_InsertEntry(LH_info* header_info, Record record);
+
+/*Η συνάρτηση LH_GetAllEntries εκτυπώνει όλες τις εγγραφές με id ίσο με value
+και επιστρέφει το πλήθος των blocks που διαβάστηκαν, ή -1 σε περίπτωση λάθους.*/
+int LH_GetAllEntries(LH_info* header_info, int* value);
+
+int HashStatisticsLH(char* filename);
+
+#endif // LH_TABLE_H
@@ -0,0 +1,116 @@
+#ifndef LSM_TREE_H
+#define LSM_TREE_H
+#include <record.h>
+#include <stdbool.h>
+
+/* Αρχείο δομημένο ως log-structured merge tree, με κλειδί το id, για φορτία με
+πολλές εισαγωγές. Οι εισαγωγές, οι αλλαγές και οι διαγραφές γράφονται πρώτα σε
+έναν ταξινομημένο πίνακα στη μνήμη (memtable, μια skip list). Όταν γεμίσει,
+γράφεται σειριακά σε ένα αμετάβλητο ταξινομημένο run, ένα δικό του αρχείο BF,
+με τον πρώτο id κάθε block (fence pointers) και ένα φίλτρο Bloom, που φορτώνονται
+στη μνήμη, ώστε μια αναζήτηση να διαβάζει το πολύ ένα block ανά run.
+
+	memtable (skip list)		level 0: έως level0Runs runs που επικαλύπτονται
+			|	flush
+			˅
+	| run | run | run |  ----> level 1: ένα run, sizeRatio φορές μεγαλύτερο
+								  ----> level 2: ένα run, ...
+
+Τα runs του level 0 συγχωνεύονται με το run του level 1 όταν γίνουν level0Runs, και
+ένα level που ξεπερνά το μέγεθός του συγχωνεύεται με το επόμενο (leveled compaction).
+Η νεότερη εκδοχή ενός id κρύβει τις παλαιότερες, και μια διαγραφή κρατιέται ως
+σημάδι (tombstone) μέχρι να φτάσει στο τελευταίο level. Το αρχείο fileName κρατάει
+την περιγραφή των runs (manifest), και το run i βρίσκεται στο αρχείο fileName.i. */
+
+// Runs that can exist at once, level 0 included
+#define LSM_MAX_RUNS 48
+
+// Επιλογές δημιουργίας ενός αρχείου LSM. Τα πεδία που δεν ορίζονται (μηδενικά) παίρνουν τις προκαθορισμένες τιμές.
+typedef struct {
+    int memtableRecords;    // Records the memtable holds before it is flushed to a run, 4096 if 0
+    int level0Runs;         // Runs level 0 gathers before they are merged into level 1, 4 if 0
+    int sizeRatio;          // Every level holds this many times the records of the one above it, 10 if 0
+    int bloomBitsPerKey;    // Bloom filter bits per record of a run, 10 if 0
+} LSM_options;
+
+// What is kept about a sorted run, in block 0 of its file and in the manifest
+typedef struct {
+    int id;                 // The run is stored in the file <fileName>.<id>
+    int level;
+    long int records;       // Records of the run, deletions included
+    int dataBlocks;         // Blocks 1 .. dataBlocks hold the records in id order
+    int minKey;
+    int maxKey;
+    int fenceBlock;         // First block of the chain with the first id of every data block
+    int filterBlock;        // First block of the chain with the Bloom filter of the run
+    int filterBytes;
+} LSM_run_info;
+
+typedef struct LSM_run LSM_run;
+typedef struct LSM_memtable LSM_memtable;
+
+typedef struct {
+    int fileDesc;
+    bool isHeapFile;
+    bool isHashFile;
+    bool isLsmFile;
+    LSM_options options;
+    int nextRun;            // Id of the next run to be written
+    int runCount;
+    int runsBlock;          // First block of the chain with the LSM_run_info of every run
+    long int flushes;
+    long int compactions;
+    long int blocksWritten; // Blocks of every run written so far, flushes and compactions
+    char* fileName;         // Valid only while the file is open
+    LSM_run* runs;          // Level 0 newest first, then one run per level, valid only while the file is open
+    LSM_memtable* memtable; // Valid only while the file is open
+} LSM_info;
+
+// Η δομή LSM_block_info βρίσκεται στην αρχή κάθε block δεδομένων ενός run
+typedef struct {
+    int count;              // Records of the block
+    unsigned int deleted;   // Bit i is set if record i marks a deletion
+} LSM_block_info;
+
+/*Η συνάρτηση LSM_CreateFile δημιουργεί ένα άδειο αρχείο LSM με όνομα fileName και
+επιλογές options. Σε περίπτωση που εκτελεστεί επιτυχώς, επιστρέφεται 0, ενώ σε
+διαφορετική περίπτωση -1.*/
+int LSM_CreateFile(
+    char *fileName,     /*όνομα αρχείου*/
+    LSM_options options /*επιλογές του αρχείου*/);
+
+/*Η συνάρτηση LSM_OpenFile ανοίγει το αρχείο με όνομα fileName και όλα τα runs του,
+φορτώνοντας στη μνήμη τους fence pointers και τα φίλτρα τους. Σε περίπτωση
+σφάλματος, ή αν το αρχείο δεν είναι αρχείο LSM, επιστρέφεται NULL.*/
+LSM_info* LSM_OpenFile(char *fileName /*όνομα αρχείου*/);
+
+/*Η συνάρτηση LSM_CloseFile γράφει το memtable σε ένα run, κλείνει τα runs και το
+αρχείο και αποδεσμεύει τη μνήμη της header_info. Σε περίπτωση που εκτελεστεί
+επιτυχώς, επιστρέφεται 0, αλλιώς -1.*/
+int LSM_CloseFile(LSM_info* header_info);
+
+/*Η συνάρτηση LSM_InsertEntry εισάγει την εγγραφή record στο memtable, αντικαθιστώντας
+όποια εγγραφή υπάρχει ήδη με το ίδιο id. Όταν το memtable γεμίσει, γράφεται σε run
+και γίνονται όσες συγχωνεύσεις χρειάζονται. Σε επιτυχία επιστρέφεται 0, αλλιώς -1.*/
+int LSM_InsertEntry(LSM_info* header_info, Record record);
+
+/*Η συνάρτηση LSM_DeleteEntry διαγράφει την εγγραφή με id ίσο με value, γράφοντας
+ένα σημάδι διαγραφής στο memtable. Σε επιτυχία επιστρέφεται 0, αλλιώς -1.*/
+int LSM_DeleteEntry(LSM_info* header_info, int value);
+
+/*Η συνάρτηση LSM_GetEntry αναζητά την τρέχουσα εγγραφή με id ίσο με value, από το
+memtable προς τα παλαιότερα runs, και την επιστρέφει στο record. Επιστρέφει 1 αν
+βρέθηκε, 0 αν δεν υπάρχει (ή έχει διαγραφεί), ή -1 σε περίπτωση λάθους.*/
+int LSM_GetEntry(LSM_info* header_info, int value, Record* record);
+
+/*Η συνάρτηση LSM_GetAllEntries εκτυπώνει την τρέχουσα εγγραφή με id ίσο με value, αν
+υπάρχει, και επιστρέφει το πλήθος των blocks που διαβάστηκαν, ή -1 σε περίπτωση λάθους.*/
+int LSM_GetAllEntries(LSM_info* header_info, int* value);
+
+/*Η συνάρτηση LSM_Flush γράφει αμέσως το memtable σε ένα run του level 0 και κάνει
+όσες συγχωνεύσεις χρειάζονται. Σε επιτυχία επιστρέφεται 0, αλλιώς -1.*/
+int LSM_Flush(LSM_info* header_info);
+
+int StatisticsLSM(char* filename);
+
+#endif // LSM_TREE_H
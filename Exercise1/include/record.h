@@ -19,8 +19,78 @@ typedef struct Record {
 	char city[20];
 } Record;
 
+/* Ο τρόπος με τον οποίο αποθηκεύονται οι εγγραφές μέσα σε ένα block.
+FIXED_FORMAT: η δομή Record αυτούσια (76 bytes).
+ENCODED_FORMAT: το id και ένας κωδικός λεξικού για τα name, surname, city.
+SLOTTED_FORMAT: εγγραφές μεταβλητού μήκους σε σελίδα με υποδοχές (slotted_page.h). */
+typedef enum Record_Format {
+  FIXED_FORMAT,
+  ENCODED_FORMAT,
+  SLOTTED_FORMAT
+} Record_Format;
+
+// Max distinct values per attribute, so that a code fits in one byte
+#define DICTIONARY_SIZE 255
+
+// Per-file dictionary of the values seen for name, surname and city
+typedef struct {
+  int names;
+  int surnames;
+  int cities;
+  char name[DICTIONARY_SIZE][15];
+  char surname[DICTIONARY_SIZE][20];
+  char city[DICTIONARY_SIZE][20];
+} Record_Dictionary;
+
+// The on-disk form of a record in ENCODED_FORMAT (the "record" tag is implied)
+typedef struct {
+  int id;
+  unsigned char name;
+  unsigned char surname;
+  unsigned char city;
+} EncodedRecord;
+
 Record randomRecord();
 
 void printRecord(Record record);
 
+/* Επιστρέφει το μέγεθος σε bytes που καταλαμβάνει μια εγγραφή στο δίσκο
+για τη μορφή format (για το SLOTTED_FORMAT, το μέγιστο δυνατό). */
+int recordSize(Record_Format format);
+
+/* Η συνάρτηση encodeRecord μετατρέπει την εγγραφή record σε κωδικοποιημένη
+μορφή, προσθέτοντας στο λεξικό dictionary όσες τιμές δεν υπάρχουν ήδη.
+Επιστρέφει 0 σε επιτυχία, ή -1 αν το λεξικό κάποιου πεδίου έχει γεμίσει.*/
+int encodeRecord(Record_Dictionary* dictionary, Record record, EncodedRecord* encoded);
+
+/* Η συνάρτηση decodeRecord ανακατασκευάζει την εγγραφή από την κωδικοποιημένη
+μορφή της, με βάση το λεξικό dictionary.*/
+Record decodeRecord(Record_Dictionary* dictionary, EncodedRecord encoded);
+
+/* Η συνάρτηση serializeRecord γράφει την εγγραφή record στη θέση dest σε
+μορφή μεταβλητού μήκους (το id και κάθε συμβολοσειρά με ένα byte μήκους
+μπροστά της) και επιστρέφει πόσα bytes γράφτηκαν.*/
+int serializeRecord(Record record, char* dest);
+
+/* Η συνάρτηση deserializeRecord διαβάζει μια εγγραφή που γράφτηκε με την
+serializeRecord.*/
+Record deserializeRecord(char* src);
+
+/* Η συνάρτηση storeRecord γράφει την εγγραφή record στη θέση dest, στη μορφή
+format. Χωράνε πάντα σε recordSize(format) bytes. Επιστρέφει πόσα bytes
+γράφτηκαν, ή -1 αν η εγγραφή δεν μπορεί να κωδικοποιηθεί.*/
+int storeRecord(Record_Format format, Record_Dictionary* dictionary, Record record, char* dest);
+
+/* Η συνάρτηση loadRecord διαβάζει την εγγραφή που είναι αποθηκευμένη στη θέση
+src, στη μορφή format.*/
+Record loadRecord(Record_Format format, Record_Dictionary* dictionary, char* src);
+
+/* Η συνάρτηση serializeDictionary γράφει το λεξικό σε ένα συνεχόμενο buffer
+(που δεσμεύεται με malloc) και επιστρέφει το μέγεθός του στο size.*/
+char* serializeDictionary(Record_Dictionary* dictionary, int* size);
+
+/* Η συνάρτηση deserializeDictionary διαβάζει το λεξικό από ένα buffer που
+δημιουργήθηκε από την serializeDictionary.*/
+void deserializeDictionary(Record_Dictionary* dictionary, char* data, int size);
+
 #endif
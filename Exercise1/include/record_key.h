@@ -0,0 +1,34 @@
+#ifndef RECORD_KEY_H
+#define RECORD_KEY_H
+#include <stdbool.h>
+#include "record.h"
+#include "hash_function.h"
+
+/* Το κλειδί ενός αρχείου κατακερματισμού: ένα σύνολο από πεδία της εγγραφής
+(Record_Attribute), ως μάσκα από bits. Ένα κλειδί με περισσότερα από ένα πεδία
+είναι σύνθετο, π.χ. RECORD_KEY(NAME) | RECORD_KEY(SURNAME). */
+typedef unsigned int Record_Key;
+
+#define RECORD_KEY(attribute) (1u << (attribute))
+
+// Every combination of the four attributes, 0 is not a key
+#define RECORD_KEYS 16
+
+/* Οι λειτουργίες ενός κλειδιού, ειδικευμένες κατά τη μεταγλώττιση για κάθε
+συνδυασμό πεδίων, ώστε η αναζήτηση να μην εξετάζει το κλειδί για κάθε εγγραφή.
+hash: η τιμή κατακερματισμού των πεδίων του κλειδιού της εγγραφής record.
+equals: αν οι εγγραφές a και b έχουν τις ίδιες τιμές στα πεδία του κλειδιού. */
+typedef struct {
+  unsigned int (*hash)(Hash_Function function, const Record* record);
+  bool (*equals)(const Record* a, const Record* b);
+} Key_Operations;
+
+/* Η συνάρτηση RK_Operations επιστρέφει τις λειτουργίες του κλειδιού key, ή NULL
+αν το key δεν είναι έγκυρο κλειδί. Για κλειδί μόνο το id, η τιμή κατακερματισμού
+είναι η HF_HashInt του id και για ένα πεδίο συμβολοσειρά η HF_HashString του.*/
+const Key_Operations* RK_Operations(Record_Key key);
+
+/* Η συνάρτηση RK_Print τυπώνει τις τιμές των πεδίων του κλειδιού key της εγγραφής record.*/
+void RK_Print(Record_Key key, const Record* record);
+
+#endif // RECORD_KEY_H
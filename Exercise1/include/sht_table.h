@@ -2,8 +2,8 @@
 #define SHT_TABLE_H
 #include <record.h>
 #include <ht_table.h>
-
-#define MAX_BUCKETS 30
+#include "entry_set.h"
+#include "record_key.h"
 
 typedef struct {
     // Να το συμπληρώσετε
@@ -12,9 +12,60 @@ typedef struct {
     bool isHeapFile;
     bool isHashFile;
     int recordsPerBlock;
-    int hashTable[MAX_BUCKETS];
+    Record_Format format;   // How entries are laid out inside the blocks (FIXED or SLOTTED)
+    Record_Attribute attribute; // The indexed field, NAME, SURNAME or CITY
+    Hash_Function hashFunction; // Maps a value of the attribute to its bucket, fixed at creation
+    int filterBytes;        // Bytes of the Bloom filter of every bucket, 0 if there are none
+    int filterBlock;        // First of the consecutive filter blocks (bloom_filter.h)
+    int tagBytes;           // Fingerprint bytes ahead of the entries of every block, 0 if none
+    bool postings;          // The chains hold one entry per name, with a posting list of its blocks
+    bool rids;              // Entries point to records (HT_RID) instead of primary blocks
+    Record_Key include;     // Columns stored in every entry besides the attribute, 0 if none
+    int directoryBlock;     // First block of the chain that stores hashTable
+    int* hashTable;         // Head block of every bucket, valid only while the index is open
+    Latch_Table* latches;   // Bucket latches (latch.h), valid only while the index is open
+    Entry_Set** entrySets;  // <name, blockId> pairs of every latch stripe, loaded by its first insert, valid only while the index is open
 } SHT_info;
 
+// Επιλογές δημιουργίας ενός δευτερεύοντος ευρετηρίου. Τα πεδία που δεν
+// ορίζονται (μηδενικά) αντιστοιχούν στη συμπεριφορά της SHT_CreateSecondaryIndex.
+typedef struct {
+    Record_Key key;     // RECORD_KEY of the indexed field, NAME, SURNAME or CITY (0 is NAME)
+    Record_Format format;
+    Hash_Function hash;
+    int filterBytes;    // Bloom filter bytes per bucket, at most BF_BLOCK_SIZE
+    bool fingerprints;  // One byte fingerprint per entry in every block (FIXED format)
+    bool postings;      // Every name once per bucket with a compressed list of its blocks (FIXED format, no fingerprints)
+    bool rids;          // Entries hold the rid of every record instead of its block
+    Record_Key include; // Columns (RECORD_KEY of ID, NAME, SURNAME, CITY) stored in every entry, needs rids, no postings
+} SHT_options;
+
+/* Με rids, κάθε καταχώρηση δείχνει μία εγγραφή του πρωτεύοντος αρχείου, με τον
+αριθμό του block και τη θέση της μέσα σε αυτό (HT_RID), και όχι ένα ολόκληρο block.
+Η αναζήτηση διαβάζει κατευθείαν τη θέση κάθε εγγραφής, χωρίς να συγκρίνει τα
+ονόματα όλων των εγγραφών του block. Όταν μια εγγραφή αλλάζει θέση (HT_DeleteEntry,
+HT_UpdateEntry), ο καλών ενημερώνει το ευρετήριο με το παλιό rid στη
+SHT_SecondaryDeleteEntry και το νέο στη SHT_SecondaryInsertEntry, όπως τα δίνουν οι
+callbacks. Μετά από μια HT_Reorganize το ευρετήριο ξαναχτίζεται με τη SHT_Reorganize.*/
+
+/* Με posting lists, η αλυσίδα κάθε κάδου κρατάει μία καταχώρηση ανά όνομα, με το
+πλήθος των blocks του πρωτεύοντος αρχείου που το έχουν και το νεότερο block της
+λίστας τους. Τα blocks της λίστας κρατάνε τις διαφορές κάθε αριθμού block από τον
+προηγούμενο, ως zigzag varints (7 bits ανά byte), ώστε ένα όνομα με χιλιάδες
+blocks να χωράει σε λίγα blocks του ευρετηρίου.
+
+	 bucket chain			 posting chain of "Giorgos"
+	__________________		______________________		______________________
+	| "Giorgos" | n | ---->	| +12 +1 +3 -7 ...	| ---->	| 4 +2 +9 ...			| ----> -1
+	| "Yannis"  | m | ...	|___________________|		|___________________|
+	|_________________|
+*/
+typedef struct {
+    int nextBlock;      // Older block of the posting list, -1 for the first one
+    int bytes;          // Bytes of varints after the header
+    int last;           // Last block number encoded in this block, the base of the next difference
+} SHT_posting_info;
+
 typedef struct {
     int recordsCount;   // Max ammount it can hold
     int currentRecords; // How many it currently holds
@@ -27,14 +78,33 @@ int HashStatisticsSHT(char* filename);
 
 /*Η συνάρτηση SHT_CreateSecondaryIndex χρησιμοποιείται για τη δημιουργία
 και κατάλληλη αρχικοποίηση ενός αρχείου δευτερεύοντος κατακερματισμού με
-όνομα sfileName για το αρχείο πρωτεύοντος κατακερματισμού fileName. Σε
-περίπτωση που εκτελεστεί επιτυχώς, επιστρέφεται 0, ενώ σε διαφορετική
-περίπτωση -1.*/
+όνομα sfileName για το αρχείο πρωτεύοντος κατακερματισμού fileName. Το
+ευρετήριο χτίζεται από τις εγγραφές που έχει ήδη το fileName: νήματα διαβάζουν
+παράλληλα τους κάδους του, οι καταχωρήσεις μοιράζονται στους κάδους του
+ευρετηρίου και κάθε αλυσίδα γράφεται μία φορά, σε συνεχόμενα blocks. Το ευρετήριο
+καταγράφεται στην επικεφαλίδα του fileName (HT_RegisterIndex), ώστε να το ανοίγει η
+SHT_OpenFiles. Το fileName δεν πρέπει να είναι ανοιχτό, για ένα ανοιχτό αρχείο
+υπάρχει η SHT_Reorganize. Με fileName NULL το ευρετήριο μένει άδειο. Σε περίπτωση που εκτελεστεί επιτυχώς,
+επιστρέφεται 0, ενώ σε διαφορετική περίπτωση -1.*/
 int SHT_CreateSecondaryIndex(
     char *sfileName, /* όνομα αρχείου δευτερεύοντος ευρετηρίου*/
     int buckets, /* αριθμός κάδων κατακερματισμού*/
     char* fileName /* όνομα αρχείου πρωτεύοντος ευρετηρίου*/);
 
+/*Η συνάρτηση SHT_CreateSecondaryIndexWithOptions λειτουργεί όπως η
+SHT_CreateSecondaryIndex, αλλά δέχεται επιπλέον τις επιλογές options του
+ευρετηρίου. Με key το ευρετήριο είναι στο surname ή στο city αντί για το name, και
+όπου οι παρακάτω συναρτήσεις αναφέρουν όνομα εννοείται η τιμή αυτού του πεδίου.
+Το ENCODED_FORMAT δεν υποστηρίζεται για ευρετήρια. Με include, κάθε
+καταχώρηση κρατάει και τα πεδία αυτά της εγγραφής της, ώστε οι αναζητήσεις που
+χρειάζονται μόνο αυτά να απαντώνται από το ευρετήριο (SHT_SecondaryGetCovered).
+Σε περίπτωση που εκτελεστεί επιτυχώς, επιστρέφεται 0, ενώ σε διαφορετική περίπτωση -1.*/
+int SHT_CreateSecondaryIndexWithOptions(
+    char *sfileName, /* όνομα αρχείου δευτερεύοντος ευρετηρίου*/
+    int buckets, /* αριθμός κάδων κατακερματισμού*/
+    char* fileName, /* όνομα αρχείου πρωτεύοντος ευρετηρίου*/
+    SHT_options options /* επιλογές του ευρετηρίου*/);
+
 
 
 /* Η συνάρτηση SHT_OpenSecondaryIndex ανοίγει το αρχείο με όνομα sfileName
@@ -55,11 +125,49 @@ int SHT_CloseSecondaryIndex( SHT_info* header_info );
 βρίσκονται στη δομή header_info, ενώ η εγγραφή προς εισαγωγή προσδιορίζεται
 από τη δομή record και το block του πρωτεύοντος ευρετηρίου που υπάρχει η εγγραφή
 προς εισαγωγή. Σε περίπτωση που εκτελεστεί επιτυχώς, επιστρέφεται 0, ενώ σε
-διαφορετική περίπτωση -1.*/
+διαφορετική περίπτωση -1. Όπως η HT_InsertEntry, μπορεί να καλείται ταυτόχρονα
+από πολλά νήματα, κλειδώνοντας μόνο τον κάδο του ονόματος.*/
 int SHT_SecondaryInsertEntry(
     SHT_info* header_info, /* επικεφαλίδα του δευτερεύοντος ευρετηρίου*/
     Record record, /* η εγγραφή για την οποία έχουμε εισαγωγή στο δευτερεύον ευρετήριο*/
-    int block_id /* το μπλοκ του αρχείου κατακερματισμού στο οποίο έγινε η εισαγωγή */);
+    int block_id /* το μπλοκ του αρχείου κατακερματισμού στο οποίο έγινε η εισαγωγή, ή το rid της με rids */);
+
+/*Η συνάρτηση SHT_SecondaryInsertEntries λειτουργεί όπως n κλήσεις της
+SHT_SecondaryInsertEntry, για την εγγραφή records[i] στο block_ids[i]. Κάθε τιμή
+κατακερματίζεται μία φορά, οι καταχωρήσεις ομαδοποιούνται ανά κάδο και κάθε κάδος
+κλειδώνεται μία φορά, με την κεφαλή του δεσμευμένη για όλες τις καταχωρήσεις του.
+Σε περίπτωση που εκτελεστεί επιτυχώς, επιστρέφεται 0, ενώ σε διαφορετική περίπτωση -1.*/
+int SHT_SecondaryInsertEntries(
+    SHT_info* header_info, /* επικεφαλίδα του δευτερεύοντος ευρετηρίου*/
+    Record* records, /* οι εγγραφές που εισήχθησαν στο πρωτεύον αρχείο*/
+    const int* block_ids, /* το μπλοκ (ή το rid) κάθε εγγραφής*/
+    size_t n /* το πλήθος τους*/);
+
+/*Η συνάρτηση SHT_SecondaryDeleteEntry ενημερώνει το ευρετήριο για τη διαγραφή ή
+την αλλαγή της εγγραφής record από το block block_id του πρωτεύοντος αρχείου
+ht_info, που έχει ήδη γίνει. Η καταχώρηση <name, block_id> αφαιρείται, εκτός αν
+το block έχει ακόμα άλλη εγγραφή με το ίδιο όνομα. Με rids, το block_id είναι το
+rid της εγγραφής και η καταχώρησή της αφαιρείται χωρίς να διαβαστεί το πρωτεύον
+αρχείο. Σε περίπτωση που εκτελεστεί
+επιτυχώς, επιστρέφεται 0, ενώ σε διαφορετική περίπτωση -1.*/
+int SHT_SecondaryDeleteEntry(
+    HT_info* ht_info, /* επικεφαλίδα του αρχείου πρωτεύοντος ευρετηρίου*/
+    SHT_info* header_info, /* επικεφαλίδα του δευτερεύοντος ευρετηρίου*/
+    Record record, /* η εγγραφή που διαγράφηκε ή άλλαξε*/
+    int block_id /* το μπλοκ του πρωτεύοντος ευρετηρίου που την είχε*/);
+
+/*Η συνάρτηση SHT_Reorganize ξαναχτίζει το δευτερεύον ευρετήριο sfileName του
+ανοιχτού αρχείου πρωτεύοντος κατακερματισμού με επικεφαλίδα ht_info, με buckets
+κάδους και τις επιλογές options. Οι καταχωρήσεις διαβάζονται από το πρωτεύον
+αρχείο, άρα η συνάρτηση χρησιμοποιείται και μετά από μια HT_Reorganize, με το
+νέο αρχείο ανοιχτό. Το νέο ευρετήριο γράφεται δίπλα στο παλιό, με τις αλυσίδες
+κάθε κάδου σε συνεχόμενα blocks, και στο τέλος το αντικαθιστά ατομικά (rename).
+Σε επιτυχία επιστρέφεται 0, αλλιώς -1 και το ευρετήριο μένει ως είχε.*/
+int SHT_Reorganize(
+    char *sfileName, /* όνομα αρχείου δευτερεύοντος ευρετηρίου*/
+    int buckets, /* νέος αριθμός κάδων κατακερματισμού*/
+    HT_info* ht_info, /* επικεφαλίδα του αρχείου πρωτεύοντος ευρετηρίου*/
+    SHT_options options /* επιλογές του νέου ευρετηρίου*/);
 
 /*Η συνάρτηση αυτή χρησιμοποιείται για την εκτύπωση όλων των εγγραφών που
 υπάρχουν στο αρχείο κατακερματισμού οι οποίες έχουν τιμή στο πεδίο-κλειδί
@@ -69,12 +177,64 @@ int SHT_SecondaryInsertEntry(
 αυτές είχαν επιστραφεί από την SHT_OpenIndex. Για κάθε εγγραφή που υπάρχει
 στο αρχείο και έχει όνομα ίσο με value, εκτυπώνονται τα περιεχόμενά της
 (συμπεριλαμβανομένου και του πεδίου-κλειδιού). Να επιστρέφεται επίσης το
-πλήθος των blocks που διαβάστηκαν μέχρι να βρεθούν όλες οι εγγραφές. Σε
-περίπτωση λάθους επιστρέφει -1.*/
+πλήθος των blocks που διαβάστηκαν μέχρι να βρεθούν όλες οι εγγραφές. Τα blocks
+του πρωτεύοντος αρχείου συγκεντρώνονται πρώτα από το ευρετήριο και διαβάζονται
+μία φορά το καθένα, με αύξουσα σειρά. Με rids διαβάζεται μόνο η θέση κάθε
+εγγραφής. Σε περίπτωση λάθους επιστρέφει -1.*/
 int SHT_SecondaryGetAllEntries(
     HT_info* ht_info, /* επικεφαλίδα του αρχείου πρωτεύοντος ευρετηρίου*/
     SHT_info* header_info, /* επικεφαλίδα του αρχείου δευτερεύοντος ευρετηρίου*/
     char* name /* το όνομα στο οποίο γίνεται αναζήτηση */);
 
+// Καλείται από τη SHT_SecondaryGetCovered για κάθε εγγραφή, με μια εγγραφή record που έχει
+// μόνο το πεδίο του ευρετηρίου και τα πεδία που περιέχει, το rid της και τον δείκτη context.
+typedef void (*SHT_Callback)(Record* record, int rid, void* context);
+
+/*Η συνάρτηση SHT_SecondaryGetCovered απαντά μια αναζήτηση του ονόματος name μόνο από
+το ευρετήριο, χωρίς να διαβάσει το πρωτεύον αρχείο, όταν τα πεδία columns που
+χρειάζεται (RECORD_KEY) είναι όλα αποθηκευμένα στις καταχωρήσεις του
+(SHT_options.include). Για κάθε εγγραφή με αυτό το όνομα καλείται η callback.
+Επιστρέφει το πλήθος των blocks του ευρετηρίου που διαβάστηκαν, ή -1 σε περίπτωση
+λάθους ή αν κάποιο από τα πεδία δεν υπάρχει στο ευρετήριο.*/
+int SHT_SecondaryGetCovered(
+    SHT_info* header_info, /* επικεφαλίδα του αρχείου δευτερεύοντος ευρετηρίου*/
+    char* name, /* το όνομα στο οποίο γίνεται αναζήτηση */
+    Record_Key columns, /* τα πεδία που χρειάζεται η αναζήτηση */
+    SHT_Callback callback, /* καλείται για κάθε εγγραφή που βρέθηκε*/
+    void* context /* δείκτης του καλούντος για την callback*/);
+
+/* Ένα πρωτεύον αρχείο μαζί με όλα τα δευτερεύοντα ευρετήριά του, όπως είναι
+καταγεγραμμένα στην επικεφαλίδα του. Οι παρακάτω συναρτήσεις αλλάζουν το αρχείο και
+ενημερώνουν όλα τα ευρετήρια με μία κλήση, με το block ή το rid της κάθε εγγραφής
+ανάλογα με το ευρετήριο.*/
+typedef struct {
+    HT_info* info;          // The primary file
+    int indexCount;
+    SHT_info** indexes;     // One for every index registered in the primary header
+} SHT_files;
+
+/*Η συνάρτηση SHT_OpenFiles ανοίγει το αρχείο πρωτεύοντος κατακερματισμού fileName
+και όλα τα ευρετήρια που είναι καταγεγραμμένα σε αυτό. Επιστρέφει NULL αν κάποιο δεν ανοίξει.*/
+SHT_files* SHT_OpenFiles(char* fileName /* όνομα αρχείου πρωτεύοντος ευρετηρίου*/);
+
+/*Η συνάρτηση SHT_CloseFiles κλείνει το αρχείο και τα ευρετήριά του και αποδεσμεύει
+τη δομή files. Σε περίπτωση που εκτελεστεί επιτυχώς, επιστρέφεται 0, ενώ σε διαφορετική
+περίπτωση -1.*/
+int SHT_CloseFiles(SHT_files* files);
+
+/*Η συνάρτηση SHT_InsertEntries εισάγει τις n εγγραφές του πίνακα records στο
+πρωτεύον αρχείο και στη συνέχεια σε κάθε ευρετήριο με τη SHT_SecondaryInsertEntries.
+Σε περίπτωση που εκτελεστεί επιτυχώς, επιστρέφεται 0, ενώ σε διαφορετική περίπτωση -1.*/
+int SHT_InsertEntries(SHT_files* files, Record* records, size_t n);
+
+/*Η συνάρτηση SHT_DeleteEntry διαγράφει τις εγγραφές με id ίσο με id (HT_DeleteEntry)
+και ενημερώνει όλα τα ευρετήρια για όσες διαγράφηκαν ή μετακινήθηκαν. Επιστρέφει το
+πλήθος των εγγραφών που διαγράφηκαν, ή -1 σε περίπτωση λάθους.*/
+int SHT_DeleteEntry(SHT_files* files, int id);
+
+/*Η συνάρτηση SHT_UpdateEntry αντικαθιστά τις εγγραφές με id ίσο με id με την record
+(HT_UpdateEntry) και ενημερώνει όλα τα ευρετήρια. Επιστρέφει το πλήθος των εγγραφών
+που άλλαξαν, ή -1 σε περίπτωση λάθους.*/
+int SHT_UpdateEntry(SHT_files* files, int id, Record record);
 
 #endif // SHT_FILE_H
@@ -0,0 +1,56 @@
+#ifndef SLOTTED_PAGE_H
+#define SLOTTED_PAGE_H
+
+/* Σελίδα με υποδοχές (slotted page) για εγγραφές μεταβλητού μήκους.
+Η σελίδα είναι μια περιοχή μέσα σε ένα block (μετά ή πριν από τα
+μεταδεδομένα του block). Ο κατάλογος υποδοχών μεγαλώνει από την αρχή
+της περιοχής προς τα δεξιά, ενώ οι εγγραφές γράφονται από το τέλος
+της περιοχής προς τα αριστερά.
+
+	_________________________________________________________________________
+	|			|		|		|		|						|		|		|
+	| SP_header	|slot[0]|slot[1]|  ...	|	free space	->  <-	|tuple 1|tuple 0|
+	|___________|_______|_______|_______|_______________________|_______|_______|
+				 		 		  		^ freeStart				^ freeEnd
+*/
+typedef struct {
+    unsigned short size;        // Size of the whole page area in bytes
+    unsigned short slots;       // Entries in the slot directory (including empty ones)
+    unsigned short freeStart;   // First byte after the slot directory
+    unsigned short freeEnd;     // First byte of the tuple area
+    unsigned short fragmented;  // Bytes held by deleted tuples, reclaimed by compaction
+} SP_header;
+
+typedef struct {
+    unsigned short offset;      // Start of the tuple, from the start of the page
+    unsigned short length;      // Length of the tuple, 0 for an empty slot
+} SP_slot;
+
+/* Η συνάρτηση SP_Init αρχικοποιεί μια άδεια σελίδα μεγέθους size bytes
+στη θέση page.*/
+void SP_Init(char* page, int size);
+
+/* Η συνάρτηση SP_Insert γράφει την εγγραφή tuple μήκους length στη σελίδα,
+συμπυκνώνοντάς την αν χρειαστεί. Επιστρέφει τον αριθμό της υποδοχής στην
+οποία γράφτηκε, ή -1 αν η εγγραφή δεν χωράει.*/
+int SP_Insert(char* page, const char* tuple, int length);
+
+/* Η συνάρτηση SP_Get επιστρέφει δείκτη στην εγγραφή της υποδοχής slot και
+το μήκος της στο *length, ή NULL αν η υποδοχή είναι άδεια.*/
+char* SP_Get(char* page, int slot, int* length);
+
+/* Η συνάρτηση SP_Delete διαγράφει την εγγραφή της υποδοχής slot. Ο χώρος
+της ανακτάται στην επόμενη συμπύκνωση.*/
+void SP_Delete(char* page, int slot);
+
+/* Η συνάρτηση SP_Compact μετακινεί όλες τις εγγραφές στο τέλος της σελίδας,
+ώστε ο ελεύθερος χώρος να γίνει συνεχόμενος. Οι αριθμοί υποδοχών δεν αλλάζουν.*/
+void SP_Compact(char* page);
+
+/* Επιστρέφει το πλήθος των υποδοχών (μαζί με τις άδειες) της σελίδας.*/
+int SP_Slots(char* page);
+
+/* Επιστρέφει πόσα bytes εγγραφής χωράνε ακόμα στη σελίδα (μετά από συμπύκνωση).*/
+int SP_FreeSpace(char* page);
+
+#endif // SLOTTED_PAGE_H
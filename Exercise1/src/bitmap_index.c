@@ -0,0 +1,701 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "bf.h"
+#include "bitmap_index.h"
+#include "ht_table.h"
+#include "record.h"
+#include "block_chain.h"
+
+// 	/*
+// 	<bfileName>: block 0 BM_info, the chain of the BM_value of every value, and one chain per bitmap
+//
+// 	A bitmap in its chain: container count, then for every container its key, its count and
+// 	either count low halves (array) or BM_CHUNK_WORDS words (bitmap)
+// 	*/
+
+#define BM_CHUNK_BITS 16
+#define BM_CHUNK_WORDS ((1 << BM_CHUNK_BITS) / 64)
+#define BM_ARRAY_MAX 4096		// An array of more positions takes more bytes than the words
+
+// The positions of a bitmap that share their high 16 bits
+typedef struct {
+	unsigned short key;
+	int count;
+	int capacity;					// Slots of array
+	unsigned short* array;			// Sorted low halves, while count <= BM_ARRAY_MAX
+	unsigned long long* words;		// Otherwise one bit per position, array is NULL
+} BM_container;
+
+struct BM_Bitmap {
+	int slotBits;					// Of the primary file, bitmaps of different files do not combine
+	int count;
+	int capacity;
+	BM_container* containers;		// In key order
+	bool dirty;						// Changed since it was read from the index
+};
+
+typedef enum {
+	BM_AND,
+	BM_OR,
+	BM_ANDNOT
+} BM_operation;
+
+static BM_Bitmap* BM_BitmapCreate(int slotBits) {
+	BM_Bitmap* bitmap = calloc(1, sizeof(BM_Bitmap));
+	if (bitmap != NULL) bitmap->slotBits = slotBits;
+	return bitmap;
+}
+
+void BM_Free(BM_Bitmap* bitmap) {
+	if (bitmap == NULL) return;
+	for (int i = 0; i < bitmap->count; i++) {
+		free(bitmap->containers[i].array);
+		free(bitmap->containers[i].words);
+	}
+	free(bitmap->containers);
+	free(bitmap);
+}
+
+static unsigned int BM_Position(int slotBits, int rid) {
+	return (unsigned int) HT_RID_BLOCK(rid) << slotBits | HT_RID_SLOT(rid);
+}
+
+static int BM_Rid(int slotBits, unsigned int position) {
+	return HT_RID((int) (position >> slotBits), (int) (position & ((1u << slotBits) - 1)));
+}
+
+// The first container whose key is not smaller than key
+static int BM_Find(const BM_Bitmap* bitmap, unsigned short key) {
+	int low = 0, high = bitmap->count;
+	while (low < high) {
+		int middle = (low + high) / 2;
+		if (bitmap->containers[middle].key < key) low = middle + 1;
+		else high = middle;
+	}
+	return low;
+}
+
+// An empty container for key at index i, the containers after it move up
+static BM_container* BM_InsertContainer(BM_Bitmap* bitmap, int i, unsigned short key) {
+	if (bitmap->count == bitmap->capacity) {
+		int capacity = bitmap->capacity == 0 ? 4 : 2 * bitmap->capacity;
+		BM_container* containers = realloc(bitmap->containers, sizeof(BM_container) * capacity);
+		if (containers == NULL) return NULL;
+		bitmap->containers = containers;
+		bitmap->capacity = capacity;
+	}
+	memmove(&bitmap->containers[i + 1], &bitmap->containers[i], sizeof(BM_container) * (bitmap->count - i));
+	bitmap->count++;
+
+	BM_container* container = &bitmap->containers[i];
+	memset(container, 0, sizeof(BM_container));
+	container->key = key;
+	return container;
+}
+
+static void BM_RemoveContainer(BM_Bitmap* bitmap, int i) {
+	free(bitmap->containers[i].array);
+	free(bitmap->containers[i].words);
+	memmove(&bitmap->containers[i], &bitmap->containers[i + 1], sizeof(BM_container) * (bitmap->count - i - 1));
+	bitmap->count--;
+}
+
+// The first array slot whose low half is not smaller than low
+static int BM_FindLow(const BM_container* container, unsigned short low) {
+	int first = 0, last = container->count;
+	while (first < last) {
+		int middle = (first + last) / 2;
+		if (container->array[middle] < low) first = middle + 1;
+		else last = middle;
+	}
+	return first;
+}
+
+// The bits of the container, all 0 for a missing one
+static void BM_Expand(const BM_container* container, unsigned long long* words) {
+	if (container != NULL && container->array == NULL) {
+		memcpy(words, container->words, sizeof(unsigned long long) * BM_CHUNK_WORDS);
+		return;
+	}
+	memset(words, 0, sizeof(unsigned long long) * BM_CHUNK_WORDS);
+	for (int i = 0; container != NULL && i < container->count; i++)
+		words[container->array[i] >> 6] |= 1ull << (container->array[i] & 63);
+}
+
+// Stores the bits as an array or as words, whichever the count calls for, -1 if there is no memory
+static int BM_Pack(BM_container* container, const unsigned long long* words) {
+	int count = 0;
+	for (int i = 0; i < BM_CHUNK_WORDS; i++)
+		count += __builtin_popcountll(words[i]);
+
+	free(container->array);
+	free(container->words);
+	container->array = NULL;
+	container->words = NULL;
+	container->count = count;
+	container->capacity = 0;
+
+	if (count > BM_ARRAY_MAX) {
+		container->words = malloc(sizeof(unsigned long long) * BM_CHUNK_WORDS);
+		if (container->words == NULL) return -1;
+		memcpy(container->words, words, sizeof(unsigned long long) * BM_CHUNK_WORDS);
+		return 0;
+	}
+
+	container->array = malloc(sizeof(unsigned short) * (count > 0 ? count : 1));
+	if (container->array == NULL) return -1;
+	container->capacity = count;
+	int n = 0;
+	for (int i = 0; i < BM_CHUNK_WORDS; i++)
+		for (unsigned long long word = words[i]; word != 0; word &= word - 1)
+			container->array[n++] = (unsigned short) (i * 64 + __builtin_ctzll(word));
+	return 0;
+}
+
+// Returns 1 if the position was added, 0 if it was already there and -1 if there is no memory
+static int BM_Add(BM_Bitmap* bitmap, unsigned int position) {
+	unsigned short key = position >> BM_CHUNK_BITS;
+	unsigned short low = position & ((1 << BM_CHUNK_BITS) - 1);
+	int i = BM_Find(bitmap, key);
+	BM_container* container = i < bitmap->count && bitmap->containers[i].key == key ? &bitmap->containers[i] : BM_InsertContainer(bitmap, i, key);
+	if (container == NULL) return -1;
+
+	if (container->array == NULL && container->words != NULL) {
+		unsigned long long bit = 1ull << (low & 63);
+		if (container->words[low >> 6] & bit) return 0;
+		container->words[low >> 6] |= bit;
+		container->count++;
+		return 1;
+	}
+
+	int slot = BM_FindLow(container, low);
+	if (slot < container->count && container->array[slot] == low) return 0;
+
+	// A full array turns into words
+	if (container->count == BM_ARRAY_MAX) {
+		unsigned long long words[BM_CHUNK_WORDS];
+		BM_Expand(container, words);
+		words[low >> 6] |= 1ull << (low & 63);
+		return BM_Pack(container, words) == 0 ? 1 : -1;
+	}
+
+	if (container->count == container->capacity) {
+		int capacity = container->capacity == 0 ? 4 : 2 * container->capacity;
+		if (capacity > BM_ARRAY_MAX) capacity = BM_ARRAY_MAX;
+		unsigned short* array = realloc(container->array, sizeof(unsigned short) * capacity);
+		if (array == NULL) return -1;
+		container->array = array;
+		container->capacity = capacity;
+	}
+	memmove(&container->array[slot + 1], &container->array[slot], sizeof(unsigned short) * (container->count - slot));
+	container->array[slot] = low;
+	container->count++;
+	return 1;
+}
+
+// Returns 1 if the position was removed, 0 if it was not there and -1 if there is no memory
+static int BM_Remove(BM_Bitmap* bitmap, unsigned int position) {
+	unsigned short key = position >> BM_CHUNK_BITS;
+	unsigned short low = position & ((1 << BM_CHUNK_BITS) - 1);
+	int i = BM_Find(bitmap, key);
+	if (i == bitmap->count || bitmap->containers[i].key != key) return 0;
+	BM_container* container = &bitmap->containers[i];
+
+	if (container->array == NULL) {
+		unsigned long long bit = 1ull << (low & 63);
+		if ((container->words[low >> 6] & bit) == 0) return 0;
+		container->words[low >> 6] &= ~bit;
+		container->count--;
+
+		// Back to an array once it fits in one
+		if (container->count == BM_ARRAY_MAX) {
+			unsigned long long words[BM_CHUNK_WORDS];
+			BM_Expand(container, words);
+			if (BM_Pack(container, words) != 0) return -1;
+		}
+		return 1;
+	}
+
+	int slot = BM_FindLow(container, low);
+	if (slot == container->count || container->array[slot] != low) return 0;
+	memmove(&container->array[slot], &container->array[slot + 1], sizeof(unsigned short) * (container->count - slot - 1));
+	container->count--;
+	if (container->count == 0) BM_RemoveContainer(bitmap, i);
+	return 1;
+}
+
+static int BM_CopyContainer(BM_container* to, const BM_container* from) {
+	*to = *from;
+	to->array = NULL;
+	to->words = NULL;
+	if (from->array == NULL) {
+		to->words = malloc(sizeof(unsigned long long) * BM_CHUNK_WORDS);
+		if (to->words == NULL) return -1;
+		memcpy(to->words, from->words, sizeof(unsigned long long) * BM_CHUNK_WORDS);
+		return 0;
+	}
+	to->capacity = from->count;
+	to->array = malloc(sizeof(unsigned short) * (from->count > 0 ? from->count : 1));
+	if (to->array == NULL) return -1;
+	memcpy(to->array, from->array, sizeof(unsigned short) * from->count);
+	return 0;
+}
+
+// Whole words at a time, fixed trip counts that the compiler turns into vector instructions
+static void BM_Words(BM_operation operation, unsigned long long* out, const unsigned long long* a, const unsigned long long* b) {
+	switch (operation) {
+	case BM_AND:
+		for (int i = 0; i < BM_CHUNK_WORDS; i++) out[i] = a[i] & b[i];
+		break;
+	case BM_OR:
+		for (int i = 0; i < BM_CHUNK_WORDS; i++) out[i] = a[i] | b[i];
+		break;
+	case BM_ANDNOT:
+		for (int i = 0; i < BM_CHUNK_WORDS; i++) out[i] = a[i] & ~b[i];
+		break;
+	}
+}
+
+// Two arrays intersect by a merge, without expanding either of them
+static int BM_IntersectArrays(BM_container* out, const BM_container* a, const BM_container* b) {
+	int capacity = a->count < b->count ? a->count : b->count;
+	out->array = malloc(sizeof(unsigned short) * (capacity > 0 ? capacity : 1));
+	if (out->array == NULL) return -1;
+	out->capacity = capacity;
+	out->count = 0;
+	for (int i = 0, j = 0; i < a->count && j < b->count; ) {
+		if (a->array[i] < b->array[j]) i++;
+		else if (b->array[j] < a->array[i]) j++;
+		else {
+			out->array[out->count++] = a->array[i];
+			i++;
+			j++;
+		}
+	}
+	return 0;
+}
+
+static BM_Bitmap* BM_Combine(BM_operation operation, const BM_Bitmap* a, const BM_Bitmap* b) {
+	if (a->slotBits != b->slotBits) return NULL;
+	BM_Bitmap* result = BM_BitmapCreate(a->slotBits);
+	if (result == NULL) return NULL;
+
+	unsigned long long left[BM_CHUNK_WORDS], right[BM_CHUNK_WORDS], out[BM_CHUNK_WORDS];
+	int i = 0, j = 0;
+	while (i < a->count || j < b->count) {
+		// The container of the smaller key, or one from each bitmap if the keys match
+		const BM_container* x = i < a->count ? &a->containers[i] : NULL;
+		const BM_container* y = j < b->count ? &b->containers[j] : NULL;
+		if (y == NULL || (x != NULL && x->key < y->key)) {
+			y = NULL;
+			i++;
+		} else if (x == NULL || y->key < x->key) {
+			x = NULL;
+			j++;
+		} else {
+			i++;
+			j++;
+		}
+
+		if (x == NULL && operation != BM_OR) continue;
+		if (y == NULL && operation == BM_AND) continue;
+		BM_container* container = BM_InsertContainer(result, result->count, x != NULL ? x->key : y->key);
+		int error = container == NULL ? -1 : 0;
+
+		if (error == 0 && (x == NULL || y == NULL)) {
+			error = BM_CopyContainer(container, x != NULL ? x : y);
+		} else if (error == 0 && operation == BM_AND && x->array != NULL && y->array != NULL) {
+			error = BM_IntersectArrays(container, x, y);
+		} else if (error == 0) {
+			BM_Expand(x, left);
+			BM_Expand(y, right);
+			BM_Words(operation, out, left, right);
+			error = BM_Pack(container, out);
+		}
+
+		if (error != 0) {
+			BM_Free(result);
+			return NULL;
+		}
+		if (container->count == 0) BM_RemoveContainer(result, result->count - 1);
+	}
+	return result;
+}
+
+BM_Bitmap* BM_And(const BM_Bitmap* a, const BM_Bitmap* b) {
+	return BM_Combine(BM_AND, a, b);
+}
+
+BM_Bitmap* BM_Or(const BM_Bitmap* a, const BM_Bitmap* b) {
+	return BM_Combine(BM_OR, a, b);
+}
+
+BM_Bitmap* BM_Not(BM_info* bm_info, const BM_Bitmap* a) {
+	// Every record has a value, so the records of the file are the union of all the bitmaps
+	BM_Bitmap* all = BM_BitmapCreate(bm_info->slotBits);
+	for (int i = 0; all != NULL && i < bm_info->valueCount; i++) {
+		BM_Bitmap* next = BM_Or(all, bm_info->bitmaps[i]);
+		BM_Free(all);
+		all = next;
+	}
+	if (all == NULL) return NULL;
+
+	BM_Bitmap* result = BM_Combine(BM_ANDNOT, all, a);
+	BM_Free(all);
+	return result;
+}
+
+long int BM_Count(const BM_Bitmap* bitmap) {
+	long int count = 0;
+	for (int i = 0; i < bitmap->count; i++)
+		count += bitmap->containers[i].count;
+	return count;
+}
+
+void BM_ForEach(const BM_Bitmap* bitmap, BM_Callback callback, void* context) {
+	for (int i = 0; i < bitmap->count; i++) {
+		const BM_container* container = &bitmap->containers[i];
+		unsigned int high = (unsigned int) container->key << BM_CHUNK_BITS;
+		if (container->array != NULL) {
+			for (int n = 0; n < container->count; n++)
+				callback(BM_Rid(bitmap->slotBits, high | container->array[n]), context);
+			continue;
+		}
+		for (int w = 0; w < BM_CHUNK_WORDS; w++)
+			for (unsigned long long word = container->words[w]; word != 0; word &= word - 1)
+				callback(BM_Rid(bitmap->slotBits, high | (unsigned int) (w * 64 + __builtin_ctzll(word))), context);
+	}
+}
+
+static char* BM_Serialize(const BM_Bitmap* bitmap, int* size) {
+	*size = sizeof(int);
+	for (int i = 0; i < bitmap->count; i++) {
+		const BM_container* container = &bitmap->containers[i];
+		*size += 2 * sizeof(int);
+		*size += container->array != NULL ? sizeof(unsigned short) * container->count : sizeof(unsigned long long) * BM_CHUNK_WORDS;
+	}
+
+	char* data = malloc(*size);
+	if (data == NULL) return NULL;
+	char* out = data;
+	memcpy(out, &bitmap->count, sizeof(int));
+	out += sizeof(int);
+	for (int i = 0; i < bitmap->count; i++) {
+		const BM_container* container = &bitmap->containers[i];
+		int key = container->key;
+		memcpy(out, &key, sizeof(int));
+		memcpy(out + sizeof(int), &container->count, sizeof(int));
+		out += 2 * sizeof(int);
+		if (container->array != NULL) {
+			memcpy(out, container->array, sizeof(unsigned short) * container->count);
+			out += sizeof(unsigned short) * container->count;
+		} else {
+			memcpy(out, container->words, sizeof(unsigned long long) * BM_CHUNK_WORDS);
+			out += sizeof(unsigned long long) * BM_CHUNK_WORDS;
+		}
+	}
+	return data;
+}
+
+static BM_Bitmap* BM_Deserialize(int slotBits, const char* data, int size) {
+	BM_Bitmap* bitmap = BM_BitmapCreate(slotBits);
+	if (bitmap == NULL || size < (int) sizeof(int)) {
+		BM_Free(bitmap);
+		return NULL;
+	}
+
+	int count;
+	memcpy(&count, data, sizeof(int));
+	const char* in = data + sizeof(int);
+	for (int i = 0; i < count; i++) {
+		int key, positions;
+		if (in + 2 * sizeof(int) > data + size) break;
+		memcpy(&key, in, sizeof(int));
+		memcpy(&positions, in + sizeof(int), sizeof(int));
+		in += 2 * sizeof(int);
+
+		// The count tells which of the two forms follows
+		int bytes = positions > BM_ARRAY_MAX ? (int) sizeof(unsigned long long) * BM_CHUNK_WORDS : (int) sizeof(unsigned short) * positions;
+		BM_container* container = in + bytes <= data + size ? BM_InsertContainer(bitmap, bitmap->count, (unsigned short) key) : NULL;
+		if (container == NULL) break;
+		container->count = positions;
+		if (positions > BM_ARRAY_MAX) container->words = malloc(bytes);
+		else {
+			container->array = malloc(bytes > 0 ? bytes : 1);
+			container->capacity = positions;
+		}
+		if (container->array == NULL && container->words == NULL) break;
+		memcpy(container->array != NULL ? (void*) container->array : (void*) container->words, in, bytes);
+		in += bytes;
+	}
+
+	if (bitmap->count != count) {
+		BM_Free(bitmap);
+		return NULL;
+	}
+	return bitmap;
+}
+
+// Writes every bitmap that changed, the directory of the values and the header
+static int BM_WriteIndex(BM_info* bm_info) {
+	int error;
+	for (int i = 0; i < bm_info->valueCount; i++) {
+		if (!bm_info->bitmaps[i]->dirty) continue;
+		int size;
+		char* data = BM_Serialize(bm_info->bitmaps[i], &size);
+		if (data == NULL) return -1;
+		error = BC_Write(bm_info->fileDesc, &bm_info->values[i].bitmapBlock, data, size);
+		free(data);
+		if (error != 0) return -1;
+		bm_info->bitmaps[i]->dirty = false;
+	}
+
+	if (bm_info->valueCount > 0) {
+		error = BC_Write(bm_info->fileDesc, &bm_info->valuesBlock, (char*) bm_info->values, sizeof(BM_value) * bm_info->valueCount);
+		if (error != 0) return -1;
+	}
+
+	BF_Block* block;
+	BF_Block_Init(&block);
+	error = TC(BF_GetBlock(bm_info->fileDesc, 0, block));
+	if (error != 0) return -1;
+
+	memcpy(BF_Block_GetData(block), bm_info, sizeof(BM_info));
+	BF_Block_SetDirty(block);
+	error = TC(BF_UnpinBlock(block));
+	if (error != 0) return -1;
+
+	BF_Block_Destroy(&block);
+	return 0;
+}
+
+static char* BM_Value(BM_info* bm_info, Record* record) {
+	switch (bm_info->attribute) {
+	case SURNAME:
+		return record->surname;
+	case CITY:
+		return record->city;
+	default:
+		return record->name;
+	}
+}
+
+// The value is looked up by name, a low cardinality attribute has only a few of them
+static int BM_FindValue(BM_info* bm_info, const char* value) {
+	for (int i = 0; i < bm_info->valueCount; i++)
+		if (strcmp(bm_info->values[i].value, value) == 0) return i;
+	return -1;
+}
+
+static int BM_AddValue(BM_info* bm_info, const char* value) {
+	if (bm_info->valueCount == DICTIONARY_SIZE || strlen(value) >= BM_VALUE_SIZE) return -1;
+	BM_value* values = realloc(bm_info->values, sizeof(BM_value) * (bm_info->valueCount + 1));
+	if (values != NULL) bm_info->values = values;
+	BM_Bitmap** bitmaps = realloc(bm_info->bitmaps, sizeof(BM_Bitmap*) * (bm_info->valueCount + 1));
+	if (bitmaps != NULL) bm_info->bitmaps = bitmaps;
+	if (values == NULL || bitmaps == NULL) return -1;
+
+	int i = bm_info->valueCount;
+	memset(&values[i], 0, sizeof(BM_value));
+	strcpy(values[i].value, value);
+	values[i].bitmapBlock = -1;
+	bitmaps[i] = BM_BitmapCreate(bm_info->slotBits);
+	if (bitmaps[i] == NULL) return -1;
+	bitmaps[i]->dirty = true;
+	bm_info->valueCount++;
+	return i;
+}
+
+int BM_InsertEntry(BM_info* bm_info, Record record, int rid) {
+	if (HT_RID_SLOT(rid) >= (1 << bm_info->slotBits)) return -1;
+	char* value = BM_Value(bm_info, &record);
+	int i = BM_FindValue(bm_info, value);
+	if (i == -1) i = BM_AddValue(bm_info, value);
+	if (i == -1) return -1;
+
+	int added = BM_Add(bm_info->bitmaps[i], BM_Position(bm_info->slotBits, rid));
+	if (added == -1) return -1;
+	if (added == 1) bm_info->bitmaps[i]->dirty = true;
+	return 0;
+}
+
+int BM_DeleteEntry(BM_info* bm_info, Record record, int rid) {
+	int i = BM_FindValue(bm_info, BM_Value(bm_info, &record));
+	if (i == -1) return 0;
+
+	int removed = BM_Remove(bm_info->bitmaps[i], BM_Position(bm_info->slotBits, rid));
+	if (removed == -1) return -1;
+	if (removed == 1) bm_info->bitmaps[i]->dirty = true;
+	return 0;
+}
+
+BM_Bitmap* BM_Lookup(BM_info* bm_info, char* value) {
+	BM_Bitmap* result = BM_BitmapCreate(bm_info->slotBits);
+	int i = BM_FindValue(bm_info, value);
+	if (result == NULL || i == -1) return result;
+
+	const BM_Bitmap* bitmap = bm_info->bitmaps[i];
+	for (int n = 0; n < bitmap->count; n++) {
+		BM_container* container = BM_InsertContainer(result, result->count, bitmap->containers[n].key);
+		if (container == NULL || BM_CopyContainer(container, &bitmap->containers[n]) != 0) {
+			BM_Free(result);
+			return NULL;
+		}
+	}
+	return result;
+}
+
+typedef struct {
+	BM_info* bm_info;
+	int error;
+} BM_build;
+
+static void BM_IndexRecord(int key, Record* record, int rid, void* context) {
+	(void) key;
+	BM_build* build = context;
+	if (BM_InsertEntry(build->bm_info, *record, rid) != 0) build->error = -1;
+}
+
+int BM_CreateIndex(char* bfileName, char* fileName, Record_Attribute attribute) {
+	int error;
+	int fileDescriptor;
+
+	if (attribute != NAME && attribute != SURNAME && attribute != CITY) return -1;
+	HT_info* ht_info = HT_OpenFile(fileName);
+	if (ht_info == NULL) return -1;
+
+	BM_info info;
+	memset(&info, 0, sizeof(BM_info));
+	info.isHeapFile = false;
+	info.isHashFile = false;
+	info.isBitmapFile = true;
+	info.attribute = attribute;
+	info.valueCount = 0;
+	info.valuesBlock = -1;
+
+	// The slots of a block are numbered up to recordsPerBlock, except for variable length records
+	info.slotBits = HT_RID_SLOT_BITS;
+	if (ht_info->format != SLOTTED_FORMAT)
+		for (info.slotBits = 0; (1 << info.slotBits) < ht_info->recordsPerBlock; info.slotBits++);
+
+	error = TC(BF_CreateFile(bfileName));
+	error += TC(BF_OpenFile(bfileName, &fileDescriptor));
+	if (error != 0) {
+		HT_CloseFile(ht_info);
+		return -1;
+	}
+	info.fileDesc = fileDescriptor;
+
+	// Reserve block 0 for the header
+	BF_Block* block;
+	BF_Block_Init(&block);
+	error = TC(BF_AllocateBlock(fileDescriptor, block));
+	error += TC(BF_UnpinBlock(block));
+	BF_Block_Destroy(&block);
+	if (error == 0) error = BM_WriteIndex(&info);
+	if (TC(BF_CloseFile(fileDescriptor)) != 0) error = -1;
+
+	// Every record of the file is set in the bitmap of its value
+	BM_build build = { error == 0 ? BM_OpenIndex(bfileName) : NULL, 0 };
+	if (build.bm_info == NULL) error = -1;
+	if (error == 0 && HT_ScanEntries(ht_info, BM_IndexRecord, &build) == -1) error = -1;
+	if (build.error != 0) error = -1;
+
+	if (build.bm_info != NULL && BM_CloseIndex(build.bm_info) != 0) error = -1;
+	if (HT_CloseFile(ht_info) != 0) error = -1;
+	if (error != 0) remove(bfileName);
+	return error;
+}
+
+BM_info* BM_OpenIndex(char* bfileName) {
+	int error;
+	int fileDescriptor;
+
+	error = TC(BF_OpenFile(bfileName, &fileDescriptor));
+	if (error != 0) return NULL;
+
+	BF_Block* block;
+	BF_Block_Init(&block);
+
+	error = TC(BF_GetBlock(fileDescriptor, 0, block));
+	if (error != 0) return NULL;
+
+	BM_info* infoSaved = (BM_info*) BF_Block_GetData(block);
+
+	// If the file is not a bitmap index, return NULL
+	if (infoSaved->isHeapFile || infoSaved->isHashFile || !infoSaved->isBitmapFile) {
+		BF_UnpinBlock(block);
+		return NULL;
+	}
+
+	BM_info* toReturn = malloc(sizeof(BM_info));
+	memcpy(toReturn, infoSaved, sizeof(BM_info));
+	toReturn->fileDesc = fileDescriptor;
+	toReturn->values = NULL;
+	toReturn->bitmaps = calloc(toReturn->valueCount + 1, sizeof(BM_Bitmap*));
+
+	error = TC(BF_UnpinBlock(block));
+	if (error != 0) return NULL;
+	BF_Block_Destroy(&block);
+
+	// Every bitmap stays in memory while the index is open
+	int size;
+	if (toReturn->valueCount > 0) {
+		error = BC_Read(fileDescriptor, toReturn->valuesBlock, (char**) &toReturn->values, &size);
+		if (error != 0 || size != (int) sizeof(BM_value) * toReturn->valueCount) return NULL;
+	}
+	for (int i = 0; i < toReturn->valueCount; i++) {
+		char* data;
+		error = BC_Read(fileDescriptor, toReturn->values[i].bitmapBlock, &data, &size);
+		if (error != 0) return NULL;
+		toReturn->bitmaps[i] = BM_Deserialize(toReturn->slotBits, data, size);
+		free(data);
+		if (toReturn->bitmaps[i] == NULL) return NULL;
+	}
+
+	return toReturn;
+}
+
+int BM_CloseIndex(BM_info* bm_info) {
+	int error;
+	int fileDescriptor = bm_info->fileDesc;
+
+	error = BM_WriteIndex(bm_info);
+	if (error != 0) return -1;
+
+	for (int i = 0; i < bm_info->valueCount; i++)
+		BM_Free(bm_info->bitmaps[i]);
+	free(bm_info->bitmaps);
+	free(bm_info->values);
+	free(bm_info);
+
+	error = TC(BF_CloseFile(fileDescriptor));
+	if (error != 0) return -1;
+
+	return 0;
+}
+
+int StatisticsBM(char* filename) {
+	BM_info* info = BM_OpenIndex(filename);
+	if (info == NULL) return -1;
+
+	int blocks;
+	if (TC(BF_GetBlockCounter(info->fileDesc, &blocks)) != 0) return -1;
+
+	long int records = 0;
+	printf("1. Values: %d, positions of %d slot bits\n", info->valueCount, info->slotBits);
+	for (int i = 0; i < info->valueCount; i++) {
+		const BM_Bitmap* bitmap = info->bitmaps[i];
+		int arrays = 0;
+		for (int n = 0; n < bitmap->count; n++)
+			if (bitmap->containers[n].array != NULL) arrays++;
+		printf("\t %-20s %7ld records, %d array and %d bitmap containers\n",
+			info->values[i].value, BM_Count(bitmap), arrays, bitmap->count - arrays);
+		records += BM_Count(bitmap);
+	}
+	printf("2. Records: %ld, in %d blocks of the index\n", records, blocks);
+
+	return BM_CloseIndex(info);
+}
@@ -0,0 +1,127 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+
+#include "bf.h"
+#include "block_chain.h"
+
+int TC(BF_ErrorCode error) {
+    if (error != BF_OK) {
+        BF_PrintError(error);
+        return (-1);
+    } else {
+        return 0;
+    }
+}
+
+int BC_Write(int fileDesc, int* firstBlock, const char* data, int size) {
+	int error;
+	BF_Block* block;
+	BF_Block_Init(&block);
+
+	int current = *firstBlock;
+	int written = 0;
+	BC_block_info* info;
+
+	// Get (or allocate) the first block of the chain
+	if (current == -1) {
+		error = TC(BF_AllocateBlock(fileDesc, block));
+		if (error != 0) return -1;
+
+		BF_GetBlockCounter(fileDesc, &current);
+		current--;
+		*firstBlock = current;
+
+		info = (BC_block_info*) BF_Block_GetData(block);
+		info->nextBlock = -1;
+	} else {
+		error = TC(BF_GetBlock(fileDesc, current, block));
+		if (error != 0) return -1;
+		info = (BC_block_info*) BF_Block_GetData(block);
+	}
+
+	while ( true ) {
+		int toWrite = size - written;
+		if (toWrite > BC_BLOCK_CAPACITY) toWrite = BC_BLOCK_CAPACITY;
+
+		memcpy((char*) info + sizeof(BC_block_info), data + written, toWrite);
+		info->bytes = toWrite;
+		written += toWrite;
+		BF_Block_SetDirty(block);
+
+		if (written == size) {
+			// Blocks after this one (if the data shrank) are left out of the chain
+			info->nextBlock = -1;
+			break;
+		}
+
+		int next = info->nextBlock;
+		if (next == -1) {
+			// Chain is too short, append a new block to it
+			BF_Block* newBlock;
+			BF_Block_Init(&newBlock);
+			error = TC(BF_AllocateBlock(fileDesc, newBlock));
+			if (error != 0) return -1;
+
+			BF_GetBlockCounter(fileDesc, &next);
+			next--;
+			info->nextBlock = next;
+
+			error = TC(BF_UnpinBlock(block));
+			if (error != 0) return -1;
+			BF_Block_Destroy(&block);
+
+			block = newBlock;
+			info = (BC_block_info*) BF_Block_GetData(block);
+			info->nextBlock = -1;
+		} else {
+			error = TC(BF_UnpinBlock(block));
+			if (error != 0) return -1;
+
+			error = TC(BF_GetBlock(fileDesc, next, block));
+			if (error != 0) return -1;
+			info = (BC_block_info*) BF_Block_GetData(block);
+		}
+	}
+
+	error = TC(BF_UnpinBlock(block));
+	if (error != 0) return -1;
+	BF_Block_Destroy(&block);
+
+	return 0;
+}
+
+int BC_Read(int fileDesc, int firstBlock, char** data, int* size) {
+	int error;
+	BF_Block* block;
+	BF_Block_Init(&block);
+
+	int capacity = BC_BLOCK_CAPACITY;
+	int read = 0;
+	char* buffer = malloc(capacity);
+
+	int current = firstBlock;
+	while (current != -1) {
+		error = TC(BF_GetBlock(fileDesc, current, block));
+		if (error != 0) { free(buffer); return -1; }
+
+		BC_block_info* info = (BC_block_info*) BF_Block_GetData(block);
+		if (read + info->bytes > capacity) {
+			capacity = 2 * capacity + info->bytes;
+			buffer = realloc(buffer, capacity);
+		}
+		memcpy(buffer + read, (char*) info + sizeof(BC_block_info), info->bytes);
+		read += info->bytes;
+		current = info->nextBlock;
+
+		error = TC(BF_UnpinBlock(block));
+		if (error != 0) { free(buffer); return -1; }
+	}
+
+	BF_Block_Destroy(&block);
+
+	*data = buffer;
+	*size = read;
+	return 0;
+}
@@ -0,0 +1,116 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+
+#include "bf.h"
+#include "bloom_filter.h"
+#include "latch.h"
+#include "block_chain.h"
+
+// murmur3 finalizer, re-mixes the bucket hash so that keys of the same bucket spread over the filter
+static unsigned int BLOOM_Mix(unsigned int h) {
+	h ^= h >> 16;
+	h *= 0x85ebca6b;
+	h ^= h >> 13;
+	h *= 0xc2b2ae35;
+	h ^= h >> 16;
+	return h;
+}
+
+// The i-th bit of a key, with double hashing: h1 + i * h2
+static unsigned int BLOOM_Bit(unsigned int hash, int i, int bits) {
+	unsigned int h1 = BLOOM_Mix(hash ^ 0x9747b28c);
+	unsigned int h2 = BLOOM_Mix(h1) | 1;
+	return (h1 + i * h2) % bits;
+}
+
+void BLOOM_Set(unsigned char* filter, int filterBytes, unsigned int hash) {
+	for (int i = 0; i < BLOOM_HASHES; i++) {
+		unsigned int bit = BLOOM_Bit(hash, i, filterBytes * 8);
+		filter[bit / 8] |= 1 << (bit % 8);
+	}
+}
+
+int BLOOM_Test(const unsigned char* filter, int filterBytes, unsigned int hash) {
+	for (int i = 0; i < BLOOM_HASHES; i++) {
+		unsigned int bit = BLOOM_Bit(hash, i, filterBytes * 8);
+		if ((filter[bit / 8] & (1 << (bit % 8))) == 0)
+			return 0;
+	}
+	return 1;
+}
+
+// Pins the block that holds the filter of bucket, and points filter at it
+static int BLOOM_GetFilter(int fileDesc, int firstBlock, int filterBytes, int bucket, BF_Block* block, unsigned char** filter) {
+	int perBlock = BF_BLOCK_SIZE / filterBytes;
+	int error = TC(LATCH_GetBlock(fileDesc, firstBlock + bucket / perBlock, block));
+	if (error != 0) return -1;
+
+	*filter = (unsigned char*) BF_Block_GetData(block) + (bucket % perBlock) * filterBytes;
+	return 0;
+}
+
+int BLOOM_CreateFilters(int fileDesc, int buckets, int filterBytes, int* firstBlock) {
+	if (filterBytes <= 0 || filterBytes > BF_BLOCK_SIZE) return -1;
+
+	int perBlock = BF_BLOCK_SIZE / filterBytes;
+	int blocks = (buckets + perBlock - 1) / perBlock;
+
+	BF_Block* block;
+	BF_Block_Init(&block);
+
+	// Blocks are appended, so the filter blocks are consecutive
+	BF_GetBlockCounter(fileDesc, firstBlock);
+	for (int i = 0; i < blocks; i++) {
+		int error = TC(BF_AllocateBlock(fileDesc, block));
+		if (error == 0) {
+			memset(BF_Block_GetData(block), 0, BF_BLOCK_SIZE);
+			BF_Block_SetDirty(block);
+			error = TC(BF_UnpinBlock(block));
+		}
+		if (error != 0) {
+			BF_Block_Destroy(&block);
+			return -1;
+		}
+	}
+
+	BF_Block_Destroy(&block);
+	return 0;
+}
+
+int BLOOM_Add(int fileDesc, int firstBlock, int filterBytes, int bucket, unsigned int hash) {
+	BF_Block* block;
+	BF_Block_Init(&block);
+
+	unsigned char* filter;
+	if (BLOOM_GetFilter(fileDesc, firstBlock, filterBytes, bucket, block, &filter) != 0) {
+		BF_Block_Destroy(&block);
+		return -1;
+	}
+
+	BLOOM_Set(filter, filterBytes, hash);
+
+	LATCH_SetDirty(block);
+	int error = TC(LATCH_UnpinBlock(block));
+	BF_Block_Destroy(&block);
+	return error;
+}
+
+int BLOOM_MayContain(int fileDesc, int firstBlock, int filterBytes, int bucket, unsigned int hash) {
+	BF_Block* block;
+	BF_Block_Init(&block);
+
+	unsigned char* filter;
+	if (BLOOM_GetFilter(fileDesc, firstBlock, filterBytes, bucket, block, &filter) != 0) {
+		BF_Block_Destroy(&block);
+		return -1;
+	}
+
+	int found = BLOOM_Test(filter, filterBytes, hash);
+
+	int error = TC(LATCH_UnpinBlock(block));
+	BF_Block_Destroy(&block);
+	if (error != 0) return -1;
+	return found;
+}
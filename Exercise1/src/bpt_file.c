@@ -0,0 +1,590 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "bf.h"
+#include "bpt_file.h"
+#include "record.h"
+#include <assert.h>
+
+static int TC(BF_ErrorCode error) {
+    if (error != BF_OK) {
+        BF_PrintError(error);
+        return (-1);
+    } else {
+        return 0;
+    }
+}
+
+// 	/*
+// 	Block 0: BPT_info
+//
+// 								root (internal)
+// 							_________________________________
+// 							| BPT_block_info | c0 k0 c1 k1 c2 |		keys[i] <= every key under children[i + 1]
+// 							|________________|_|____|____|___|		keys[i] >= every key under children[i]
+// 							  /				 |			  \	children
+// 	leaves			 _______/___		_____|______		___\_______
+// 					| 1 2 3 5  | ----> | 8 9 9 12  | ----> | 15 20 21 | ----> -1
+// 					|__________|		|___________|		|__________|
+// 	*/
+
+#define BPT_RECORDS(blockData) ((Record*) ((blockData) + sizeof(BPT_block_info)))
+#define BPT_CHILDREN(blockData) ((int*) ((blockData) + sizeof(BPT_block_info)))
+#define BPT_KEYS(info, blockData) (BPT_CHILDREN(blockData) + (info)->keysPerNode + 1)
+
+// Records of a leaf with room for one more, the largest a leaf split has to sort out
+#define BPT_MAX_LEAF_RECORDS ((BF_BLOCK_SIZE - (int) sizeof(BPT_block_info)) / (int) sizeof(Record) + 1)
+#define BPT_MAX_NODE_KEYS ((BF_BLOCK_SIZE - (int) sizeof(BPT_block_info)) / (int) sizeof(int))
+
+// Keys before the place of key in keys: those smaller than it, or (after) those not larger
+static int BPT_KeyPosition(const int* keys, int count, int key, bool after) {
+	int low = 0, high = count;
+	while (low < high) {
+		int middle = (low + high) / 2;
+		if (keys[middle] < key || (after && keys[middle] == key)) low = middle + 1;
+		else high = middle;
+	}
+	return low;
+}
+
+// BPT_KeyPosition for the ids of the records of a leaf
+static int BPT_RecordPosition(const Record* records, int count, int key, bool after) {
+	int low = 0, high = count;
+	while (low < high) {
+		int middle = (low + high) / 2;
+		if (records[middle].id < key || (after && records[middle].id == key)) low = middle + 1;
+		else high = middle;
+	}
+	return low;
+}
+
+// Allocates a node block, returns its number (or -1) and leaves it pinned and empty in block
+static int BPT_NewNode(BPT_info* bpt_info, BF_Block* block, bool isLeaf) {
+	int error = TC(BF_AllocateBlock(bpt_info->fileDesc, block));
+	if (error != 0) return -1;
+
+	int blockNumber;
+	BF_GetBlockCounter(bpt_info->fileDesc, &blockNumber);
+
+	BPT_block_info* node = (BPT_block_info*) BF_Block_GetData(block);
+	node->isLeaf = isLeaf;
+	node->count = 0;
+	node->nextBlock = -1;
+	BF_Block_SetDirty(block);
+
+	return blockNumber - 1;
+}
+
+static int BPT_WriteHeader(BPT_info* bpt_info) {
+	BF_Block* block;
+	BF_Block_Init(&block);
+
+	int error = TC(BF_GetBlock(bpt_info->fileDesc, 0, block));
+	if (error != 0) return -1;
+
+	memcpy(BF_Block_GetData(block), bpt_info, sizeof(BPT_info));
+	BF_Block_SetDirty(block);
+
+	error = TC(BF_UnpinBlock(block));
+	if (error != 0) return -1;
+
+	BF_Block_Destroy(&block);
+	return 0;
+}
+
+int BPT_CreateFile(char *fileName) {
+	int error;
+	int fileDescriptor;
+
+	error = TC(BF_CreateFile(fileName));
+	if (error != 0) return -1;
+
+	error = TC(BF_OpenFile(fileName, &fileDescriptor));
+	if (error != 0) return -1;
+
+	BF_Block* block;
+	BF_Block_Init(&block);
+
+	// Reserve block 0 for the header
+	error = TC(BF_AllocateBlock(fileDescriptor, block));
+	if (error != 0) return -1;
+	error = TC(BF_UnpinBlock(block));
+	if (error != 0) return -1;
+
+	BPT_info info;
+	info.fileDesc = fileDescriptor;
+	info.isHeapFile = false;
+	info.isHashFile = false;
+	info.isTreeFile = true;
+	info.height = 1;
+	info.recordsPerLeaf = BPT_MAX_LEAF_RECORDS - 1;
+	info.keysPerNode = (BPT_MAX_NODE_KEYS - 1) / 2;	// One more child than keys
+	info.records = 0;
+
+	// The root starts as an empty leaf
+	info.root = BPT_NewNode(&info, block, true);
+	if (info.root == -1) return -1;
+	info.firstLeaf = info.root;
+	error = TC(BF_UnpinBlock(block));
+	if (error != 0) return -1;
+	BF_Block_Destroy(&block);
+
+	error = BPT_WriteHeader(&info);
+	if (error != 0) return -1;
+
+	error = TC(BF_CloseFile(fileDescriptor));
+	if (error != 0) return -1;
+
+	return 0;
+}
+
+BPT_info* BPT_OpenFile(char *fileName) {
+	int error;
+	int fileDescriptor;
+
+	error = TC(BF_OpenFile(fileName, &fileDescriptor));
+	if (error != 0) return NULL;
+
+	BF_Block* block;
+	BF_Block_Init(&block);
+
+	error = TC(BF_GetBlock(fileDescriptor, 0, block));
+	if (error != 0) return NULL;
+
+	BPT_info* infoSaved = (BPT_info*) BF_Block_GetData(block);
+
+	// If the file is not a B+ tree file, return NULL
+	if (infoSaved->isHeapFile || infoSaved->isHashFile || !infoSaved->isTreeFile) {
+		BF_UnpinBlock(block);
+		return NULL;
+	}
+
+	BPT_info* toReturn = malloc(sizeof(BPT_info));
+	memcpy(toReturn, infoSaved, sizeof(BPT_info));
+	toReturn->fileDesc = fileDescriptor;
+
+	error = TC(BF_UnpinBlock(block));
+	if (error != 0) return NULL;
+	BF_Block_Destroy(&block);
+
+	return toReturn;
+}
+
+int BPT_CloseFile(BPT_info* bpt_info) {
+	int error;
+	int fileDescriptor = bpt_info->fileDesc;
+
+	// The root, the height and the record count change as the tree grows
+	error = BPT_WriteHeader(bpt_info);
+	if (error != 0) return -1;
+
+	free(bpt_info);
+
+	error = TC(BF_CloseFile(fileDescriptor));
+	if (error != 0) return -1;
+
+	return 0;
+}
+
+// Walks from the root to the leaf of key: the leftmost one that may hold it, or (after) the one a new
+// record with it goes to. path and slots get the internal node of every level and the child taken there.
+// Returns the leaf, or -1.
+static int BPT_FindLeaf(BPT_info* bpt_info, int key, bool after, int* path, int* slots, int* blocksRead) {
+	BF_Block* block;
+	BF_Block_Init(&block);
+
+	int current = bpt_info->root;
+	for (int level = 0; level < bpt_info->height - 1; level++) {
+		int error = TC(BF_GetBlock(bpt_info->fileDesc, current, block));
+		if (error != 0) return -1;
+		if (blocksRead != NULL) (*blocksRead)++;
+
+		char* blockData = BF_Block_GetData(block);
+		BPT_block_info* node = (BPT_block_info*) blockData;
+		int slot = BPT_KeyPosition(BPT_KEYS(bpt_info, blockData), node->count, key, after);
+		if (path != NULL) {
+			path[level] = current;
+			slots[level] = slot;
+		}
+		current = BPT_CHILDREN(blockData)[slot];
+
+		error = TC(BF_UnpinBlock(block));
+		if (error != 0) return -1;
+	}
+
+	BF_Block_Destroy(&block);
+	return current;
+}
+
+// Puts key, and child right of it, in the parent of every split node, from the leaf's parent up.
+// A full parent splits too, its middle key goes up, and a split root gets a new root above it.
+static int BPT_InsertInParents(BPT_info* bpt_info, int* path, int* slots, int key, int child) {
+	int error;
+	BF_Block* block;
+	BF_Block* newBlock;
+	BF_Block_Init(&block);
+	BF_Block_Init(&newBlock);
+
+	for (int level = bpt_info->height - 2; level >= 0; level--) {
+		error = TC(BF_GetBlock(bpt_info->fileDesc, path[level], block));
+		if (error != 0) return -1;
+
+		char* blockData = BF_Block_GetData(block);
+		BPT_block_info* node = (BPT_block_info*) blockData;
+		int* keys = BPT_KEYS(bpt_info, blockData);
+		int* children = BPT_CHILDREN(blockData);
+		int slot = slots[level];
+
+		// If there is room, the key goes right after the child that split
+		if (node->count < bpt_info->keysPerNode) {
+			memmove(keys + slot + 1, keys + slot, sizeof(int) * (node->count - slot));
+			memmove(children + slot + 2, children + slot + 1, sizeof(int) * (node->count - slot));
+			keys[slot] = key;
+			children[slot + 1] = child;
+			node->count++;
+
+			BF_Block_SetDirty(block);
+			error = TC(BF_UnpinBlock(block));
+			if (error != 0) return -1;
+			BF_Block_Destroy(&block);
+			BF_Block_Destroy(&newBlock);
+			return 0;
+		}
+
+		// Split: the keys and children with the new ones, the middle key goes up and the right half moves
+		int allKeys[BPT_MAX_NODE_KEYS + 1], allChildren[BPT_MAX_NODE_KEYS + 2];
+		int count = node->count + 1;
+		memcpy(allKeys, keys, sizeof(int) * slot);
+		allKeys[slot] = key;
+		memcpy(allKeys + slot + 1, keys + slot, sizeof(int) * (node->count - slot));
+		memcpy(allChildren, children, sizeof(int) * (slot + 1));
+		allChildren[slot + 1] = child;
+		memcpy(allChildren + slot + 2, children + slot + 1, sizeof(int) * (node->count - slot));
+
+		int middle = count / 2;
+		int newNode = BPT_NewNode(bpt_info, newBlock, false);
+		if (newNode == -1) return -1;
+		char* newBlockData = BF_Block_GetData(newBlock);
+		BPT_block_info* right = (BPT_block_info*) newBlockData;
+
+		node->count = middle;
+		memcpy(keys, allKeys, sizeof(int) * middle);
+		memcpy(children, allChildren, sizeof(int) * (middle + 1));
+		right->count = count - middle - 1;
+		memcpy(BPT_KEYS(bpt_info, newBlockData), allKeys + middle + 1, sizeof(int) * right->count);
+		memcpy(BPT_CHILDREN(newBlockData), allChildren + middle + 1, sizeof(int) * (right->count + 1));
+
+		BF_Block_SetDirty(block);
+		BF_Block_SetDirty(newBlock);
+		error = TC(BF_UnpinBlock(block));
+		error += TC(BF_UnpinBlock(newBlock));
+		if (error != 0) return -1;
+
+		key = allKeys[middle];
+		child = newNode;
+	}
+
+	// The root split, the tree grows one level
+	if (bpt_info->height == BPT_MAX_HEIGHT) return -1;
+	int root = BPT_NewNode(bpt_info, newBlock, false);
+	if (root == -1) return -1;
+
+	char* rootData = BF_Block_GetData(newBlock);
+	((BPT_block_info*) rootData)->count = 1;
+	BPT_CHILDREN(rootData)[0] = bpt_info->root;
+	BPT_CHILDREN(rootData)[1] = child;
+	BPT_KEYS(bpt_info, rootData)[0] = key;
+
+	error = TC(BF_UnpinBlock(newBlock));
+	if (error != 0) return -1;
+
+	bpt_info->root = root;
+	bpt_info->height++;
+	BF_Block_Destroy(&block);
+	BF_Block_Destroy(&newBlock);
+	return 0;
+}
+
+int BPT_InsertEntry(BPT_info* bpt_info, Record record) {
+	int error;
+	int path[BPT_MAX_HEIGHT], slots[BPT_MAX_HEIGHT];
+	int leaf = BPT_FindLeaf(bpt_info, record.id, true, path, slots, NULL);
+	if (leaf == -1) return -1;
+
+	BF_Block* block;
+	BF_Block_Init(&block);
+	error = TC(BF_GetBlock(bpt_info->fileDesc, leaf, block));
+	if (error != 0) return -1;
+
+	char* blockData = BF_Block_GetData(block);
+	BPT_block_info* node = (BPT_block_info*) blockData;
+	Record* records = BPT_RECORDS(blockData);
+	int position = BPT_RecordPosition(records, node->count, record.id, true);
+	bpt_info->records++;
+
+	// If record fits in the leaf, just place it in order
+	if (node->count < bpt_info->recordsPerLeaf) {
+		memmove(records + position + 1, records + position, sizeof(Record) * (node->count - position));
+		records[position] = record;
+		node->count++;
+
+		BF_Block_SetDirty(block);
+		error = TC(BF_UnpinBlock(block));
+		if (error != 0) return -1;
+		BF_Block_Destroy(&block);
+		return leaf;
+	}
+
+	// Split: the upper half of the records, with the new one, moves to a new leaf right after this one
+	Record all[BPT_MAX_LEAF_RECORDS];
+	int count = node->count + 1;
+	memcpy(all, records, sizeof(Record) * position);
+	all[position] = record;
+	memcpy(all + position + 1, records + position, sizeof(Record) * (node->count - position));
+
+	BF_Block* newBlock;
+	BF_Block_Init(&newBlock);
+	int newLeaf = BPT_NewNode(bpt_info, newBlock, true);
+	if (newLeaf == -1) return -1;
+
+	char* newBlockData = BF_Block_GetData(newBlock);
+	BPT_block_info* right = (BPT_block_info*) newBlockData;
+	int left = (count + 1) / 2;
+
+	node->count = left;
+	memcpy(records, all, sizeof(Record) * left);
+	right->count = count - left;
+	memcpy(BPT_RECORDS(newBlockData), all + left, sizeof(Record) * right->count);
+	right->nextBlock = node->nextBlock;
+	node->nextBlock = newLeaf;
+
+	BF_Block_SetDirty(block);
+	BF_Block_SetDirty(newBlock);
+	error = TC(BF_UnpinBlock(block));
+	error += TC(BF_UnpinBlock(newBlock));
+	if (error != 0) return -1;
+	BF_Block_Destroy(&block);
+	BF_Block_Destroy(&newBlock);
+
+	// The first key of the new leaf separates it from this one
+	error = BPT_InsertInParents(bpt_info, path, slots, all[left].id, newLeaf);
+	if (error != 0) return -1;
+
+	return position < left ? leaf : newLeaf;
+}
+
+// The node a bulk load is filling on one internal level, kept in memory until it is full
+typedef struct {
+	bool open;
+	int firstKey;		// Smallest key under the node, its separator in the parent
+	int written;		// Nodes of the level written so far
+	char data[BF_BLOCK_SIZE];
+} BPT_bulkLevel;
+
+static int BPT_BulkAdd(BPT_info* bpt_info, BPT_bulkLevel* levels, int level, int key, int child);
+
+// Writes the node of level to a new block and adds it to the level above, or returns it as the root
+static int BPT_BulkFlush(BPT_info* bpt_info, BPT_bulkLevel* levels, int level, bool last) {
+	BF_Block* block;
+	BF_Block_Init(&block);
+	int blockId = BPT_NewNode(bpt_info, block, false);
+	if (blockId == -1) return -1;
+
+	memcpy(BF_Block_GetData(block), levels[level].data, BF_BLOCK_SIZE);
+	BF_Block_SetDirty(block);
+	int error = TC(BF_UnpinBlock(block));
+	if (error != 0) return -1;
+	BF_Block_Destroy(&block);
+
+	levels[level].open = false;
+	levels[level].written++;
+
+	// The only node of the top level is the root
+	if (last && levels[level].written == 1) {
+		bpt_info->root = blockId;
+		bpt_info->height = level + 2;
+		return 0;
+	}
+	return BPT_BulkAdd(bpt_info, levels, level + 1, levels[level].firstKey, blockId);
+}
+
+// Adds child, whose smallest key is key, to the node of level, writing the node first if it is full
+static int BPT_BulkAdd(BPT_info* bpt_info, BPT_bulkLevel* levels, int level, int key, int child) {
+	if (level >= BPT_MAX_HEIGHT - 1) return -1;
+	BPT_bulkLevel* current = &levels[level];
+	BPT_block_info* node = (BPT_block_info*) current->data;
+
+	if (current->open && node->count == bpt_info->keysPerNode)
+		if (BPT_BulkFlush(bpt_info, levels, level, false) != 0) return -1;
+
+	if (!current->open) {
+		memset(current->data, 0, BF_BLOCK_SIZE);
+		node->isLeaf = false;
+		node->count = 0;
+		node->nextBlock = -1;
+		BPT_CHILDREN(current->data)[0] = child;
+		current->firstKey = key;
+		current->open = true;
+		return 0;
+	}
+
+	BPT_KEYS(bpt_info, current->data)[node->count] = key;
+	BPT_CHILDREN(current->data)[node->count + 1] = child;
+	node->count++;
+	return 0;
+}
+
+int BPT_BulkLoad(BPT_info* bpt_info, const Record* records, size_t n) {
+	if (bpt_info->records != 0) return -1;
+	for (size_t i = 1; i < n; i++)
+		if (records[i].id < records[i - 1].id) return -1;
+	if (n == 0) return 0;
+
+	int error;
+	BF_Block* block;
+	BF_Block* newBlock;
+	BF_Block_Init(&block);
+	BF_Block_Init(&newBlock);
+	BPT_bulkLevel* levels = calloc(BPT_MAX_HEIGHT, sizeof(BPT_bulkLevel));
+
+	// The empty root leaf becomes the first leaf, the rest follow it in order
+	int leaf = bpt_info->firstLeaf;
+	error = TC(BF_GetBlock(bpt_info->fileDesc, leaf, block));
+	if (error != 0) return -1;
+	BPT_block_info* node = (BPT_block_info*) BF_Block_GetData(block);
+	int leaves = 1;
+
+	for (size_t i = 0; i < n; i++) {
+		if (node->count == bpt_info->recordsPerLeaf) {
+			int next = BPT_NewNode(bpt_info, newBlock, true);
+			if (next == -1) return -1;
+			node->nextBlock = next;
+			int firstKey = BPT_RECORDS((char*) node)[0].id;
+
+			BF_Block_SetDirty(block);
+			error = TC(BF_UnpinBlock(block));
+			if (error != 0) return -1;
+			if (BPT_BulkAdd(bpt_info, levels, 0, firstKey, leaf) != 0) return -1;
+
+			// Continue in the new leaf, pinned through block from now on
+			BF_Block* swap = block; block = newBlock; newBlock = swap;
+			node = (BPT_block_info*) BF_Block_GetData(block);
+			leaf = next;
+			leaves++;
+		}
+		BPT_RECORDS((char*) node)[node->count++] = records[i];
+	}
+
+	int firstKey = BPT_RECORDS((char*) node)[0].id;
+	BF_Block_SetDirty(block);
+	error = TC(BF_UnpinBlock(block));
+	if (error != 0) return -1;
+
+	// Close every level from the bottom, until one holds a single node, the root
+	if (leaves > 1) {
+		if (BPT_BulkAdd(bpt_info, levels, 0, firstKey, leaf) != 0) return -1;
+		for (int level = 0; levels[level].open; level++)
+			if (BPT_BulkFlush(bpt_info, levels, level, true) != 0) return -1;
+	}
+
+	bpt_info->records = n;
+	free(levels);
+	BF_Block_Destroy(&block);
+	BF_Block_Destroy(&newBlock);
+	return 0;
+}
+
+// Reads the leaves from the first that may hold low, handing every record up to high to callback
+static int BPT_Scan(BPT_info* bpt_info, int low, int high, BPT_Callback callback, void* context) {
+	int blocksRead = 0;
+	int current = BPT_FindLeaf(bpt_info, low, false, NULL, NULL, &blocksRead);
+	if (current == -1) return -1;
+
+	BF_Block* block;
+	BF_Block_Init(&block);
+
+	bool done = false;
+	while (current != -1 && !done) {
+		int error = TC(BF_GetBlock(bpt_info->fileDesc, current, block));
+		if (error != 0) return -1;
+		blocksRead++;
+
+		char* blockData = BF_Block_GetData(block);
+		BPT_block_info* node = (BPT_block_info*) blockData;
+		Record* records = BPT_RECORDS(blockData);
+
+		int i = BPT_RecordPosition(records, node->count, low, false);
+		for (; i < node->count && records[i].id <= high; i++) {
+			if (callback != NULL) callback(&records[i], current, context);
+			else printRecord(records[i]);
+		}
+
+		// The range goes on in the next leaf only if this one ended inside it
+		done = i < node->count;
+		current = node->nextBlock;
+
+		error = TC(BF_UnpinBlock(block));
+		if (error != 0) return -1;
+	}
+
+	BF_Block_Destroy(&block);
+	return blocksRead;
+}
+
+int BPT_GetAllEntries(BPT_info* bpt_info, int* value) {
+	return BPT_Scan(bpt_info, *value, *value, NULL, NULL);
+}
+
+int BPT_RangeScan(BPT_info* bpt_info, int low, int high, BPT_Callback callback, void* context) {
+	if (low > high) return 0;
+	return BPT_Scan(bpt_info, low, high, callback, context);
+}
+
+int TreeStatisticsBPT(char* filename) {
+	BPT_info* info = BPT_OpenFile(filename);
+	if (info == NULL) return -1;
+
+	int blockCounter;
+	BF_GetBlockCounter(info->fileDesc, &blockCounter);
+
+	BF_Block* block;
+	BF_Block_Init(&block);
+
+	// Walk the leaves in order, checking that the keys never go down
+	int leaves = 0, min = -1, max = 0;
+	long int recordsCount = 0;
+	bool ordered = true;
+	int previous = 0;
+	for (int current = info->firstLeaf; current != -1; ) {
+		int error = TC(BF_GetBlock(info->fileDesc, current, block));
+		if (error != 0) return -1;
+
+		char* blockData = BF_Block_GetData(block);
+		BPT_block_info* node = (BPT_block_info*) blockData;
+		Record* records = BPT_RECORDS(blockData);
+		for (int i = 0; i < node->count; i++) {
+			if (recordsCount + i > 0 && records[i].id < previous) ordered = false;
+			previous = records[i].id;
+		}
+
+		leaves++;
+		recordsCount += node->count;
+		if (min == -1 || node->count < min) min = node->count;
+		if (node->count > max) max = node->count;
+		current = node->nextBlock;
+		BF_UnpinBlock(block);
+	}
+
+	BF_Block_Destroy(&block);
+
+	printf("1. Blocks in the file: %d\n", blockCounter);
+	printf("2. Height: %d\n", info->height);
+	printf("3. Leaves: %d, internal nodes: %d\n", leaves, blockCounter - 1 - leaves);
+	printf("4. Total number of records: %ld%s\n", recordsCount, ordered ? "" : " (OUT OF ORDER)");
+	printf("\t Average number of records per leaf: %ld of %d\n", recordsCount / leaves, info->recordsPerLeaf);
+	printf("\t Min number of records in a leaf: %d\n", min);
+	printf("\t Max number of records in a leaf: %d\n", max);
+
+	return BPT_CloseFile(info);
+}
@@ -0,0 +1,482 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "bf.h"
+#include "eh_table.h"
+#include "record.h"
+#include "block_chain.h"
+#include <assert.h>
+
+// 	/*
+// 	Block 0: EH_info, the directory lives in its own chain of blocks
+//
+// 	directory (2^globalDepth entries)				bucket blocks
+// 	_________________								_________________________________
+// 	|	000		|	-|----------------------------->|	EH_block_info	|	Rec[0] ...	|	localDepth = 2
+// 	|	001		|	-|-------------|				|_______________|_______________|
+// 	|	010		|	-|-------------|--------------->|	EH_block_info	|	Rec[0] ...	|	localDepth = 3
+// 	|	011		|	-|-------------|				|_______________|_______________|
+// 	|	100		|	-|-------------|
+// 	|	...		|	 |				 (entries that share the last localDepth bits point to the same bucket)
+// 	|___________|____|
+// 	*/
+
+#define EH_RECORDS(blockData) ((blockData) + sizeof(EH_block_info))
+
+// murmur3 finalizer, so that every bit of the hash depends on every bit of the key
+static unsigned int EH_Hash(int key) {
+	unsigned int h = (unsigned int) key;
+	h ^= h >> 16;
+	h *= 0x85ebca6b;
+	h ^= h >> 13;
+	h *= 0xc2b2ae35;
+	h ^= h >> 16;
+	return h;
+}
+
+static int EH_DirectoryIndex(EH_info* eh_info, int key) {
+	return EH_Hash(key) & ((1u << eh_info->globalDepth) - 1);
+}
+
+// Allocates an empty bucket block, returns its number (or -1) and leaves it pinned in block
+static int EH_AllocateBucket(EH_info* eh_info, BF_Block* block, int localDepth) {
+	int error = TC(BF_AllocateBlock(eh_info->fileDesc, block));
+	if (error != 0) return -1;
+
+	int blockNumber;
+	BF_GetBlockCounter(eh_info->fileDesc, &blockNumber);
+	blockNumber--;
+
+	EH_block_info* blockInfo = (EH_block_info*) BF_Block_GetData(block);
+	blockInfo->localDepth = localDepth;
+	blockInfo->recordsCount = eh_info->recordsPerBlock;
+	blockInfo->currentRecords = 0;
+	blockInfo->nextBlock = -1;
+	BF_Block_SetDirty(block);
+
+	return blockNumber;
+}
+
+static int EH_WriteHeader(EH_info* eh_info) {
+	BF_Block* block;
+	BF_Block_Init(&block);
+
+	int error = TC(BF_GetBlock(eh_info->fileDesc, 0, block));
+	if (error != 0) return -1;
+
+	memcpy(BF_Block_GetData(block), eh_info, sizeof(EH_info));
+	BF_Block_SetDirty(block);
+
+	error = TC(BF_UnpinBlock(block));
+	if (error != 0) return -1;
+
+	BF_Block_Destroy(&block);
+	return 0;
+}
+
+int EH_CreateFile(char *fileName, int depth) {
+	int error;
+	int fileDescriptor;
+
+	if (depth < 0 || depth > EH_MAX_DEPTH) return -1;
+
+	error = TC(BF_CreateFile(fileName));
+	if (error != 0) return -1;
+
+	error = TC(BF_OpenFile(fileName, &fileDescriptor));
+	if (error != 0) return -1;
+
+	BF_Block* block;
+	BF_Block_Init(&block);
+
+	// Reserve block 0 for the header
+	error = TC(BF_AllocateBlock(fileDescriptor, block));
+	if (error != 0) return -1;
+	error = TC(BF_UnpinBlock(block));
+	if (error != 0) return -1;
+
+	EH_info info;
+	info.fileDesc = fileDescriptor;
+	info.isHashFile = true;
+	info.isHeapFile = false;
+	info.recordsPerBlock = (BF_BLOCK_SIZE - sizeof(EH_block_info)) / sizeof(Record);
+	info.globalDepth = depth;
+	info.buckets = 1 << depth;
+	info.directoryBlock = -1;
+	info.directory = malloc(sizeof(int) * info.buckets);
+
+	// One bucket per directory entry to begin with
+	for (int i = 0; i < info.buckets; i++) {
+		info.directory[i] = EH_AllocateBucket(&info, block, depth);
+		if (info.directory[i] == -1) return -1;
+
+		error = TC(BF_UnpinBlock(block));
+		if (error != 0) return -1;
+	}
+
+	error = BC_Write(fileDescriptor, &info.directoryBlock, (char*) info.directory, sizeof(int) * info.buckets);
+	free(info.directory);
+	info.directory = NULL;
+	if (error != 0) return -1;
+
+	error = EH_WriteHeader(&info);
+	if (error != 0) return -1;
+
+	BF_Block_Destroy(&block);
+
+	error = TC(BF_CloseFile(fileDescriptor));
+	if (error != 0) return -1;
+
+	return 0;
+}
+
+EH_info* EH_OpenFile(char *fileName) {
+	int error;
+	int fileDescriptor;
+
+	error = TC(BF_OpenFile(fileName, &fileDescriptor));
+	if (error != 0) return NULL;
+
+	BF_Block* block;
+	BF_Block_Init(&block);
+
+	error = TC(BF_GetBlock(fileDescriptor, 0, block));
+	if (error != 0) return NULL;
+
+	EH_info* infoSaved = (EH_info*) BF_Block_GetData(block);
+
+	// If the file is not a Hash File, return NULL
+	if (infoSaved->isHeapFile || !infoSaved->isHashFile) {
+		BF_UnpinBlock(block);
+		return NULL;
+	}
+
+	EH_info* toReturn = malloc(sizeof(EH_info));
+	memcpy(toReturn, infoSaved, sizeof(EH_info));
+	toReturn->fileDesc = fileDescriptor;
+
+	error = TC(BF_UnpinBlock(block));
+	if (error != 0) return NULL;
+	BF_Block_Destroy(&block);
+
+	// Cache the whole directory, so that a lookup only reads the bucket block
+	int size;
+	error = BC_Read(fileDescriptor, toReturn->directoryBlock, (char**) &toReturn->directory, &size);
+	if (error != 0) return NULL;
+	assert(size == (int) sizeof(int) << toReturn->globalDepth);
+
+	return toReturn;
+}
+
+int EH_CloseFile(EH_info* eh_info) {
+	int error;
+	int fileDescriptor = eh_info->fileDesc;
+
+	// The directory may have doubled since it was read, the chain grows with it
+	error = BC_Write(fileDescriptor, &eh_info->directoryBlock, (char*) eh_info->directory, sizeof(int) << eh_info->globalDepth);
+	if (error != 0) return -1;
+
+	error = EH_WriteHeader(eh_info);
+	if (error != 0) return -1;
+
+	free(eh_info->directory);
+	free(eh_info);
+
+	error = TC(BF_CloseFile(fileDescriptor));
+	if (error != 0) return -1;
+
+	return 0;
+}
+
+// Doubles the directory, every new entry points where its lower half twin does
+static void EH_DoubleDirectory(EH_info* eh_info) {
+	int entries = 1 << eh_info->globalDepth;
+	eh_info->directory = realloc(eh_info->directory, sizeof(int) * entries * 2);
+	memcpy(eh_info->directory + entries, eh_info->directory, sizeof(int) * entries);
+	eh_info->globalDepth++;
+}
+
+// Every record of a bucket and the blocks of its chain, head first
+typedef struct {
+	Record* records;
+	int count;
+	int* blocks;
+	int blockCount;
+} EH_chain;
+
+static int EH_ReadChain(EH_info* eh_info, int bucket, EH_chain* chain) {
+	memset(chain, 0, sizeof(EH_chain));
+	BF_Block* block;
+	BF_Block_Init(&block);
+
+	int error = 0;
+	int current = bucket;
+	while (error == 0 && current != -1) {
+		error = TC(BF_GetBlock(eh_info->fileDesc, current, block));
+		if (error != 0) break;
+
+		EH_block_info* blockInfo = (EH_block_info*) BF_Block_GetData(block);
+		Record* records = realloc(chain->records, sizeof(Record) * (chain->count + blockInfo->currentRecords + 1));
+		if (records != NULL) chain->records = records;
+		int* blocks = realloc(chain->blocks, sizeof(int) * (chain->blockCount + 1));
+		if (blocks != NULL) chain->blocks = blocks;
+
+		if (records == NULL || blocks == NULL) {
+			error = -1;
+		} else {
+			memcpy(records + chain->count, EH_RECORDS((char*) blockInfo), sizeof(Record) * blockInfo->currentRecords);
+			chain->count += blockInfo->currentRecords;
+			blocks[chain->blockCount++] = current;
+			current = blockInfo->nextBlock;
+		}
+
+		if (TC(BF_UnpinBlock(block)) != 0) error = -1;
+	}
+
+	BF_Block_Destroy(&block);
+	return error;
+}
+
+// Writes n records into block blockNumber (a new one if -1), linked to next, and returns its number or -1
+static int EH_WriteBlock(EH_info* eh_info, int blockNumber, const Record* records, int n, int localDepth, int next) {
+	BF_Block* block;
+	BF_Block_Init(&block);
+	if (blockNumber == -1) blockNumber = EH_AllocateBucket(eh_info, block, localDepth);
+	else if (TC(BF_GetBlock(eh_info->fileDesc, blockNumber, block)) != 0) blockNumber = -1;
+	if (blockNumber == -1) {
+		BF_Block_Destroy(&block);
+		return -1;
+	}
+
+	EH_block_info* blockInfo = (EH_block_info*) BF_Block_GetData(block);
+	blockInfo->localDepth = localDepth;
+	blockInfo->recordsCount = eh_info->recordsPerBlock;
+	blockInfo->currentRecords = n;
+	blockInfo->nextBlock = next;
+	memcpy(EH_RECORDS((char*) blockInfo), records, sizeof(Record) * n);
+
+	BF_Block_SetDirty(block);
+	if (TC(BF_UnpinBlock(block)) != 0) blockNumber = -1;
+	BF_Block_Destroy(&block);
+	return blockNumber;
+}
+
+// Spreads the records over the blocks of a chain and returns its head, or -1.
+// The overflow blocks are full and the head keeps what is left, so that inserts fill it first.
+static int EH_WriteChain(EH_info* eh_info, const int* blocks, int blockCount, const Record* records, int n, int localDepth) {
+	int next = -1;
+	for (int i = blockCount - 1; i >= 0; i--) {
+		int count = n < eh_info->recordsPerBlock ? n : eh_info->recordsPerBlock;
+		if (i == 0) count = n;
+		n -= count;
+		next = EH_WriteBlock(eh_info, blocks[i], records + n, count, localDepth, next);
+		if (next == -1) return -1;
+	}
+	return next;
+}
+
+// Splits the bucket reached through directory[index], with every record of its chain,
+// into itself and a new bucket one bit deeper. Its blocks are reused, new ones only if needed.
+static int EH_SplitBucket(EH_info* eh_info, EH_chain* chain, int index, int depth) {
+	if (depth == eh_info->globalDepth)
+		EH_DoubleDirectory(eh_info);
+
+	unsigned int bit = 1u << depth;
+	int perBlock = eh_info->recordsPerBlock;
+
+	// Records whose next hash bit is set move to the new bucket, they go after the ones that stay
+	Record* records = malloc(sizeof(Record) * (chain->count + 1));
+	int* blocks = malloc(sizeof(int) * (chain->blockCount + chain->count / perBlock + 2));
+	if (records == NULL || blocks == NULL) {
+		free(records);
+		free(blocks);
+		return -1;
+	}
+	int kept = 0;
+	for (int i = 0; i < chain->count; i++)
+		if ((EH_Hash(chain->records[i].id) & bit) == 0) records[kept++] = chain->records[i];
+	int moved = kept;
+	for (int i = 0; i < chain->count; i++)
+		if (EH_Hash(chain->records[i].id) & bit) records[moved++] = chain->records[i];
+	moved -= kept;
+
+	// Blocks the chain has beyond what the two halves need stay, empty, with the old bucket
+	int movedBlocks = moved == 0 ? 1 : (moved + perBlock - 1) / perBlock;
+	int keptBlocks = kept == 0 ? 1 : (kept + perBlock - 1) / perBlock;
+	if (keptBlocks < chain->blockCount - movedBlocks) keptBlocks = chain->blockCount - movedBlocks;
+	for (int i = 0; i < keptBlocks + movedBlocks; i++)
+		blocks[i] = i < chain->blockCount ? chain->blocks[i] : -1;
+
+	int error = 0;
+	if (EH_WriteChain(eh_info, blocks, keptBlocks, records, kept, depth + 1) == -1) error = -1;
+	int newBucket = error == 0 ? EH_WriteChain(eh_info, blocks + keptBlocks, movedBlocks, records + kept, moved, depth + 1) : -1;
+	free(records);
+	free(blocks);
+	if (newBucket == -1) return -1;
+
+	// The old bucket is behind every entry that ends in its depth low bits,
+	// those of them with the new bit set now point to the new bucket
+	int entries = 1 << eh_info->globalDepth;
+	for (int i = (index & (bit - 1)) | bit; i < entries; i += 2 * bit)
+		eh_info->directory[i] = newBucket;
+
+	eh_info->buckets++;
+	return 0;
+}
+
+int EH_InsertEntry(EH_info* eh_info, Record record) {
+	int error;
+	BF_Block* block;
+	BF_Block_Init(&block);
+
+	while ( true ) {
+		int index = EH_DirectoryIndex(eh_info, record.id);
+		int bucket = eh_info->directory[index];
+
+		error = TC(BF_GetBlock(eh_info->fileDesc, bucket, block));
+		if (error != 0) break;
+
+		EH_block_info* blockInfo = (EH_block_info*) BF_Block_GetData(block);
+
+		// If record fits in the bucket, just place it inside
+		if (blockInfo->currentRecords < blockInfo->recordsCount) {
+			Record* records = (Record*) EH_RECORDS((char*) blockInfo);
+			records[blockInfo->currentRecords++] = record;
+			BF_Block_SetDirty(block);
+
+			error = TC(BF_UnpinBlock(block));
+			BF_Block_Destroy(&block);
+			return error != 0 ? -1 : bucket;
+		}
+
+		int depth = blockInfo->localDepth;
+		error = TC(BF_UnpinBlock(block));
+		if (error != 0) break;
+
+		// Splitting helps unless every record agrees on all the bits a split could still use, as equal ids do.
+		// Records that only differ in a deeper bit take more than one split, the loop splits again.
+		EH_chain chain;
+		error = EH_ReadChain(eh_info, bucket, &chain);
+		bool separates = false;
+		unsigned int bits = ((1u << EH_MAX_DEPTH) - 1) & ~((1u << depth) - 1);
+		unsigned int side = EH_Hash(record.id) & bits;
+		for (int i = 0; i < chain.count && !separates; i++)
+			separates = (EH_Hash(chain.records[i].id) & bits) != side;
+
+		if (error == 0 && separates && depth < EH_MAX_DEPTH) {
+			// Split and try again, the record may land in either half (or split again)
+			error = EH_SplitBucket(eh_info, &chain, index, depth);
+			free(chain.records);
+			free(chain.blocks);
+			if (error != 0) break;
+			continue;
+		}
+		free(chain.records);
+		free(chain.blocks);
+		if (error != 0) break;
+
+		// Otherwise an overflow block goes in front of the bucket, with the same depth
+		int newBucket = EH_WriteBlock(eh_info, -1, &record, 1, depth, bucket);
+		if (newBucket == -1) break;
+
+		int entries = 1 << eh_info->globalDepth;
+		int step = 1 << depth;
+		for (int i = index & (step - 1); i < entries; i += step)
+			eh_info->directory[i] = newBucket;
+
+		BF_Block_Destroy(&block);
+		return newBucket;
+	}
+
+	BF_Block_Destroy(&block);
+	return -1;
+}
+
+int EH_GetAllEntries(EH_info* eh_info, int* value) {
+	int error;
+	int blocksRead = 0;
+	BF_Block* block;
+	BF_Block_Init(&block);
+
+	int current = eh_info->directory[EH_DirectoryIndex(eh_info, *value)];
+
+	while (current != -1) {
+		error = TC(BF_GetBlock(eh_info->fileDesc, current, block));
+		if (error != 0) return -1;
+		blocksRead++;
+
+		EH_block_info* blockInfo = (EH_block_info*) BF_Block_GetData(block);
+		Record* records = (Record*) EH_RECORDS((char*) blockInfo);
+
+		for (int i = 0; i < blockInfo->currentRecords; i++)
+			if (records[i].id == *value)
+				printRecord(records[i]);
+
+		current = blockInfo->nextBlock;
+
+		error = TC(BF_UnpinBlock(block));
+		if (error != 0) return -1;
+	}
+
+	BF_Block_Destroy(&block);
+	return blocksRead;
+}
+
+int HashStatisticsEH(char* filename) {
+	EH_info* info = EH_OpenFile(filename);
+	if (info == NULL) return -1;
+
+	int blockCounter;
+	BF_GetBlockCounter(info->fileDesc, &blockCounter);
+
+	BF_Block* block;
+	BF_Block_Init(&block);
+
+	int entries = 1 << info->globalDepth;
+	int recordsCount = 0;
+	int min = -1, max = 0;
+	int overflowBlocks = 0;
+
+	// Every bucket is first met at the directory entry equal to its own low bits
+	for (int i = 0; i < entries; i++) {
+		int current = info->directory[i];
+		int recordsInBucket = 0;
+		bool first = true;
+
+		while (current != -1) {
+			int error = TC(BF_GetBlock(info->fileDesc, current, block));
+			if (error != 0) return -1;
+
+			EH_block_info* blockInfo = (EH_block_info*) BF_Block_GetData(block);
+			if (first && i >= (1 << blockInfo->localDepth)) {
+				BF_UnpinBlock(block);
+				break;
+			}
+			if (!first) overflowBlocks++;
+			first = false;
+
+			recordsInBucket += blockInfo->currentRecords;
+			current = blockInfo->nextBlock;
+			BF_UnpinBlock(block);
+		}
+
+		if (first) continue;	// Already counted through a lower entry
+		recordsCount += recordsInBucket;
+		if (min == -1 || recordsInBucket < min) min = recordsInBucket;
+		if (recordsInBucket > max) max = recordsInBucket;
+	}
+
+	BF_Block_Destroy(&block);
+
+	printf("1. Blocks in the file: %d\n", blockCounter);
+	printf("2. Global depth: %d (%d directory entries)\n", info->globalDepth, entries);
+	printf("3. Buckets: %d\n", info->buckets);
+	printf("4. Total number of records: %d\n", recordsCount);
+	printf("\t Average number of records per bucket: %d\n", recordsCount / info->buckets);
+	printf("\t Min number of records in a bucket: %d\n", min);
+	printf("\t Max number of records in a bucket: %d\n", max);
+	printf("5. Overflow blocks: %d\n", overflowBlocks);
+
+	return EH_CloseFile(info);
+}
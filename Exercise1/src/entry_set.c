@@ -0,0 +1,116 @@
+#include <stdlib.h>
+#include <stdbool.h>
+
+#include "entry_set.h"
+
+typedef struct {
+	unsigned long long key;
+	int value;		// -1 for an empty slot
+} ES_slot;
+
+struct Entry_Set {
+	ES_slot* slots;
+	unsigned int capacity;	// A power of 2
+	unsigned int count;
+};
+
+// The set doubles once it is half full, so probe sequences stay short
+#define ES_INITIAL_CAPACITY 64
+
+static unsigned int ES_Home(const Entry_Set* set, unsigned long long key, int value) {
+	unsigned long long h = key ^ ((unsigned long long) (unsigned int) value * 0x9e3779b97f4a7c15ull);
+	h ^= h >> 33;
+	h *= 0xff51afd7ed558ccdull;
+	h ^= h >> 33;
+	return (unsigned int) h & (set->capacity - 1);
+}
+
+static ES_slot* ES_AllocateSlots(unsigned int capacity) {
+	ES_slot* slots = malloc(sizeof(ES_slot) * capacity);
+	if (slots == NULL) return NULL;
+	for (unsigned int i = 0; i < capacity; i++)
+		slots[i].value = -1;
+	return slots;
+}
+
+Entry_Set* ES_Create(void) {
+	Entry_Set* set = malloc(sizeof(Entry_Set));
+	if (set == NULL) return NULL;
+	set->capacity = ES_INITIAL_CAPACITY;
+	set->count = 0;
+	set->slots = ES_AllocateSlots(set->capacity);
+	if (set->slots == NULL) {
+		free(set);
+		return NULL;
+	}
+	return set;
+}
+
+void ES_Destroy(Entry_Set* set) {
+	if (set == NULL) return;
+	free(set->slots);
+	free(set);
+}
+
+// The slot of the pair, or the empty slot where it would go
+static unsigned int ES_Find(const Entry_Set* set, unsigned long long key, int value) {
+	unsigned int i = ES_Home(set, key, value);
+	while (set->slots[i].value != -1 && (set->slots[i].key != key || set->slots[i].value != value))
+		i = (i + 1) & (set->capacity - 1);
+	return i;
+}
+
+static int ES_Grow(Entry_Set* set) {
+	ES_slot* old = set->slots;
+	unsigned int oldCapacity = set->capacity;
+
+	set->slots = ES_AllocateSlots(2 * oldCapacity);
+	if (set->slots == NULL) {
+		set->slots = old;
+		return -1;
+	}
+	set->capacity = 2 * oldCapacity;
+
+	for (unsigned int i = 0; i < oldCapacity; i++)
+		if (old[i].value != -1)
+			set->slots[ES_Find(set, old[i].key, old[i].value)] = old[i];
+	free(old);
+	return 0;
+}
+
+int ES_Insert(Entry_Set* set, unsigned long long key, int value) {
+	if (2 * (set->count + 1) > set->capacity && ES_Grow(set) != 0) return -1;
+
+	unsigned int i = ES_Find(set, key, value);
+	if (set->slots[i].value != -1) return 0;
+
+	set->slots[i].key = key;
+	set->slots[i].value = value;
+	set->count++;
+	return 1;
+}
+
+int ES_Contains(const Entry_Set* set, unsigned long long key, int value) {
+	return set->slots[ES_Find(set, key, value)].value != -1;
+}
+
+void ES_Remove(Entry_Set* set, unsigned long long key, int value) {
+	unsigned int mask = set->capacity - 1;
+	unsigned int hole = ES_Find(set, key, value);
+	if (set->slots[hole].value == -1) return;
+
+	// Later pairs of the probe sequence move back into the hole, so no search stops short of them
+	unsigned int i = hole;
+	while ( true ) {
+		i = (i + 1) & mask;
+		if (set->slots[i].value == -1) break;
+
+		unsigned int home = ES_Home(set, set->slots[i].key, set->slots[i].value);
+		if (((i - home) & mask) >= ((i - hole) & mask)) {
+			set->slots[hole] = set->slots[i];
+			hole = i;
+		}
+	}
+	set->slots[hole].value = -1;
+	set->count--;
+}
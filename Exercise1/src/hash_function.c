@@ -0,0 +1,193 @@
+#include <stdint.h>
+#include <string.h>
+#include <assert.h>
+
+#include "hash_function.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <nmmintrin.h>
+#define HF_HAVE_SSE42_TARGET
+#endif
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#define XXH_PRIME1 0x9E3779B1u
+#define XXH_PRIME2 0x85EBCA77u
+#define XXH_PRIME3 0xC2B2AE3Du
+#define XXH_PRIME4 0x27D4EB2Fu
+#define XXH_PRIME5 0x165667B1u
+
+#define CRC32C_POLY 0x82F63B78u	// Castagnoli polynomial, bit-reflected
+
+static const char* functionNames[HASH_FUNCTIONS] = { "default", "fibonacci", "murmur", "xxhash", "crc32c" };
+
+const char* HF_Name(Hash_Function function) {
+	if (function < 0 || function >= HASH_FUNCTIONS) return "unknown";
+	return functionNames[function];
+}
+
+static inline uint32_t rotl32(uint32_t x, int r) {
+	return (x << r) | (x >> (32 - r));
+}
+
+static inline uint32_t read32(const unsigned char* p) {
+	uint32_t v;
+	memcpy(&v, p, sizeof(v));	// Unaligned read
+	return v;
+}
+
+static uint32_t djb2(const char* value) {
+	uint32_t hash = 5381;
+	for (const char* s = value; *s != '\0'; s++)
+		hash = (hash << 5) + hash + *s;		// hash * 33 + c
+	return hash;
+}
+
+// 2^64 / golden ratio, the high half of the product mixes every bit of the key
+static uint32_t fibonacci(uint32_t key) {
+	return (uint32_t) (((uint64_t) key * 0x9E3779B97F4A7C15ull) >> 32);
+}
+
+// murmur3 finalizer
+static uint32_t fmix32(uint32_t h) {
+	h ^= h >> 16;
+	h *= 0x85ebca6b;
+	h ^= h >> 13;
+	h *= 0xc2b2ae35;
+	h ^= h >> 16;
+	return h;
+}
+
+static inline uint32_t xxhRound(uint32_t acc, uint32_t input) {
+	acc += input * XXH_PRIME2;
+	acc = rotl32(acc, 13);
+	return acc * XXH_PRIME1;
+}
+
+static uint32_t xxhash32(const unsigned char* p, size_t len) {
+	const unsigned char* end = p + len;
+	uint32_t h;
+
+	if (len >= 16) {
+		uint32_t v1 = XXH_PRIME1 + XXH_PRIME2, v2 = XXH_PRIME2, v3 = 0, v4 = -XXH_PRIME1;
+		for (; p + 16 <= end; p += 16) {
+			v1 = xxhRound(v1, read32(p));
+			v2 = xxhRound(v2, read32(p + 4));
+			v3 = xxhRound(v3, read32(p + 8));
+			v4 = xxhRound(v4, read32(p + 12));
+		}
+		h = rotl32(v1, 1) + rotl32(v2, 7) + rotl32(v3, 12) + rotl32(v4, 18);
+	} else {
+		h = XXH_PRIME5;
+	}
+	h += (uint32_t) len;
+
+	for (; p + 4 <= end; p += 4)
+		h = rotl32(h + read32(p) * XXH_PRIME3, 17) * XXH_PRIME4;
+	for (; p < end; p++)
+		h = rotl32(h + (*p) * XXH_PRIME5, 11) * XXH_PRIME1;
+
+	// Avalanche
+	h ^= h >> 15;
+	h *= XXH_PRIME2;
+	h ^= h >> 13;
+	h *= XXH_PRIME3;
+	h ^= h >> 16;
+	return h;
+}
+
+static uint32_t crc32cSoftware(const unsigned char* p, size_t len) {
+	uint32_t crc = ~0u;
+	for (size_t i = 0; i < len; i++) {
+		crc ^= p[i];
+		for (int bit = 0; bit < 8; bit++)
+			crc = (crc >> 1) ^ (CRC32C_POLY & -(crc & 1));
+	}
+	return ~crc;
+}
+
+#ifdef HF_HAVE_SSE42_TARGET
+// Eight bytes per crc32 instruction, then the tail one byte at a time
+__attribute__((target("sse4.2")))
+static uint32_t crc32cHardware(const unsigned char* p, size_t len) {
+	uint64_t crc = ~0u;
+#if defined(__x86_64__)
+	for (; len >= 8; p += 8, len -= 8) {
+		uint64_t v;
+		memcpy(&v, p, sizeof(v));
+		crc = _mm_crc32_u64(crc, v);
+	}
+#endif
+	uint32_t crc32 = (uint32_t) crc;
+	for (; len > 0; p++, len--)
+		crc32 = _mm_crc32_u8(crc32, *p);
+	return ~crc32;
+}
+#endif
+
+static uint32_t crc32c(const unsigned char* p, size_t len) {
+#ifdef HF_HAVE_SSE42_TARGET
+	static int hardware = -1;	// Checked once, the answer never changes
+	if (hardware == -1)
+		hardware = __builtin_cpu_supports("sse4.2") ? 1 : 0;
+	if (hardware)
+		return crc32cHardware(p, len);
+#endif
+	return crc32cSoftware(p, len);
+}
+
+unsigned int HF_HashInt(Hash_Function function, int key) {
+	uint32_t k = (uint32_t) key;
+	switch (function) {
+		case FIBONACCI_HASH:	return fibonacci(k);
+		case MURMUR_HASH:		return fmix32(k);
+		case XXHASH:			return xxhash32((const unsigned char*) &k, sizeof(k));
+		case CRC32C_HASH:		return crc32c((const unsigned char*) &k, sizeof(k));
+		default:				return k;
+	}
+}
+
+unsigned int HF_HashString(Hash_Function function, const char* value) {
+	switch (function) {
+		case FIBONACCI_HASH:	return fibonacci(djb2(value));
+		case MURMUR_HASH:		return fmix32(djb2(value));
+		case XXHASH:			return xxhash32((const unsigned char*) value, strlen(value));
+		case CRC32C_HASH:		return crc32c((const unsigned char*) value, strlen(value));
+		default:				return djb2(value);
+	}
+}
+
+unsigned int HF_Reduce(Hash_Function function, unsigned int hash, int buckets) {
+	if (function == DEFAULT_HASH)
+		return hash % buckets;
+	if ((buckets & (buckets - 1)) == 0)
+		return hash & (buckets - 1);
+	return (unsigned int) (((uint64_t) hash * (uint32_t) buckets) >> 32);
+}
+
+unsigned char HF_Fingerprint(unsigned int hash) {
+	// The top byte after re-mixing, buckets are picked by the low bits or by the whole hash
+	return fmix32(hash ^ 0x5bd1e995) >> 24;
+}
+
+unsigned long long HF_MatchTags(const unsigned char* tags, int count, unsigned char tag) {
+	// Every tag takes a bit of the mask, the shifts below are undefined past 63
+	assert(count >= 0 && count <= 64);
+	unsigned long long matches = 0;
+#if defined(__SSE2__)
+	__m128i wanted = _mm_set1_epi8((char) tag);
+	for (int i = 0; i < count; i += 16) {
+		__m128i group = _mm_loadu_si128((const __m128i*) (tags + i));
+		unsigned int bits = _mm_movemask_epi8(_mm_cmpeq_epi8(group, wanted));
+		matches |= (unsigned long long) bits << i;
+	}
+#else
+	for (int i = 0; i < count; i++)
+		if (tags[i] == tag) matches |= 1ull << i;
+#endif
+	// Lanes past count hold no entry
+	if (count < 64) matches &= (1ull << count) - 1;
+	return matches;
+}
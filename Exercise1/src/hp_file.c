@@ -5,6 +5,8 @@
 #include "bf.h"
 #include "hp_file.h"
 #include "record.h"
+#include "block_chain.h"
+#include "slotted_page.h"
 #include <assert.h>
 
 #define CALL_BF(call)       \
@@ -16,7 +18,59 @@
   }                         \
 }
 
+// Records are kept in the part of a block before its HP_block_info
+#define HP_RECORD_AREA_SIZE (BF_BLOCK_SIZE - (int) sizeof(HP_block_info))
+#define HP_BLOCK_INFO(data) ((HP_block_info*) ((data) + HP_RECORD_AREA_SIZE))
+
+// Initializes an empty record block, the last one of the file
+static void HP_InitBlock(HP_info* hp_info, char* data) {
+	HP_block_info* info = HP_BLOCK_INFO(data);
+	info->currentRecords = 0;
+	info->nextBlock = -1;
+	info->recordsCount = hp_info->recordsPerBlock;
+
+	if (hp_info->format == SLOTTED_FORMAT)
+		SP_Init(data, HP_RECORD_AREA_SIZE);
+}
+
+// Places an already stored record of size bytes in the block, returns -1 if it does not fit
+static int HP_PlaceRecord(HP_info* hp_info, char* data, char* stored, int size) {
+	HP_block_info* info = HP_BLOCK_INFO(data);
+
+	if (hp_info->format == SLOTTED_FORMAT) {
+		if (SP_Insert(data, stored, size) == -1) return -1;
+		info->currentRecords = SP_Slots(data);
+		return 0;
+	}
+
+	if (info->currentRecords >= hp_info->recordsPerBlock) return -1;
+	memcpy(data + info->currentRecords * size, stored, size);
+	info->currentRecords++;
+	return 0;
+}
+
+// Reads the i-th record of the block, returns -1 if its slot is empty
+static int HP_BlockRecord(HP_info* hp_info, char* data, int i, Record* record) {
+	char* src;
+
+	if (hp_info->format == SLOTTED_FORMAT) {
+		int length;
+		src = SP_Get(data, i, &length);
+		if (src == NULL) return -1;
+	} else {
+		src = data + i * recordSize(hp_info->format);
+	}
+
+	*record = loadRecord(hp_info->format, hp_info->dictionary, src);
+	return 0;
+}
+
 int HP_CreateFile(char *fileName){
+	HP_options options = { 0 };
+	return HP_CreateFileWithOptions(fileName, options);
+}
+
+int HP_CreateFileWithOptions(char *fileName, HP_options options){
 
 	/*
 	Record block structure:
@@ -59,14 +113,19 @@ int HP_CreateFile(char *fileName){
 	info.headerPosition = oldBlockCounter;
 	info.isHash = false;
 	info.isHeapFile = true;
-	info.recordsPerBlock = ( sizeof(char) * BF_BLOCK_SIZE - sizeof(HP_block_info ) ) / sizeof(Record);
+	info.format = options.format;
+	if (info.format == SLOTTED_FORMAT)	// At least this many, shorter records fit more
+		info.recordsPerBlock = ( HP_RECORD_AREA_SIZE - sizeof(SP_header) ) / ( recordSize(info.format) + sizeof(SP_slot) );
+	else
+		info.recordsPerBlock = HP_RECORD_AREA_SIZE / recordSize(info.format);
 	info.lastBlock = -1;
 	info.nextBlock = -1;
+	info.dictionaryBlock = -1;	// The dictionary chain is written on close
+	info.dictionary = NULL;
 
 	printf("Records per block = %d\n", info.recordsPerBlock);
 	
-	error += TC(BF_GetBlock(fileDescriptor, blockCounter - 1, block));
-	if (error != 0) return -1;
+	// The allocated block is still pinned, write the header straight into it
 	data = BF_Block_GetData(block);
 	
 	memcpy(data, &info, sizeof(HP_info));
@@ -80,6 +139,7 @@ int HP_CreateFile(char *fileName){
 	error = TC(BF_CloseFile(fileDescriptor));
 	if (error == -1 ) return -1;
 
+	return 0;
 }
 
 HP_info* HP_OpenFile(char *fileName){
@@ -105,11 +165,24 @@ HP_info* HP_OpenFile(char *fileName){
 
 	memcpy(toReturn, infoSaved, sizeof(HP_info));
 	toReturn->fileDesc = fileDescriptor;
+	toReturn->dictionary = NULL;
 
 	error = TC(BF_UnpinBlock(block));
 	if (error == -1) return NULL;
 	BF_Block_Destroy(&block);
 
+	// Encoded files keep their dictionary in memory while open
+	if (toReturn->format == ENCODED_FORMAT) {
+		toReturn->dictionary = calloc(1, sizeof(Record_Dictionary));
+		if (toReturn->dictionaryBlock != -1) {
+			char* serialized; int size;
+			error = BC_Read(fileDescriptor, toReturn->dictionaryBlock, &serialized, &size);
+			if (error == -1) return NULL;
+			deserializeDictionary(toReturn->dictionary, serialized, size);
+			free(serialized);
+		}
+	}
+
 	return toReturn;
 }
 
@@ -119,9 +192,18 @@ int HP_CloseFile( HP_info* hp_info ){
 	BF_Block* block;	BF_Block_Init(&block);
 	int error;	
 
+	// Write back the dictionary before the header, which records where it starts
+	if (hp_info->format == ENCODED_FORMAT) {
+		int size;
+		char* serialized = serializeDictionary(hp_info->dictionary, &size);
+		error = BC_Write(fileDescriptor, &hp_info->dictionaryBlock, serialized, size);
+		free(serialized);
+		if (error == -1) return -1;
+	}
+
 	BF_GetBlock(fileDescriptor, 0, block); // Get the first block
 	char* data = BF_Block_GetData(block); 	// Get the data of the first block
-	memcpy(data, hp_info, sizeof(hp_info)); // Copy the data from the hp_info struct to the first block
+	memcpy(data, hp_info, sizeof(HP_info)); // Copy the data from the hp_info struct to the first block
 
 	BF_Block_SetDirty(block);
 	error = TC(BF_UnpinBlock(block));
@@ -129,6 +211,7 @@ int HP_CloseFile( HP_info* hp_info ){
 
 	BF_Block_Destroy(&block);
 
+	free(hp_info->dictionary);
 	free(hp_info); // Free the memory of the hp_info struct
 	
 	error = TC(BF_CloseFile(fileDescriptor));
@@ -170,10 +253,15 @@ int HP_InsertEntry(HP_info* hp_info, Record record){
 
 	fileDescriptor = hp_info->fileDesc;
 
+	// Convert the record to the file's format before touching any block
+	char stored[sizeof(Record)];
+	int size = storeRecord(hp_info->format, hp_info->dictionary, record, stored);
+	if (size == -1) return -1;
+
 	error = TC(BF_GetBlockCounter(fileDescriptor, &blockCounter));
 
-	// Only the header metadata block is present
-	if (blockCounter == 1) {
+	// No blocks for records yet (only the header, and maybe a dictionary chain)
+	if (hp_info->lastBlock == -1) {
 		printf("Inserting record, no blocks for records yet\n");
 		int blockCounter;
 		int nextBlock;
@@ -189,22 +277,12 @@ int HP_InsertEntry(HP_info* hp_info, Record record){
 		hp_info->nextBlock = blockCounter - 1;
 		nextBlock = hp_info->nextBlock;
 
-		// Now get the new allocated block, saved at blockCounter - 1 position
-		error = TC(BF_GetBlock(fileDescriptor, blockCounter-1, block));
+		// The new allocated block, saved at blockCounter - 1 position, is already pinned
 		data = BF_Block_GetData(block);
 
-		HP_block_info blockInfo;
-		blockInfo.nextBlock = -1;
-		blockInfo.currentRecords = 1;
-		blockInfo.recordsCount = ( sizeof(char) * BF_BLOCK_SIZE - sizeof(HP_block_info) ) / sizeof(Record);
-
-		// Copy the records inside
-		memcpy(data, &record, sizeof(Record) );
-		Record recInserted =  *( (Record*) data);
-
-		// Go to the end minus 2 ints, to place how many records the block stores
-		data += sizeof(char) * BF_BLOCK_SIZE - sizeof(HP_block_info);
-		memcpy(data, &blockInfo, sizeof(HP_block_info));
+		// Place the HP_block_info at the end, then copy the record inside
+		HP_InitBlock(hp_info, data);
+		HP_PlaceRecord(hp_info, data, stored, size);
 		
 		printf("Successfuly inserted: \n");
 		printf("%d \t\t %s \t %s \t %s \n", record.id, record.name, record.surname, record.city);
@@ -231,24 +309,13 @@ int HP_InsertEntry(HP_info* hp_info, Record record){
 		HP_block_info read = (HP_block_info) * ( (HP_block_info*) data);
 		
 		int nextBlock = read.nextBlock;
-		int recordsInsideBlock = read.currentRecords;
-
-		data = sizeof(Record) * recordsInsideBlock + dataInit;
 
-		if (recordsInsideBlock < hp_info->recordsPerBlock) {
-			// We have less records inside the block
-			// than a block can take, then we can attach it to
-			// the current block
-
-			// Copy the record in the free spot
-			memcpy(data, &record, sizeof(Record));
+		// Copy the record in the free spot, if we have less records inside the block
+		// than a block can take, then we can attach it to the current block
+		if (HP_PlaceRecord(hp_info, dataInit, stored, size) == 0) {
 
 			// Now go the position of the HP_block_info
-			data = dataInit + sizeof(char) * BF_BLOCK_SIZE - (sizeof(HP_block_info));
-			HP_block_info* newInfo = (HP_block_info*) data;
-
-			// Increment the records saved inside the block
-			newInfo->currentRecords++;
+			HP_block_info* newInfo = HP_BLOCK_INFO(dataInit);
 
 			// Since the record is always added in the last block, its next must not exist
 			assert(newInfo->nextBlock == -1);
@@ -276,24 +343,13 @@ int HP_InsertEntry(HP_info* hp_info, Record record){
 
 			data = BF_Block_GetData(allocatedBlock);
 			
-			// Copy record
-			memcpy(data, &record, sizeof(Record));
+			// Create the block_info for the newly allocated block (no next block), and copy the record
+			HP_InitBlock(hp_info, data);
+			HP_PlaceRecord(hp_info, data, stored, size);
 
 			printf("Successfuly inserted: \n");
 			printf("%d \t\t %s \t %s \t %s \n", record.id, record.name, record.surname, record.city);
 
-			// Go the HP_block_info position
-			data += sizeof(char) * BF_BLOCK_SIZE - sizeof(HP_block_info);
-			
-			// Create the block_info for the newly allocated block
-			HP_block_info info;
-			info.currentRecords = 1;	// It only has 1 record inside, the one inserted above
-			info.nextBlock = -1;		// And no next block
-			info.recordsCount = (sizeof(char) * BF_BLOCK_SIZE - sizeof(HP_block_info) ) / sizeof(Record);
-			
-			// Copy the block_info in the block
-			memcpy(data, &info, sizeof(HP_block_info));
-
 			BF_Block_SetDirty(allocatedBlock);
 			error = TC(BF_UnpinBlock(allocatedBlock));
 			if (error != 0) return -1;
@@ -339,6 +395,10 @@ int HP_InsertEntry(HP_info* hp_info, Record record){
 
 			BF_Block_Destroy(&oldLast);
 
+			// The full last block was only read, release it
+			error = TC(BF_UnpinBlock(lBlock));
+			if (error != 0) return -1;
+
 			BF_Block_Destroy(&block);
 			BF_Block_Destroy(&lBlock);
 			BF_Block_Destroy(&allocatedBlock);
@@ -386,7 +446,8 @@ int HP_GetAllEntries(HP_info* hp_info, int value){
 		data = dataInit;
 
 		for (int i = 0; i < recordsInBlock; i++) {
-			Record recInside = *((Record*) data);
+			Record recInside;
+			if (HP_BlockRecord(hp_info, dataInit, i, &recInside) != 0) continue;
 			
 			if (recInside.id == value) {
 				found = true;
@@ -394,7 +455,6 @@ int HP_GetAllEntries(HP_info* hp_info, int value){
 				printf("%d \t\t %s \t %s \t %s \n", recInside.id, recInside.name, recInside.surname, recInside.city);
 				break;
 			}
-			data += sizeof(Record);
 		}
 
 		BF_UnpinBlock(block);
@@ -406,12 +466,3 @@ int HP_GetAllEntries(HP_info* hp_info, int value){
 	BF_Block_Destroy(&block);
 	return (found) ? blocksRead : -1;
 }
-
-int TC(BF_ErrorCode error) {
-    if (error != BF_OK) {
-        BF_PrintError(error);
-        return (-1);
-    } else {
-        return 0;
-    }
-}
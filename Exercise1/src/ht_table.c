@@ -5,6 +5,12 @@
 #include "bf.h"
 #include "ht_table.h"
 #include "record.h"
+#include "block_chain.h"
+#include "slotted_page.h"
+#include "hash_function.h"
+#include "bloom_filter.h"
+#include "record_key.h"
+#include "latch.h"
 #include <assert.h>
 
 #define CALL_OR_DIE(call)     \
@@ -16,15 +22,6 @@
     }                         \
   }
 
-int TC(BF_ErrorCode error) {
-    if (error != BF_OK) {
-        BF_PrintError(error);
-        return (-1);
-    } else {
-        return 0;
-    }
-}
-
 
 // 	/*
 // 	Block allocated: 1 (0)
@@ -53,10 +50,113 @@ int TC(BF_ErrorCode error) {
 // 	block that stored info for buckets that land in [0]
 // 	*/
 
+// The part of a bucket block after its HT_block_info, where records are kept
+#define HT_RECORD_AREA(blockData) ((blockData) + sizeof(HT_block_info))
+#define HT_RECORD_AREA_SIZE (BF_BLOCK_SIZE - (int) sizeof(HT_block_info))
+
+// With fingerprints the area starts with one tag per record, followed by the records
+#define HT_TAGS(blockData) ((unsigned char*) HT_RECORD_AREA(blockData))
+#define HT_RECORDS(ht_info, blockData) (HT_RECORD_AREA(blockData) + (ht_info)->tagBytes)
+
+// Initializes an empty bucket block that continues to nextBlock
+static void HT_InitBlock(HT_info* ht_info, char* blockData, int nextBlock) {
+	HT_block_info* blockInfo = (HT_block_info*) blockData;
+	blockInfo->recordsCount = ht_info->recordsPerBlock;
+	blockInfo->currentRecords = 0;
+	blockInfo->nextBlock = nextBlock;
+
+	if (ht_info->format == SLOTTED_FORMAT)
+		SP_Init(HT_RECORD_AREA(blockData), HT_RECORD_AREA_SIZE);
+}
+
+// Places an already stored record of size bytes and its fingerprint in the block. Returns its slot, or -1 if it does not fit
+static int HT_PlaceRecord(HT_info* ht_info, char* blockData, char* stored, int size, unsigned char tag) {
+	HT_block_info* blockInfo = (HT_block_info*) blockData;
+
+	if (ht_info->format == SLOTTED_FORMAT) {
+		char* page = HT_RECORD_AREA(blockData);
+		int slot = SP_Insert(page, stored, size);
+		if (slot == -1) return -1;
+		blockInfo->currentRecords = SP_Slots(page);
+		return slot;
+	}
+
+	if (blockInfo->currentRecords >= blockInfo->recordsCount) return -1;
+	memcpy(HT_RECORDS(ht_info, blockData) + blockInfo->currentRecords * size, stored, size);
+	if (ht_info->tagBytes > 0)
+		HT_TAGS(blockData)[blockInfo->currentRecords] = tag;
+	return blockInfo->currentRecords++;
+}
+
+int HT_BlockRecord(HT_info* ht_info, char* blockData, int i, Record* record) {
+	char* data;
+
+	if (ht_info->format == SLOTTED_FORMAT) {
+		int length;
+		data = SP_Get(HT_RECORD_AREA(blockData), i, &length);
+		if (data == NULL) return -1;	// Empty slot
+	} else {
+		data = HT_RECORDS(ht_info, blockData) + i * recordSize(ht_info->format);
+	}
+
+	// Concurrent inserts may grow the dictionary
+	if (ht_info->format == ENCODED_FORMAT) LATCH_LockFile(ht_info->latches);
+	*record = loadRecord(ht_info->format, ht_info->dictionary, data);
+	if (ht_info->format == ENCODED_FORMAT) LATCH_UnlockFile(ht_info->latches);
+	return 0;
+}
+
+// Pins a block for a chain in block, a freed one if there is any, else a new one. Returns its number, or -1
+static int HT_NewBlock(HT_info* ht_info, BF_Block* block) {
+	LATCH_LockFile(ht_info->latches);	// The free list is shared by every bucket
+	int blockId = ht_info->freeBlock;
+	if (blockId != -1) {
+		if (TC(LATCH_GetBlock(ht_info->fileDesc, blockId, block)) != 0) blockId = -1;
+		else ht_info->freeBlock = ((HT_block_info*) BF_Block_GetData(block))->nextBlock;
+	} else if (TC(LATCH_AllocateBlock(ht_info->fileDesc, block, &blockId)) != 0) {
+		blockId = -1;
+	}
+	LATCH_UnlockFile(ht_info->latches);
+	return blockId;
+}
+
+// Removes the i-th record of the block. In the fixed layouts the last record takes its place
+static void HT_RemoveRecord(HT_info* ht_info, char* blockData, int i) {
+	HT_block_info* blockInfo = (HT_block_info*) blockData;
+
+	if (ht_info->format == SLOTTED_FORMAT) {
+		char* page = HT_RECORD_AREA(blockData);
+		SP_Delete(page, i);
+		blockInfo->currentRecords = SP_Slots(page);	// Trailing empty slots are dropped
+		return;
+	}
+
+	int size = recordSize(ht_info->format);
+	int last = blockInfo->currentRecords - 1;
+	if (i != last) {
+		memcpy(HT_RECORDS(ht_info, blockData) + i * size, HT_RECORDS(ht_info, blockData) + last * size, size);
+		if (ht_info->tagBytes > 0)
+			HT_TAGS(blockData)[i] = HT_TAGS(blockData)[last];
+	}
+	blockInfo->currentRecords--;
+}
+
+static int HT_Lookup(HT_info* ht_info, const Record* key, bool print, Record* found, int* foundBlock);
+
 int HT_CreateFile(char *fileName,  int buckets){
+	HT_options options = { 0 };
+	return HT_CreateFileWithOptions(fileName, buckets, options);
+}
+
+int HT_CreateFileWithOptions(char *fileName,  int buckets, HT_options options){
 
 	int error;
 
+	if (options.filterBytes < 0 || options.filterBytes > BF_BLOCK_SIZE) return -1;
+	if (options.fingerprints && options.format == SLOTTED_FORMAT) return -1;
+	Record_Key key = options.key == 0 ? RECORD_KEY(ID) : options.key;
+	if (RK_Operations(key) == NULL) return -1;
+
 	// Create a file with name fileName
 	error = TC(BF_CreateFile(fileName));
 	if (error != 0) return -1;
@@ -82,14 +182,38 @@ int HT_CreateFile(char *fileName,  int buckets){
 	info.numBuckets = buckets;		// Write the number of buckets
 	info.isHashFile = true; 	   // Write that this is a Hash File
 	info.isHeapFile = false;  	  // Write that this is not a Heap File
-	info.recordsPerBlock = (sizeof(char) * BF_BLOCK_SIZE - sizeof(HT_block_info)) / (sizeof(Record));
+	info.format = options.format;	  // Write how records are stored
+	info.hashFunction = options.hash;  // Write how keys are mapped to buckets
+	info.key = key;					  // Write which attributes form the key
+	info.keyOps = NULL;
+	info.filterBytes = options.filterBytes;
+	info.filterBlock = -1;
+	info.unique = options.unique;
+	info.freeBlock = -1;			// Nothing has been deleted yet
+	info.dictionaryBlock = -1;		 // The dictionary chain is written on close
+	info.dictionary = NULL;
+	info.latches = NULL;
+	info.indexBlock = -1;			// No secondary index yet
+	info.indexCount = 0;
+	info.indexNames = NULL;
+	if (info.format == SLOTTED_FORMAT)	 // At least this many, shorter records fit more
+		info.recordsPerBlock = (HT_RECORD_AREA_SIZE - sizeof(SP_header)) / (recordSize(info.format) + sizeof(SP_slot));
+	else
+		info.recordsPerBlock = HT_RECORD_AREA_SIZE / recordSize(info.format);
+
+	// One tag byte per record, the tags are padded to whole groups of 16 compared at once
+	info.tagBytes = 0;
+	if (options.fingerprints) {
+		while (HF_TAG_BYTES(info.recordsPerBlock) + info.recordsPerBlock * recordSize(info.format) > HT_RECORD_AREA_SIZE)
+			info.recordsPerBlock--;
+		info.tagBytes = HF_TAG_BYTES(info.recordsPerBlock);
+	}
 	
-	int totalSizeOfBuckets = buckets * (sizeof(int));
-	int hashTableSize = ( sizeof(char) * BF_BLOCK_SIZE - sizeof(HT_info) );
+	// The directory does not fit in block 0 for many buckets, it is kept in its own chain
+	info.directoryBlock = -1;
+	info.hashTable = malloc(sizeof(int) * buckets);
+	if (info.hashTable == NULL) return -1;
 
-	assert(totalSizeOfBuckets <= hashTableSize);
-
-	// info.hashTable = malloc(sizeof(int) * buckets);
 	// Get the data of the first block
 	char* data = BF_Block_GetData(block);
 
@@ -100,17 +224,11 @@ int HT_CreateFile(char *fileName,  int buckets){
 		error = TC(BF_AllocateBlock(fileDescriptor, bucket)); // Allocate a block for the bucket
 		if (error != 0) return -1;
 
-		HT_block_info blockInfo; // Create a HT_block_info struct to write to the bucket
-		// blockInfo.overflow = -1; // The new bucket doesn't have a overflow
-		blockInfo.recordsCount = (sizeof(char) * BF_BLOCK_SIZE - sizeof(HT_block_info)) / (sizeof(Record)); // And can fit this many records inside
-		blockInfo.currentRecords = 0; // Has no records inside
-		blockInfo.nextBlock = -1; // Has no next block
-		
 		char* bucketData = BF_Block_GetData(bucket);  	   // Get the data of the bucket
-		memcpy(bucketData, &blockInfo, sizeof(HT_block_info)); // Write the HT_block_info struct to the bucket
+		HT_InitBlock(&info, bucketData, -1);			  // No records inside, and no next block
 
 		// printf("Can hold: %d, holds: %d\n", blockInfo.recordsCount, blockInfo.currentRecords);
-		assert(blockInfo.currentRecords == 0);
+		assert(((HT_block_info*) bucketData)->currentRecords == 0);
 		
 		// last bucket is in position counter-1. so hashTable[i] = counter-1
 		int newBucketIn; BF_GetBlockCounter(fileDescriptor, &newBucketIn); // Get the position of the bucket
@@ -127,6 +245,18 @@ int HT_CreateFile(char *fileName,  int buckets){
 		BF_Block_Destroy(&bucket); // Destroy the block
 	}
 
+	// Empty Bloom filters for every bucket
+	if (info.filterBytes > 0) {
+		error = BLOOM_CreateFilters(fileDescriptor, buckets, info.filterBytes, &info.filterBlock);
+		if (error != 0) return -1;
+	}
+
+	// Write the directory, the header records where its chain starts
+	error = BC_Write(fileDescriptor, &info.directoryBlock, (char*) info.hashTable, sizeof(int) * buckets);
+	free(info.hashTable);
+	info.hashTable = NULL;
+	if (error != 0) return -1;
+
 	memcpy(data, &info, sizeof(HT_info)); // Write the HT_info struct to the first block
 	
 	BF_Block_SetDirty(block);
@@ -168,12 +298,41 @@ HT_info* HT_OpenFile(char *fileName){
 	// Copy the data from the first block to the returning HT_info struct
 	memcpy(toReturn, infoSaved, sizeof(HT_info)); 
 	toReturn->fileDesc = fileDescriptor;
+	toReturn->dictionary = NULL;
+	toReturn->hashTable = NULL;
+	toReturn->indexNames = NULL;
+	toReturn->keyOps = RK_Operations(toReturn->key);
+	toReturn->latches = LATCH_Create();
+	if (toReturn->latches == NULL) return NULL;
 
 
 	error = TC(BF_UnpinBlock(block)); 	   // Unpin the first block because we don't need it anymore
 	if (error != 0) return NULL;
 	BF_Block_Destroy(&block); // Destroy the block
 
+	// Cache the directory, so that finding a bucket costs no block reads
+	int size;
+	error = BC_Read(fileDescriptor, toReturn->directoryBlock, (char**) &toReturn->hashTable, &size);
+	if (error != 0 || size != (int) sizeof(int) * toReturn->numBuckets) return NULL;
+
+	// Encoded files keep their dictionary in memory while open
+	if (toReturn->format == ENCODED_FORMAT) {
+		toReturn->dictionary = calloc(1, sizeof(Record_Dictionary));
+		if (toReturn->dictionaryBlock != -1) {
+			char* serialized; int size;
+			error = BC_Read(fileDescriptor, toReturn->dictionaryBlock, &serialized, &size);
+			if (error != 0) return NULL;
+			deserializeDictionary(toReturn->dictionary, serialized, size);
+			free(serialized);
+		}
+	}
+
+	// The names of the secondary indexes, so that they can be opened along with the file
+	if (toReturn->indexBlock != -1) {
+		error = BC_Read(fileDescriptor, toReturn->indexBlock, &toReturn->indexNames, &size);
+		if (error != 0 || size != toReturn->indexCount * HT_INDEX_NAME_SIZE) return NULL;
+	}
+
 	printf("HT: Opened file\n");
     return toReturn;
 }
@@ -184,6 +343,24 @@ int HT_CloseFile( HT_info* HT_inf ){
 	int error;
 
 	BF_Block* block;	BF_Block_Init(&block);
+
+	// Write back the dictionary before the header, which records where it starts
+	if (HT_inf->format == ENCODED_FORMAT) {
+		int size;
+		char* serialized = serializeDictionary(HT_inf->dictionary, &size);
+		error = BC_Write(fileDescriptor, &HT_inf->dictionaryBlock, serialized, size);
+		free(serialized);
+		if (error != 0) return -1;
+	}
+
+	// Write back the directory, heads change whenever a bucket grows
+	error = BC_Write(fileDescriptor, &HT_inf->directoryBlock, (char*) HT_inf->hashTable, sizeof(int) * HT_inf->numBuckets);
+	if (error != 0) return -1;
+
+	if (HT_inf->indexBlock != -1 || HT_inf->indexCount > 0) {
+		error = BC_Write(fileDescriptor, &HT_inf->indexBlock, HT_inf->indexNames, HT_inf->indexCount * HT_INDEX_NAME_SIZE);
+		if (error != 0) return -1;
+	}
 	
 	printf("HT: Closed File\n");
 	error = TC(BF_GetBlock(fileDescriptor, 0, block)); // Get the first block
@@ -191,25 +368,19 @@ int HT_CloseFile( HT_info* HT_inf ){
 
 	char* data = BF_Block_GetData(block); 	// Get the data of the first block
 	memcpy(data, HT_inf, sizeof(HT_info)); // Copy the data from the HT_info struct to the first block
-	
-	HT_info* other_info = (HT_info*) data;
-	
-	for(int i = 0; i < HT_inf->numBuckets; i++) {
-		other_info->hashTable[i] = HT_inf->hashTable[i];
-	}
-
-	HT_info* info = (HT_info*) data;
-	for(int i = 0; i < info->numBuckets; i++)
-		assert(info->hashTable[i] == other_info->hashTable[i]);
 
 	BF_Block_SetDirty(block);
 	error = TC(BF_UnpinBlock(block));
 	if (error != 0) return -1;
 
 
-	// free(HT_info->hashTable);
+	free(HT_inf->hashTable);
 	BF_Block_Destroy(&block);
 
+	free(HT_inf->dictionary);
+	free(HT_inf->indexNames);
+	LATCH_Destroy(HT_inf->latches);
+
 	free(HT_inf); // Free the memory of the HT_info struct
 
 	error = TC(BF_CloseFile(fileDescriptor)); // Close the file
@@ -219,132 +390,930 @@ int HT_CloseFile( HT_info* HT_inf ){
     return 0;
 }
 
-int hashFunc(int key, int buckets) {
-	return key % buckets;
+int hashFunc(HT_info* ht_info, int key) {
+	unsigned int hash = HF_HashInt(ht_info->hashFunction, key);
+	return HF_Reduce(ht_info->hashFunction, hash, ht_info->numBuckets);
 }
 
-int HT_InsertEntry(HT_info* ht_info, Record record){
-	
+// The hash of the key attributes of record, which picks its bucket, fingerprint and filter bits
+static unsigned int HT_KeyHash(HT_info* ht_info, const Record* record) {
+	return ht_info->keyOps->hash(ht_info->hashFunction, record);
+}
+
+static int HT_KeyBucket(HT_info* ht_info, unsigned int keyHash) {
+	return HF_Reduce(ht_info->hashFunction, keyHash, ht_info->numBuckets);
+}
+
+// The functions that take an int value take it as the whole key, only files keyed on the id have one
+static bool HT_IdKey(HT_info* ht_info, int value, Record* key) {
+	if (ht_info->key != RECORD_KEY(ID)) return false;
+	key->id = value;
+	return true;
+}
+
+// Places an already stored record in the chain of bucket hash, in its head block or in a new one
+// put in front of it. Returns the block that holds the record, or -1, and its slot in *slot.
+static int HT_AppendRecord(HT_info* ht_info, int hash, char* stored, int size, unsigned char tag, int* slot) {
 	int error;
 	BF_Block* block; 		// Create a block
 	BF_Block_Init(&block); // Initialize the block
 	int fileDescriptor = ht_info->fileDesc; // Get the file descriptor
-	int hash = hashFunc(record.id, ht_info->numBuckets); // Get the hash of the record
-	int bucket = ht_info->hashTable[hash]; // Get the number of the bucket that contains the record
+	int bucket = LATCH_LOAD(ht_info->hashTable[hash]); // Get the number of the bucket that contains the record
 	int returnBlockId;
 
-	error = TC(BF_GetBlock(fileDescriptor, bucket, block));
+	error = TC(LATCH_GetBlock(fileDescriptor, bucket, block));
 	if (error != 0) return -1;
 
 	char* blockData = BF_Block_GetData(block);
-	
-	HT_block_info* blockInfoRead = (HT_block_info *) blockData;
-	
 
-	int recordsInBlock = blockInfoRead->currentRecords;
 	// If records fits in block, just place it inside
-	if (recordsInBlock < blockInfoRead->recordsCount) {
-		char* data = blockData +  sizeof(HT_block_info) + recordsInBlock * (sizeof(Record));
-		memcpy(data, &record, sizeof(Record));
-		blockInfoRead->currentRecords++;
-		BF_Block_SetDirty(block); // Mark the block as dirty
+	*slot = HT_PlaceRecord(ht_info, blockData, stored, size, tag);
+	if (*slot != -1) {
+		LATCH_SetDirty(block); // Mark the block as dirty
 		
 		// return the block id
 		returnBlockId = bucket;
 
 	} else {
-		// If records doesn't fit in block, create a new block and place it there
+		// If records doesn't fit in block, take a new block (a freed one first) and place it there
 		BF_Block* newBlock; 		// Create a block
 		BF_Block_Init(&newBlock); // Initialize the block
-		error = TC(BF_AllocateBlock(fileDescriptor, newBlock)); // Allocate a block for the new record
-		if (error != 0) return -1;
-
-		// Get block number of last allocated block ( = blockCounter - 1)
-		int blockCounter; BF_GetBlockCounter(fileDescriptor,&blockCounter ); // Get the number of the last allocated block
-		blockCounter--; // Get the number of the last allocated block
+		int blockCounter = HT_NewBlock(ht_info, newBlock);
+		if (blockCounter == -1) return -1;
 		
 		char* newBlockData = BF_Block_GetData(newBlock); // Get the data of the new block
-		HT_block_info* newBlockInfo = (HT_block_info *) newBlockData; // Cast the data to HT_block_info
-		newBlockInfo->currentRecords = 1; // Set the current records to 1
 
 		// Connect newly allocated block with the previous block in place
-		newBlockInfo->nextBlock = bucket; // Set the next block to previous bucket (reverse chaining)		
-		newBlockInfo->recordsCount = (sizeof(char) * BF_BLOCK_SIZE  - sizeof(HT_block_info) )/ sizeof(Record); // Set the records count to the maximum number of records that can fit in a block
-		
-		char* data = newBlockData +  sizeof(HT_block_info); // Get the data of the new block
-		memcpy(data, &record, sizeof(Record)); // Copy the data from the record to the new block
-		BF_Block_SetDirty(newBlock); // Mark the new block as dirty
-		BF_UnpinBlock(newBlock); // Unpin the new block because we don't need it anymore
+		HT_InitBlock(ht_info, newBlockData, bucket); // Set the next block to previous bucket (reverse chaining)
+		*slot = HT_PlaceRecord(ht_info, newBlockData, stored, size, tag); // Copy the data from the record to the new block
+		LATCH_SetDirty(newBlock); // Mark the new block as dirty
+		LATCH_UnpinBlock(newBlock); // Unpin the new block because we don't need it anymore
 		BF_Block_Destroy(&newBlock); // Destroy the new block
 		
-		ht_info->hashTable[hash] = blockCounter; // Set the bucket to the new block
+		// Install the new head only once it is complete, lookups of other threads may read it right away
+		LATCH_STORE(ht_info->hashTable[hash], blockCounter);
 		
-		// returnBlockId is the id of the last inserted block (saved in blockCounter)
+		// returnBlockId is the id of the new head block (saved in blockCounter)
 		returnBlockId = blockCounter;
 	}
 
-	printf("Inserted: %d \t\t %s \t %s \t %s IN-> %d\n", record.id, record.name, record.surname, record.city, returnBlockId);
-	
-	error = TC(BF_UnpinBlock(block)); // Unpin the block because we don't need it anymore
+	error = TC(LATCH_UnpinBlock(block)); // Unpin the block because we don't need it anymore
 	if (error != 0) return -1;
 	
 	BF_Block_Destroy(&block); // Destroy the block
+	return returnBlockId;
+}
+
+// Inserts record in bucket hash, with its bucket latch held. The RID of the record goes to *rid
+static int HT_InsertLatched(HT_info* ht_info, Record record, unsigned int keyHash, int hash, int* rid){
+	
+	int error;
+	int fileDescriptor = ht_info->fileDesc; // Get the file descriptor
+	unsigned char tag = HF_Fingerprint(keyHash);
+
+	// In a unique-key file a key may be inserted only once
+	if (ht_info->unique) {
+		int existing;
+		if (HT_Lookup(ht_info, &record, false, NULL, &existing) == -1) return -1;
+		if (existing != 0) return -1;
+	}
+
+	// Convert the record to the file's format before touching any block
+	char stored[sizeof(Record)];
+	if (ht_info->format == ENCODED_FORMAT) LATCH_LockFile(ht_info->latches);
+	int size = storeRecord(ht_info->format, ht_info->dictionary, record, stored);
+	if (ht_info->format == ENCODED_FORMAT) LATCH_UnlockFile(ht_info->latches);
+	if (size == -1) return -1;
+
+	int slot;
+	int returnBlockId = HT_AppendRecord(ht_info, hash, stored, size, tag, &slot);
+	if (returnBlockId == -1) return -1;
+	*rid = HT_RID(returnBlockId, slot);
+
+	printf("Inserted: %d \t\t %s \t %s \t %s IN-> %d\n", record.id, record.name, record.surname, record.city, returnBlockId);
+
+	// Record the id in the filter of the bucket, so that lookups of other ids can skip the chain
+	if (ht_info->filterBytes > 0) {
+		error = BLOOM_Add(fileDescriptor, ht_info->filterBlock, ht_info->filterBytes, hash, keyHash);
+		if (error != 0) return -1;
+	}
 	
 	
     return returnBlockId; // Return the block id
 }
 
-int HT_GetAllEntries(HT_info* ht_info, int* value ){
+int HT_InsertEntry(HT_info* ht_info, Record record){
+	int rid;
+	return HT_InsertEntryWithRid(ht_info, record, &rid);
+}
 
-	int error;
+int HT_InsertEntryWithRid(HT_info* ht_info, Record record, int* rid){
+	unsigned int keyHash = HT_KeyHash(ht_info, &record);
+	int hash = HT_KeyBucket(ht_info, keyHash); // Get the hash of the record
+
+	// Only the bucket of the record is latched, inserts into other buckets go on in parallel
+	LATCH_LockBucket(ht_info->latches, hash);
+	int returnBlockId = HT_InsertLatched(ht_info, record, keyHash, hash, rid);
+	LATCH_UnlockBucket(ht_info->latches, hash);
+	return returnBlockId;
+}
+
+// A record of a bulk load with the hash of its key, sorted by hash so that equal keys are adjacent
+typedef struct {
+	unsigned int hash;
+	const Record* record;
+} HT_keyed;
+
+static int compareKeyed(const void* a, const void* b) {
+	unsigned int x = ((const HT_keyed*) a)->hash, y = ((const HT_keyed*) b)->hash;
+	return (x > y) - (x < y);
+}
+
+// For unique files, checks that no key of the partitioned records repeats, neither among them
+// nor in the file. Returns 0 if they are all new, 1 if one repeats and -1 on error.
+static int HT_CheckBulkKeys(HT_info* ht_info, const Record* records, const int* order, const size_t* start) {
+	BF_Block* block;
+	BF_Block_Init(&block);
+	HT_keyed* keys = malloc(start[ht_info->numBuckets] * sizeof(HT_keyed) + 1);
+	if (keys == NULL) return -1;
+
+	int result = 0;
+	for (int b = 0; b < ht_info->numBuckets && result == 0; b++) {
+		size_t count = start[b + 1] - start[b];
+		if (count == 0) continue;
+
+		for (size_t i = 0; i < count; i++) {
+			keys[i].record = &records[order[start[b] + i]];
+			keys[i].hash = HT_KeyHash(ht_info, keys[i].record);
+		}
+		qsort(keys, count, sizeof(HT_keyed), compareKeyed);
+		for (size_t i = 0; i < count && result == 0; i++)
+			for (size_t j = i + 1; j < count && keys[j].hash == keys[i].hash && result == 0; j++)
+				if (ht_info->keyOps->equals(keys[i].record, keys[j].record)) result = 1;
+
+		// Only buckets that already hold records need a lookup per key
+		if (TC(BF_GetBlock(ht_info->fileDesc, ht_info->hashTable[b], block)) != 0) { result = -1; break; }
+		HT_block_info* info = (HT_block_info*) BF_Block_GetData(block);
+		bool empty = info->currentRecords == 0 && info->nextBlock == -1;
+		if (TC(BF_UnpinBlock(block)) != 0) { result = -1; break; }
+
+		for (size_t i = 0; i < count && !empty && result == 0; i++) {
+			int existing;
+			if (HT_Lookup(ht_info, keys[i].record, false, NULL, &existing) == -1) result = -1;
+			else if (existing != 0) result = 1;
+		}
+	}
+
+	free(keys);
+	BF_Block_Destroy(&block);
+	return result;
+}
+
+int HT_BulkLoad(HT_info* ht_info, const Record* records, size_t n) {
+	int error = 0;
+	int fileDescriptor = ht_info->fileDesc;
+	int buckets = ht_info->numBuckets;
+
+	BF_Block* block;
+	BF_Block_Init(&block);
+	bool pinned = false;	// The block being filled, the head of its bucket
+
+	// Partitioning pass: a histogram of the buckets, whose prefix sums give the range of every bucket
+	// in order, and then every record is scattered to the next position of its range
+	int* bucketOf = malloc(n * sizeof(int) + 1);
+	int* order = malloc(n * sizeof(int) + 1);
+	size_t* start = calloc(buckets + 1, sizeof(size_t));
+	size_t* next = malloc(buckets * sizeof(size_t));
+	if (bucketOf == NULL || order == NULL || start == NULL || next == NULL) {
+		error = -1;
+		goto cleanup;
+	}
+
+	for (size_t i = 0; i < n; i++) {
+		bucketOf[i] = HT_KeyBucket(ht_info, HT_KeyHash(ht_info, &records[i]));
+		start[bucketOf[i] + 1]++;
+	}
+	for (int b = 0; b < buckets; b++)
+		start[b + 1] += start[b];
+
+	memcpy(next, start, buckets * sizeof(size_t));
+	for (size_t i = 0; i < n; i++)
+		order[next[bucketOf[i]]++] = i;
+
+	// A unique file rejects the whole load, before any block is written
+	if (ht_info->unique && HT_CheckBulkKeys(ht_info, records, order, start) != 0) {
+		error = -1;
+		goto cleanup;
+	}
+
+	char stored[sizeof(Record)];
+
+	for (int b = 0; b < buckets; b++) {
+		if (start[b] == start[b + 1]) continue;
+
+		// Fill the current head first. The blocks allocated after it are consecutive (once the free list
+		// is used up) and packed full,
+		// each one in front of the previous (reverse chaining), so only the last one can have room left.
+		int current = ht_info->hashTable[b];
+		error = TC(BF_GetBlock(fileDescriptor, current, block));
+		if (error != 0) goto cleanup;
+		pinned = true;
+		char* blockData = BF_Block_GetData(block);
+
+		for (size_t i = start[b]; i < start[b + 1]; i++) {
+			const Record* record = &records[order[i]];
+			int size = storeRecord(ht_info->format, ht_info->dictionary, *record, stored);
+			if (size == -1) {
+				error = -1;
+				goto cleanup;
+			}
+			unsigned int keyHash = HT_KeyHash(ht_info, record);
+			unsigned char tag = HF_Fingerprint(keyHash);
+
+			if (HT_PlaceRecord(ht_info, blockData, stored, size, tag) == -1) {
+				BF_Block_SetDirty(block);
+				pinned = false;
+				error = TC(BF_UnpinBlock(block));
+				if (error != 0) goto cleanup;
+
+				int newBlock = HT_NewBlock(ht_info, block);
+				if (newBlock == -1) {
+					error = -1;
+					goto cleanup;
+				}
+				pinned = true;
+
+				blockData = BF_Block_GetData(block);
+				HT_InitBlock(ht_info, blockData, current);
+				current = newBlock;
+				HT_PlaceRecord(ht_info, blockData, stored, size, tag);
+
+				// The newest block becomes the head of the bucket, so a failure later on loses none of it
+				ht_info->hashTable[b] = current;
+			}
+
+			if (ht_info->filterBytes > 0) {
+				error = BLOOM_Add(fileDescriptor, ht_info->filterBlock, ht_info->filterBytes, b, keyHash);
+				if (error != 0) goto cleanup;
+			}
+		}
+
+		BF_Block_SetDirty(block);
+		pinned = false;
+		error = TC(BF_UnpinBlock(block));
+		if (error != 0) goto cleanup;
+	}
+
+cleanup:
+	if (pinned) {
+		BF_Block_SetDirty(block);
+		if (TC(BF_UnpinBlock(block)) != 0) error = -1;
+	}
+	BF_Block_Destroy(&block);
+	free(next);
+	free(bucketOf);
+	free(order);
+	free(start);
+	return error;
+}
+
+// Walks the chain of the bucket of key, newest block first. With print set, every record with the
+// key of key is printed and only unique files stop at the first one. Without it, the walk stops at the
+// first record, which is copied to found (if not NULL) and its block to foundBlock (0 if none).
+// Returns the number of blocks read, or -1.
+static int HT_Lookup(HT_info* ht_info, const Record* key, bool print, Record* found, int* foundBlock) {
+
+	int error = 0;
 	int fileDescriptor = ht_info->fileDesc; // Get the file descriptor
 	BF_Block* block; 		// Create a block
 	BF_Block_Init(&block); // Initialize the block
+	bool pinned = false;
 	
 	int blocksRead = 0;
-	int hashValue = hashFunc((int) * ((int*) value), ht_info->numBuckets); // Get the hash of the value
-	int bucket = ht_info->hashTable[hashValue];
+	bool stopAtFirst = !print || ht_info->unique;
+	if (foundBlock != NULL) *foundBlock = 0;
+
+	unsigned int keyHash = HT_KeyHash(ht_info, key);
+	int hashValue = HT_KeyBucket(ht_info, keyHash); // Get the hash of the value
+	int bucket = LATCH_LOAD(ht_info->hashTable[hashValue]);
+	unsigned char tag = HF_Fingerprint(keyHash);
+
+	// A negative answer of the filter means the key is not in the bucket, its chain is not read
+	if (ht_info->filterBytes > 0) {
+		blocksRead++;
+		int found = BLOOM_MayContain(fileDescriptor, ht_info->filterBlock, ht_info->filterBytes, hashValue, keyHash);
+		if (found == -1) {
+			error = -1;
+			goto cleanup;
+		}
+		if (found == 0) goto cleanup;
+	}
 
 	
 	// Get block number of last allocated block ( = blockCounter - 1)
-	error = TC(BF_GetBlock(fileDescriptor, bucket, block));
-	if (error != 0) return -1;
+	error = TC(LATCH_GetBlock(fileDescriptor, bucket, block));
+	if (error != 0) goto cleanup;
+	pinned = true;
 
 	char* blockData = BF_Block_GetData(block);
 	HT_block_info* info = (HT_block_info*) blockData;
 	
 
+	int current = bucket;
+	bool done = false;
 	while ( true ) {
 		// Iterate through all records of the bucket
 		blocksRead++;
 
+		// With fingerprints, only the records whose tag matches are decoded
+		unsigned long long candidates = ~0ull;
+		if (ht_info->tagBytes > 0)
+			candidates = HF_MatchTags(HT_TAGS(blockData), info->currentRecords, tag);
+
 		for(int i = 0; i < info->currentRecords; i++) {
+			if (i < 64 && (candidates >> i & 1) == 0) continue;
+
 			// Check every record in block
-			char* data = blockData +  sizeof(HT_block_info) + i * (sizeof(Record));
-			Record rec = (Record) *( (Record*) data); // Cast the data to Record
-			if (rec.id == (int) * ((int*)value) ) {
-				printf("Found\n");
+			Record rec;
+			if (HT_BlockRecord(ht_info, blockData, i, &rec) != 0) continue; // Decode the data to Record
+			if (ht_info->keyOps->equals(&rec, key)) {
+				if (print) printf("Found\n");
+				if (found != NULL) *found = rec;
+				if (foundBlock != NULL) *foundBlock = current;
+				if (stopAtFirst) {
+					done = true;
+					break;
+				}
 			}
 		}
 		// Check if there is a next block (overflow)
-		if ( info->nextBlock == -1) 
+		if ( done || info->nextBlock == -1) 
 			break;
 		else {
-			error = TC(BF_UnpinBlock(block));
-			if (error != 0) return -1;
+			current = info->nextBlock;	// Read before the unpin, the frame may be reused right after it
+			error = TC(LATCH_UnpinBlock(block));
+			if (error != 0) goto cleanup;	// Still pinned, the cleanup tries once more
+			pinned = false;
 			
-			error = TC(BF_GetBlock(fileDescriptor, info->nextBlock, block));
-			if (error != 0) return -1;
+			error = TC(LATCH_GetBlock(fileDescriptor, current, block));
+			if (error != 0) goto cleanup;
+			pinned = true;
 
 			blockData = BF_Block_GetData(block);
 			info = (HT_block_info*) blockData;
 		}
 	}
 
-	BF_UnpinBlock(block);
+cleanup:
+	if (pinned) LATCH_UnpinBlock(block);
 	BF_Block_Destroy(&block);
 
-    return blocksRead;
+	return error != 0 ? -1 : blocksRead;
+}
+
+// HT_Lookup with the bucket of key latched, so that it runs alongside inserts of other threads
+static int HT_LatchedLookup(HT_info* ht_info, const Record* key, bool print, Record* found, int* foundBlock) {
+	int hash = HT_KeyBucket(ht_info, HT_KeyHash(ht_info, key));
+	LATCH_LockBucket(ht_info->latches, hash);
+	int blocksRead = HT_Lookup(ht_info, key, print, found, foundBlock);
+	LATCH_UnlockBucket(ht_info->latches, hash);
+	return blocksRead;
+}
+
+int HT_GetAllEntries(HT_info* ht_info, int* value ){
+	Record key;
+	if (!HT_IdKey(ht_info, *value, &key)) return -1;
+	return HT_LatchedLookup(ht_info, &key, true, NULL, NULL);
+}
+
+int HT_GetAllEntriesByKey(HT_info* ht_info, Record* key) {
+	return HT_LatchedLookup(ht_info, key, true, NULL, NULL);
+}
+
+int HT_GetEntry(HT_info* ht_info, int value, Record* record) {
+	Record key;
+	if (!HT_IdKey(ht_info, value, &key)) return -1;
+	return HT_GetEntryByKey(ht_info, &key, record);
+}
+
+int HT_GetEntryByKey(HT_info* ht_info, Record* key, Record* record) {
+	int blockId;
+	if (HT_LatchedLookup(ht_info, key, false, record, &blockId) == -1) return -1;
+	return blockId;
+}
+
+// Records are never looked at in blocks bigger than this, even short slotted ones need a slot each
+#define HT_MAX_BLOCK_RECORDS (HT_RECORD_AREA_SIZE / (int) sizeof(SP_slot))
+
+// Fills the holes of block holeBlock with the last records of the head of bucket hash, so that only the
+// head of a chain has room. A head left empty goes to the free list, unless it is all the bucket has.
+static int HT_FillHoles(HT_info* ht_info, int hash, int holeBlock, HT_UpdateCallback moved, void* context) {
+	int error = 0;
+	BF_Block* headBlock;
+	BF_Block* block;
+	BF_Block_Init(&headBlock);
+	BF_Block_Init(&block);
+
+	while (true) {
+		int head = ht_info->hashTable[hash];
+		error = TC(BF_GetBlock(ht_info->fileDesc, head, headBlock));
+		if (error != 0) goto cleanup;
+
+		char* headData = BF_Block_GetData(headBlock);
+		HT_block_info* headInfo = (HT_block_info*) headData;
+		if (headInfo->currentRecords == 0 && headInfo->nextBlock != -1) {
+			ht_info->hashTable[hash] = headInfo->nextBlock;
+			HT_InitBlock(ht_info, headData, ht_info->freeBlock);
+			ht_info->freeBlock = head;
+			BF_Block_SetDirty(headBlock);
+			error = TC(BF_UnpinBlock(headBlock));
+			if (error != 0) goto cleanup;
+			if (head == holeBlock) break;
+			continue;
+		}
+		if (head == holeBlock || headInfo->currentRecords == 0) {
+			error = TC(BF_UnpinBlock(headBlock));
+			break;
+		}
+
+		error = TC(BF_GetBlock(ht_info->fileDesc, holeBlock, block));
+		if (error != 0) {
+			BF_UnpinBlock(headBlock);
+			goto cleanup;
+		}
+		char* blockData = BF_Block_GetData(block);
+
+		// Trailing empty slots are dropped, so the last position of the head always holds a record
+		int last = headInfo->currentRecords - 1;
+		Record record;
+		HT_BlockRecord(ht_info, headData, last, &record);
+
+		char* stored;
+		int size;
+		if (ht_info->format == SLOTTED_FORMAT) {
+			stored = SP_Get(HT_RECORD_AREA(headData), last, &size);
+		} else {
+			size = recordSize(ht_info->format);
+			stored = HT_RECORDS(ht_info, headData) + last * size;
+		}
+		unsigned char tag = ht_info->tagBytes > 0 ? HT_TAGS(headData)[last] : 0;
+
+		int slot = HT_PlaceRecord(ht_info, blockData, stored, size, tag);
+		bool placed = slot != -1;
+		if (placed) {
+			HT_RemoveRecord(ht_info, headData, last);
+			BF_Block_SetDirty(block);
+			BF_Block_SetDirty(headBlock);
+		}
+
+		error = TC(BF_UnpinBlock(block));
+		error += TC(BF_UnpinBlock(headBlock));
+		if (error != 0) goto cleanup;
+		if (!placed) break;
+
+		if (moved != NULL)
+			moved(&record, HT_RID(head, last), &record, HT_RID(holeBlock, slot), context);
+	}
+
+cleanup:
+	BF_Block_Destroy(&headBlock);
+	BF_Block_Destroy(&block);
+	return error != 0 ? -1 : 0;
+}
+
+int HT_DeleteEntry(HT_info* ht_info, int value, HT_Callback removed, HT_UpdateCallback moved, void* context) {
+	Record key;
+	if (!HT_IdKey(ht_info, value, &key)) return -1;
+	return HT_DeleteEntryByKey(ht_info, &key, removed, moved, context);
+}
+
+// A change of HT_DeleteEntry to a block, reported once the block is written back: the removal of a
+// record (to is -1), or the move of the last record of the block into the hole
+typedef struct {
+	Record record;
+	int from;
+	int to;
+} HT_move;
+
+int HT_DeleteEntryByKey(HT_info* ht_info, Record* key, HT_Callback removed, HT_UpdateCallback moved, void* context) {
+	int error;
+	int fileDescriptor = ht_info->fileDesc;
+	unsigned int keyHash = HT_KeyHash(ht_info, key);
+	int hash = HT_KeyBucket(ht_info, keyHash);
+	unsigned char tag = HF_Fingerprint(keyHash);
+
+	// The filter keeps the bits of deleted keys, but a negative answer still means there is nothing to delete
+	if (ht_info->filterBytes > 0) {
+		int found = BLOOM_MayContain(fileDescriptor, ht_info->filterBlock, ht_info->filterBytes, hash, keyHash);
+		if (found != 1) return found == 0 ? 0 : -1;
+	}
+
+	BF_Block* block;
+	BF_Block_Init(&block);
+	int deleted = 0;
+	HT_move* changes = malloc(2 * HT_MAX_BLOCK_RECORDS * sizeof(HT_move));
+	if (changes == NULL) {
+		deleted = -1;
+		goto cleanup;
+	}
+
+	int current = ht_info->hashTable[hash];
+	bool done = false;
+	while (current != -1 && !done) {
+		error = TC(BF_GetBlock(fileDescriptor, current, block));
+		if (error != 0) {
+			deleted = -1;
+			goto cleanup;
+		}
+
+		char* blockData = BF_Block_GetData(block);
+		HT_block_info* info = (HT_block_info*) blockData;
+
+		// A hole is filled by the last record of the block, so the same position is checked again
+		int count = 0, changed = 0;
+		for (int i = 0; i < info->currentRecords && !done; ) {
+			Record record;
+			if ((ht_info->tagBytes > 0 && HT_TAGS(blockData)[i] != tag)
+				|| HT_BlockRecord(ht_info, blockData, i, &record) != 0 || !ht_info->keyOps->equals(&record, key)) {
+				i++;
+				continue;
+			}
+			changes[changed++] = (HT_move) { record, HT_RID(current, i), -1 };
+
+			// The slotted layout leaves the hole empty, the fixed ones move the last record into it
+			int last = info->currentRecords - 1;
+			if (ht_info->format != SLOTTED_FORMAT && i != last) {
+				HT_BlockRecord(ht_info, blockData, last, &record);
+				changes[changed++] = (HT_move) { record, HT_RID(current, last), HT_RID(current, i) };
+			}
+			HT_RemoveRecord(ht_info, blockData, i);
+			count++;
+			done = ht_info->unique;
+		}
+		if (count > 0) BF_Block_SetDirty(block);
+
+		// Filling the holes only changes the blocks up to this one, the walk goes on from its next
+		int next = info->nextBlock;
+		error = TC(BF_UnpinBlock(block));
+		if (error != 0) {
+			deleted = -1;
+			goto cleanup;
+		}
+
+		if (count > 0) {
+			// The block is written back, so a secondary index can check what it still holds
+			for (int c = 0; c < changed; c++) {
+				if (changes[c].to == -1 && removed != NULL)
+					removed(changes[c].record.id, &changes[c].record, changes[c].from, context);
+				if (changes[c].to != -1 && moved != NULL)
+					moved(&changes[c].record, changes[c].from, &changes[c].record, changes[c].to, context);
+			}
+			deleted += count;
+
+			if (HT_FillHoles(ht_info, hash, current, moved, context) != 0) {
+				deleted = -1;
+				goto cleanup;
+			}
+		}
+		current = next;
+	}
+
+cleanup:
+	free(changes);
+	BF_Block_Destroy(&block);
+	return deleted;
+}
+
+// A record of HT_UpdateEntry, before and after the update
+typedef struct {
+	Record old;
+	int oldRid;
+	int newRid;		// -1 while the record still has to move to the head
+} HT_change;
+
+int HT_UpdateEntry(HT_info* ht_info, int value, Record record, HT_UpdateCallback callback, void* context) {
+	// The id picks the bucket, changing it takes a delete and an insert
+	if (ht_info->key != RECORD_KEY(ID) || record.id != value) return -1;
+	return HT_UpdateEntryByKey(ht_info, record, callback, context);
+}
+
+int HT_UpdateEntryByKey(HT_info* ht_info, Record record, HT_UpdateCallback callback, void* context) {
+	int error;
+	int fileDescriptor = ht_info->fileDesc;
+
+	char stored[sizeof(Record)];
+	int size = storeRecord(ht_info->format, ht_info->dictionary, record, stored);
+	if (size == -1) return -1;
+
+	unsigned int keyHash = HT_KeyHash(ht_info, &record);
+	int hash = HT_KeyBucket(ht_info, keyHash);
+	unsigned char tag = HF_Fingerprint(keyHash);
+
+	if (ht_info->filterBytes > 0) {
+		int found = BLOOM_MayContain(fileDescriptor, ht_info->filterBlock, ht_info->filterBytes, hash, keyHash);
+		if (found != 1) return found == 0 ? 0 : -1;
+	}
+
+	BF_Block* block;
+	BF_Block_Init(&block);
+	int updated = 0;
+	HT_change* changes = malloc(HT_MAX_BLOCK_RECORDS * sizeof(HT_change));
+	int* positions = malloc(HT_MAX_BLOCK_RECORDS * sizeof(int));
+	if (changes == NULL || positions == NULL) {
+		updated = -1;
+		goto cleanup;
+	}
+
+	int current = ht_info->hashTable[hash];
+	bool done = false;
+	while (current != -1 && !done) {
+		error = TC(BF_GetBlock(fileDescriptor, current, block));
+		if (error != 0) {
+			updated = -1;
+			goto cleanup;
+		}
+
+		char* blockData = BF_Block_GetData(block);
+		HT_block_info* info = (HT_block_info*) blockData;
+		int next = info->nextBlock;
+
+		// Find the records first, a rewritten slotted record may come back in a later slot
+		int count = 0;
+		for (int i = 0; i < info->currentRecords && !done; i++) {
+			if (ht_info->tagBytes > 0 && HT_TAGS(blockData)[i] != tag) continue;
+			if (HT_BlockRecord(ht_info, blockData, i, &changes[count].old) != 0 || !ht_info->keyOps->equals(&changes[count].old, &record)) continue;
+			changes[count].oldRid = HT_RID(current, i);
+			changes[count].newRid = HT_RID(current, i);
+			positions[count++] = i;
+			done = ht_info->unique;
+		}
+
+		// In place, the key and so the fingerprint stay the same. A longer slotted record that no longer
+		// fits its block moves to the head of the bucket.
+		for (int c = 0; c < count; c++) {
+			if (ht_info->format == SLOTTED_FORMAT) {
+				char* page = HT_RECORD_AREA(blockData);
+				SP_Delete(page, positions[c]);
+				int slot = SP_Insert(page, stored, size);
+				changes[c].newRid = slot == -1 ? -1 : HT_RID(current, slot);
+				info->currentRecords = SP_Slots(page);
+			} else {
+				memcpy(HT_RECORDS(ht_info, blockData) + positions[c] * size, stored, size);
+			}
+		}
+		if (count > 0) BF_Block_SetDirty(block);
+
+		error = TC(BF_UnpinBlock(block));
+		if (error != 0) {
+			updated = -1;
+			goto cleanup;
+		}
+
+		// The head only grows in front of the blocks still to be read
+		for (int c = 0; c < count; c++) {
+			if (changes[c].newRid == -1) {
+				int slot;
+				int newBlock = HT_AppendRecord(ht_info, hash, stored, size, tag, &slot);
+				if (newBlock == -1) {
+					updated = -1;
+					goto cleanup;
+				}
+				changes[c].newRid = HT_RID(newBlock, slot);
+			}
+			if (callback != NULL)
+				callback(&changes[c].old, changes[c].oldRid, &record, changes[c].newRid, context);
+		}
+		updated += count;
+		current = next;
+	}
+
+cleanup:
+	free(changes);
+	free(positions);
+	BF_Block_Destroy(&block);
+	return updated;
+}
+
+// A key of HT_GetMany, sorted by bucket so that the keys of a chain are adjacent
+typedef struct {
+	int bucket;
+	int key;
+	unsigned char tag;
+	bool found;		// Only for unique files, the key needs no more blocks
+} HT_probe;
+
+static int compareProbes(const void* a, const void* b) {
+	int x = ((const HT_probe*) a)->bucket, y = ((const HT_probe*) b)->bucket;
+	return (x > y) - (x < y);
+}
+
+int HT_GetMany(HT_info* ht_info, const int* keys, size_t n, HT_Callback callback, void* context) {
+	int error = 0;
+	int fileDescriptor = ht_info->fileDesc;
+	int blocksRead = 0;
+	if (ht_info->key != RECORD_KEY(ID)) return -1;	// The keys are ids
+
+	BF_Block* block;
+	BF_Block_Init(&block);
+	HT_probe* probes = malloc(n * sizeof(HT_probe) + 1);
+	if (probes == NULL) {
+		error = -1;
+		goto cleanup;
+	}
+
+	size_t count = 0;
+	for (size_t i = 0; i < n; i++) {
+		int bucket = hashFunc(ht_info, keys[i]);
+		unsigned int keyHash = HF_HashInt(ht_info->hashFunction, keys[i]);
+
+		// Keys that the filter rules out never reach a chain
+		if (ht_info->filterBytes > 0) {
+			blocksRead++;
+			int mayContain = BLOOM_MayContain(fileDescriptor, ht_info->filterBlock, ht_info->filterBytes, bucket, keyHash);
+			if (mayContain == -1) {
+				error = -1;
+				goto cleanup;
+			}
+			if (mayContain == 0) continue;
+		}
+
+		probes[count].bucket = bucket;
+		probes[count].key = keys[i];
+		probes[count].tag = HF_Fingerprint(keyHash);
+		probes[count].found = false;
+		count++;
+	}
+	qsort(probes, count, sizeof(HT_probe), compareProbes);
+
+	for (size_t first = 0; first < count; ) {
+		// The keys of one bucket are probes[first .. last), its chain is walked once for all of them
+		size_t last = first;
+		while (last < count && probes[last].bucket == probes[first].bucket) last++;
+		size_t pending = last - first;
+
+		// The bucket stays latched for its whole chain, as in HT_LatchedLookup
+		int bucket = probes[first].bucket;
+		LATCH_LockBucket(ht_info->latches, bucket);
+		int current = LATCH_LOAD(ht_info->hashTable[bucket]);
+		while (current != -1 && pending > 0) {
+			error = TC(LATCH_GetBlock(fileDescriptor, current, block));
+			if (error != 0) break;
+			blocksRead++;
+
+			char* blockData = BF_Block_GetData(block);
+			HT_block_info* info = (HT_block_info*) blockData;
+
+			// With fingerprints, only the records whose tag matches one of the keys are decoded
+			unsigned long long candidates = ~0ull;
+			if (ht_info->tagBytes > 0) {
+				candidates = 0;
+				for (size_t k = first; k < last; k++)
+					if (!probes[k].found)
+						candidates |= HF_MatchTags(HT_TAGS(blockData), info->currentRecords, probes[k].tag);
+			}
+
+			for (int i = 0; i < info->currentRecords; i++) {
+				if (i < 64 && (candidates >> i & 1) == 0) continue;
+
+				Record rec;
+				if (HT_BlockRecord(ht_info, blockData, i, &rec) != 0) continue;
+				for (size_t k = first; k < last; k++) {
+					if (probes[k].found || probes[k].key != rec.id) continue;
+					callback(probes[k].key, &rec, HT_RID(current, i), context);
+
+					// A unique id has no other record
+					if (ht_info->unique) {
+						probes[k].found = true;
+						pending--;
+					}
+				}
+			}
+
+			current = info->nextBlock;	// Read before the unpin, the frame may be reused right after it
+			error = TC(LATCH_UnpinBlock(block));
+			if (error != 0) break;
+		}
+		LATCH_UnlockBucket(ht_info->latches, bucket);
+		if (error != 0) goto cleanup;
+
+		first = last;
+	}
+
+cleanup:
+	BF_Block_Destroy(&block);
+	free(probes);
+	return error != 0 ? -1 : blocksRead;
+}
+
+int HT_ScanEntries(HT_info* ht_info, HT_Callback callback, void* context) {
+	return HT_ScanBuckets(ht_info, 0, ht_info->numBuckets, callback, context);
+}
+
+int HT_ScanBuckets(HT_info* ht_info, int first, int last, HT_Callback callback, void* context) {
+	int error;
+	int blocksRead = 0;
+	BF_Block* block;
+	BF_Block_Init(&block);
+
+	// The blocks are read through the BF latch, so that threads scan their own buckets side by side
+	for (int b = first; b < last; b++) {
+		int current = ht_info->hashTable[b];
+		while (current != -1) {
+			error = TC(LATCH_GetBlock(ht_info->fileDesc, current, block));
+			if (error != 0) return -1;
+			blocksRead++;
+
+			char* blockData = BF_Block_GetData(block);
+			HT_block_info* info = (HT_block_info*) blockData;
+			for (int i = 0; i < info->currentRecords; i++) {
+				Record record;
+				if (HT_BlockRecord(ht_info, blockData, i, &record) != 0) continue;
+				callback(record.id, &record, HT_RID(current, i), context);
+			}
+
+			current = info->nextBlock;
+			error = TC(LATCH_UnpinBlock(block));
+			if (error != 0) return -1;
+		}
+	}
+
+	BF_Block_Destroy(&block);
+	return blocksRead;
+}
+
+// The records of a file, gathered by HT_ScanEntries for a rebuild
+typedef struct {
+	Record* records;
+	size_t count;
+	size_t capacity;
+} HT_recordList;
+
+static void HT_CollectRecord(int key, Record* record, int rid, void* context) {
+	(void) key;
+	(void) rid;
+	HT_recordList* list = context;
+	if (list->count == list->capacity) {
+		list->capacity = list->capacity == 0 ? 1024 : 2 * list->capacity;
+		list->records = realloc(list->records, list->capacity * sizeof(Record));
+	}
+	list->records[list->count++] = *record;
+}
+
+int HT_RegisterIndex(HT_info* ht_info, const char* indexName) {
+	if (strlen(indexName) >= HT_INDEX_NAME_SIZE) return -1;
+	for (int i = 0; i < ht_info->indexCount; i++)
+		if (strcmp(ht_info->indexNames + i * HT_INDEX_NAME_SIZE, indexName) == 0) return 0;
+
+	char* names = realloc(ht_info->indexNames, (ht_info->indexCount + 1) * HT_INDEX_NAME_SIZE);
+	if (names == NULL) return -1;
+	ht_info->indexNames = names;
+	memset(names + ht_info->indexCount * HT_INDEX_NAME_SIZE, 0, HT_INDEX_NAME_SIZE);
+	strcpy(names + ht_info->indexCount * HT_INDEX_NAME_SIZE, indexName);
+	ht_info->indexCount++;
+	return 0;
+}
+
+int HT_UnregisterIndex(HT_info* ht_info, const char* indexName) {
+	for (int i = 0; i < ht_info->indexCount; i++) {
+		if (strcmp(ht_info->indexNames + i * HT_INDEX_NAME_SIZE, indexName) != 0) continue;
+		int last = ht_info->indexCount - 1;
+		memmove(ht_info->indexNames + i * HT_INDEX_NAME_SIZE, ht_info->indexNames + (i + 1) * HT_INDEX_NAME_SIZE, (last - i) * HT_INDEX_NAME_SIZE);
+		ht_info->indexCount--;
+		return 1;
+	}
+	return 0;
+}
+
+int HT_Reorganize(HT_info* ht_info, char* fileName, int buckets, HT_options options) {
+	// Read every record through the caller's handle, which also sees the blocks it has not written back
+	HT_recordList list = { NULL, 0, 0 };
+	if (HT_ScanEntries(ht_info, HT_CollectRecord, &list) == -1) {
+		free(list.records);
+		return -1;
+	}
+
+	// Build the new file next to the old one, every chain is written by the bulk loader
+	char* newName = malloc(strlen(fileName) + strlen(".reorg") + 1);
+	sprintf(newName, "%s.reorg", fileName);
+	remove(newName);
+
+	int error = HT_CreateFileWithOptions(newName, buckets, options);
+	HT_info* info = error == 0 ? HT_OpenFile(newName) : NULL;
+	if (info == NULL) error = -1;
+	if (error == 0) error = HT_BulkLoad(info, list.records, list.count);
+
+	// The indexes stay registered, they are rebuilt against the new file by SHT_Reorganize
+	for (int i = 0; error == 0 && i < ht_info->indexCount; i++)
+		error = HT_RegisterIndex(info, ht_info->indexNames + i * HT_INDEX_NAME_SIZE);
+	if (info != NULL && HT_CloseFile(info) != 0) error = -1;
+	free(list.records);
+
+	// The swap is a single rename, a file opened before it still reads the old blocks
+	if (error == 0 && rename(newName, fileName) != 0) error = -1;
+	if (error != 0) remove(newName);
+
+	free(newName);
+	return error;
 }
 
 int HashStatisticsHT(char* filename) {
@@ -380,6 +1349,10 @@ int HashStatisticsHT(char* filename) {
 	// Get number of buckets
 	int buckets = info->numBuckets;
 	int recordsCount = 0;
+
+	// The bucket heads live in the directory chain, not in block 0
+	int* hashTable; int size;
+	if (BC_Read(fileDesc, info->directoryBlock, (char**) &hashTable, &size) != 0) return -1;
 	
 	// for each bucket:
 	// MIN,MID AND MAX NUMBER OF RECORDS in buckets
@@ -404,8 +1377,8 @@ int HashStatisticsHT(char* filename) {
 	for(int i = 0; i < buckets; i++) {
 		int error;
 
-		int bucket = info->hashTable[i];
-		// printf("Currently at bucket: %d starting in block: %d\n", i, info->hashTable[i]);
+		int bucket = hashTable[i];
+		// printf("Currently at bucket: %d starting in block: %d\n", i, hashTable[i]);
 		error = TC(BF_GetBlock(fileDesc, bucket, blockOfBucket));
 		if (error != 0) return -1;
 
@@ -474,6 +1447,7 @@ int HashStatisticsHT(char* filename) {
 
 	free(blocksInBucket);
 	free(recordsInBuckets);
+	free(hashTable);
 	free(ptr);
 	
 	return 0;
@@ -482,19 +1456,20 @@ int HashStatisticsHT(char* filename) {
 MinMax findMinAndMax(int arr[], int N) {
 	MinMax result = malloc(sizeof(minmax));
 
-	int min = arr[0], max = arr[0];
+	// Both start from the first element, or stay 0 for an empty array
+	int min = 0, max = 0;
 	// Traverse the given array
     for (int i = 0; i < N; i++)
     {
         // If current element is smaller
         // than min then update it
-        if (arr[i] < min)
+        if (i == 0 || arr[i] < min)
         {
             min = arr[i];
         }
         // If current element is greater
         // than max then update it
-        if (arr[i] > max)
+        if (i == 0 || arr[i] > max)
         {
             max = arr[i];
         }
@@ -0,0 +1,84 @@
+#include <stdlib.h>
+#include <pthread.h>
+
+#include "bf.h"
+#include "latch.h"
+
+// A latch on a cache line of its own, so that threads on neighbouring stripes do not share one
+typedef union {
+	pthread_mutex_t mutex;
+	char padding[64];
+} Latch_Line;
+
+struct Latch_Table {
+	Latch_Line stripes[LATCH_STRIPES];
+	Latch_Line file;
+};
+
+// The buffer pool is shared by every open file
+static pthread_mutex_t pool = PTHREAD_MUTEX_INITIALIZER;
+
+Latch_Table* LATCH_Create(void) {
+	Latch_Table* latches;
+	if (posix_memalign((void**) &latches, sizeof(Latch_Line), sizeof(Latch_Table)) != 0) return NULL;
+
+	for (int i = 0; i < LATCH_STRIPES; i++)
+		pthread_mutex_init(&latches->stripes[i].mutex, NULL);
+	pthread_mutex_init(&latches->file.mutex, NULL);
+	return latches;
+}
+
+void LATCH_Destroy(Latch_Table* latches) {
+	if (latches == NULL) return;
+	for (int i = 0; i < LATCH_STRIPES; i++)
+		pthread_mutex_destroy(&latches->stripes[i].mutex);
+	pthread_mutex_destroy(&latches->file.mutex);
+	free(latches);
+}
+
+void LATCH_LockBucket(Latch_Table* latches, int bucket) {
+	pthread_mutex_lock(&latches->stripes[bucket & (LATCH_STRIPES - 1)].mutex);
+}
+
+void LATCH_UnlockBucket(Latch_Table* latches, int bucket) {
+	pthread_mutex_unlock(&latches->stripes[bucket & (LATCH_STRIPES - 1)].mutex);
+}
+
+void LATCH_LockFile(Latch_Table* latches) {
+	pthread_mutex_lock(&latches->file.mutex);
+}
+
+void LATCH_UnlockFile(Latch_Table* latches) {
+	pthread_mutex_unlock(&latches->file.mutex);
+}
+
+BF_ErrorCode LATCH_GetBlock(int fileDesc, int blockId, BF_Block* block) {
+	pthread_mutex_lock(&pool);
+	BF_ErrorCode code = BF_GetBlock(fileDesc, blockId, block);
+	pthread_mutex_unlock(&pool);
+	return code;
+}
+
+BF_ErrorCode LATCH_AllocateBlock(int fileDesc, BF_Block* block, int* blockId) {
+	pthread_mutex_lock(&pool);
+	BF_ErrorCode code = BF_AllocateBlock(fileDesc, block);
+	if (code == BF_OK) {
+		BF_GetBlockCounter(fileDesc, blockId);
+		(*blockId)--;	// The new block is the last one
+	}
+	pthread_mutex_unlock(&pool);
+	return code;
+}
+
+BF_ErrorCode LATCH_UnpinBlock(BF_Block* block) {
+	pthread_mutex_lock(&pool);
+	BF_ErrorCode code = BF_UnpinBlock(block);
+	pthread_mutex_unlock(&pool);
+	return code;
+}
+
+void LATCH_SetDirty(BF_Block* block) {
+	pthread_mutex_lock(&pool);
+	BF_Block_SetDirty(block);
+	pthread_mutex_unlock(&pool);
+}
@@ -0,0 +1,456 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "bf.h"
+#include "lh_table.h"
+#include "ht_table.h"
+#include "record.h"
+#include "block_chain.h"
+#include <assert.h>
+
+// 	/*
+// 	Round "level" of the splits, with N = N0 * 2^level
+//
+// 	  split		   not yet split			  images of the split ones
+// 	|<------->|<------------------------->|<--------->|
+// 	 _________ _____________________________ ___________
+// 	|	0	..|	next	...		N - 1		|	N	..	|	hashTable (one chain head per bucket)
+// 	|_________|_____________________________|___________|
+//
+// 	A key goes to h mod N, or to h mod 2N if that bucket has already been split.
+// 	*/
+
+#define LH_RECORDS(blockData) ((blockData) + sizeof(HT_block_info))
+
+static unsigned int LH_Address(LH_info* lh_info, int key) {
+	unsigned int h = (unsigned int) key;
+	unsigned int roundBuckets = (unsigned int) lh_info->initialBuckets << lh_info->level;
+
+	unsigned int address = h % roundBuckets;
+	if (address < (unsigned int) lh_info->next)
+		address = h % (2 * roundBuckets);
+	return address;
+}
+
+// Allocates an empty chain block in front of nextBlock, returns its number (or -1) and leaves it pinned
+static int LH_AllocateBlock(LH_info* lh_info, BF_Block* block, int nextBlock) {
+	int error = TC(BF_AllocateBlock(lh_info->fileDesc, block));
+	if (error != 0) return -1;
+
+	int blockNumber;
+	BF_GetBlockCounter(lh_info->fileDesc, &blockNumber);
+	blockNumber--;
+
+	HT_block_info* blockInfo = (HT_block_info*) BF_Block_GetData(block);
+	blockInfo->recordsCount = lh_info->recordsPerBlock;
+	blockInfo->currentRecords = 0;
+	blockInfo->nextBlock = nextBlock;
+	BF_Block_SetDirty(block);
+
+	return blockNumber;
+}
+
+// Adds a bucket at the end of hashTable, growing the in-memory array when needed
+static int LH_AppendBucket(LH_info* lh_info, int headBlock) {
+	if (lh_info->numBuckets == lh_info->capacity) {
+		lh_info->capacity *= 2;
+		lh_info->hashTable = realloc(lh_info->hashTable, sizeof(int) * lh_info->capacity);
+	}
+	lh_info->hashTable[lh_info->numBuckets] = headBlock;
+	return lh_info->numBuckets++;
+}
+
+static int LH_WriteHeader(LH_info* lh_info) {
+	BF_Block* block;
+	BF_Block_Init(&block);
+
+	int error = TC(BF_GetBlock(lh_info->fileDesc, 0, block));
+	if (error != 0) return -1;
+
+	memcpy(BF_Block_GetData(block), lh_info, sizeof(LH_info));
+	BF_Block_SetDirty(block);
+
+	error = TC(BF_UnpinBlock(block));
+	if (error != 0) return -1;
+
+	BF_Block_Destroy(&block);
+	return 0;
+}
+
+int LH_CreateFile(char *fileName, int buckets, int maxLoad) {
+	int error;
+	int fileDescriptor;
+
+	if (buckets < 1 || maxLoad < 1) return -1;
+
+	error = TC(BF_CreateFile(fileName));
+	if (error != 0) return -1;
+
+	error = TC(BF_OpenFile(fileName, &fileDescriptor));
+	if (error != 0) return -1;
+
+	BF_Block* block;
+	BF_Block_Init(&block);
+
+	// Reserve block 0 for the header
+	error = TC(BF_AllocateBlock(fileDescriptor, block));
+	if (error != 0) return -1;
+	error = TC(BF_UnpinBlock(block));
+	if (error != 0) return -1;
+
+	LH_info info;
+	info.fileDesc = fileDescriptor;
+	info.isHashFile = true;
+	info.isHeapFile = false;
+	info.recordsPerBlock = (BF_BLOCK_SIZE - sizeof(HT_block_info)) / sizeof(Record);
+	info.initialBuckets = buckets;
+	info.level = 0;
+	info.next = 0;
+	info.numBuckets = 0;
+	info.records = 0;
+	info.maxLoad = maxLoad;
+	info.directoryBlock = -1;
+	info.capacity = buckets;
+	info.hashTable = malloc(sizeof(int) * buckets);
+
+	for (int i = 0; i < buckets; i++) {
+		int head = LH_AllocateBlock(&info, block, -1);
+		if (head == -1) return -1;
+		LH_AppendBucket(&info, head);
+
+		error = TC(BF_UnpinBlock(block));
+		if (error != 0) return -1;
+	}
+
+	error = BC_Write(fileDescriptor, &info.directoryBlock, (char*) info.hashTable, sizeof(int) * info.numBuckets);
+	free(info.hashTable);
+	info.hashTable = NULL;
+	if (error != 0) return -1;
+
+	error = LH_WriteHeader(&info);
+	if (error != 0) return -1;
+
+	BF_Block_Destroy(&block);
+
+	error = TC(BF_CloseFile(fileDescriptor));
+	if (error != 0) return -1;
+
+	return 0;
+}
+
+LH_info* LH_OpenFile(char *fileName) {
+	int error;
+	int fileDescriptor;
+
+	error = TC(BF_OpenFile(fileName, &fileDescriptor));
+	if (error != 0) return NULL;
+
+	BF_Block* block;
+	BF_Block_Init(&block);
+
+	error = TC(BF_GetBlock(fileDescriptor, 0, block));
+	if (error != 0) return NULL;
+
+	LH_info* infoSaved = (LH_info*) BF_Block_GetData(block);
+
+	// If the file is not a Hash File, return NULL
+	if (infoSaved->isHeapFile || !infoSaved->isHashFile) {
+		BF_UnpinBlock(block);
+		return NULL;
+	}
+
+	LH_info* toReturn = malloc(sizeof(LH_info));
+	memcpy(toReturn, infoSaved, sizeof(LH_info));
+	toReturn->fileDesc = fileDescriptor;
+
+	error = TC(BF_UnpinBlock(block));
+	if (error != 0) return NULL;
+	BF_Block_Destroy(&block);
+
+	int size;
+	error = BC_Read(fileDescriptor, toReturn->directoryBlock, (char**) &toReturn->hashTable, &size);
+	if (error != 0) return NULL;
+	assert(size == (int) sizeof(int) * toReturn->numBuckets);
+	toReturn->capacity = toReturn->numBuckets;
+
+	return toReturn;
+}
+
+int LH_CloseFile(LH_info* lh_info) {
+	int error;
+	int fileDescriptor = lh_info->fileDesc;
+
+	error = BC_Write(fileDescriptor, &lh_info->directoryBlock, (char*) lh_info->hashTable, sizeof(int) * lh_info->numBuckets);
+	if (error != 0) return -1;
+
+	error = LH_WriteHeader(lh_info);
+	if (error != 0) return -1;
+
+	free(lh_info->hashTable);
+	free(lh_info);
+
+	error = TC(BF_CloseFile(fileDescriptor));
+	if (error != 0) return -1;
+
+	return 0;
+}
+
+// Writes records into the given chain blocks (allocating more if needed), partial block first,
+// and returns the new head of the chain
+static int LH_WriteChain(LH_info* lh_info, Record* records, int count, int* blocks, int* available) {
+	int error;
+	int rpb = lh_info->recordsPerBlock;
+	int needed = (count + rpb - 1) / rpb;
+	if (needed == 0) needed = 1;
+
+	BF_Block* block;
+	BF_Block_Init(&block);
+
+	// Build from the tail (full blocks) to the head, so each block points to the previous one
+	int nextBlock = -1;
+	int written = 0;
+	for (int b = 0; b < needed; b++) {
+		int blockNumber;
+		if (*available > 0) {
+			blockNumber = blocks[--(*available)];
+			error = TC(BF_GetBlock(lh_info->fileDesc, blockNumber, block));
+			if (error != 0) return -1;
+		} else {
+			blockNumber = LH_AllocateBlock(lh_info, block, -1);
+			if (blockNumber == -1) return -1;
+		}
+
+		char* blockData = BF_Block_GetData(block);
+		HT_block_info* blockInfo = (HT_block_info*) blockData;
+
+		int inBlock = (b == needed - 1) ? count - written : rpb;
+		memcpy(LH_RECORDS(blockData), records + written, sizeof(Record) * inBlock);
+		blockInfo->recordsCount = rpb;
+		blockInfo->currentRecords = inBlock;
+		blockInfo->nextBlock = nextBlock;
+		written += inBlock;
+
+		BF_Block_SetDirty(block);
+		error = TC(BF_UnpinBlock(block));
+		if (error != 0) return -1;
+
+		nextBlock = blockNumber;
+	}
+
+	BF_Block_Destroy(&block);
+	return nextBlock;
+}
+
+// Splits bucket next into itself and bucket next + N, then advances the split pointer
+static int LH_Split(LH_info* lh_info) {
+	int error;
+	int bucket = lh_info->next;
+	unsigned int roundBuckets = (unsigned int) lh_info->initialBuckets << lh_info->level;
+
+	BF_Block* block;
+	BF_Block_Init(&block);
+
+	// Read the whole chain, remembering its blocks so that they can be reused
+	int blocksCount = 0, blocksCapacity = 8;
+	int* blocks = malloc(sizeof(int) * blocksCapacity);
+	int recordsCount = 0, recordsCapacity = lh_info->recordsPerBlock * 8;
+	Record* records = malloc(sizeof(Record) * recordsCapacity);
+
+	int current = lh_info->hashTable[bucket];
+	while (current != -1) {
+		error = TC(BF_GetBlock(lh_info->fileDesc, current, block));
+		if (error != 0) return -1;
+
+		char* blockData = BF_Block_GetData(block);
+		HT_block_info* blockInfo = (HT_block_info*) blockData;
+
+		if (blocksCount == blocksCapacity) {
+			blocksCapacity *= 2;
+			blocks = realloc(blocks, sizeof(int) * blocksCapacity);
+		}
+		blocks[blocksCount++] = current;
+
+		if (recordsCount + blockInfo->currentRecords > recordsCapacity) {
+			recordsCapacity = 2 * recordsCapacity + blockInfo->currentRecords;
+			records = realloc(records, sizeof(Record) * recordsCapacity);
+		}
+		memcpy(records + recordsCount, LH_RECORDS(blockData), sizeof(Record) * blockInfo->currentRecords);
+		recordsCount += blockInfo->currentRecords;
+
+		current = blockInfo->nextBlock;
+		error = TC(BF_UnpinBlock(block));
+		if (error != 0) return -1;
+	}
+	BF_Block_Destroy(&block);
+
+	// Partition in place: records that rehash to next + N go to the back
+	int stay = 0;
+	for (int i = 0; i < recordsCount; i++) {
+		if ((unsigned int) records[i].id % (2 * roundBuckets) == (unsigned int) bucket) {
+			Record tmp = records[stay];
+			records[stay++] = records[i];
+			records[i] = tmp;
+		}
+	}
+
+	// Rewrite both chains over the old blocks, the image bucket takes what is left
+	int available = blocksCount;
+	int head = LH_WriteChain(lh_info, records, stay, blocks, &available);
+	if (head == -1) return -1;
+
+	int imageHead = LH_WriteChain(lh_info, records + stay, recordsCount - stay, blocks, &available);
+	if (imageHead == -1) return -1;
+
+	// A bucket that got no records keeps one empty block. Blocks can only be left over
+	// when the old chain had underfilled blocks, which inserts alone never produce
+	lh_info->hashTable[bucket] = head;
+	LH_AppendBucket(lh_info, imageHead);
+
+	// Advance the split pointer, a full round doubles the address space
+	lh_info->next++;
+	if ((unsigned int) lh_info->next == roundBuckets) {
+		lh_info->level++;
+		lh_info->next = 0;
+	}
+
+	free(blocks);
+	free(records);
+	return 0;
+}
+
+int LH_InsertEntry(LH_info* lh_info, Record record) {
+	int error;
+	int bucket = LH_Address(lh_info, record.id);
+	int head = lh_info->hashTable[bucket];
+	int returnBlockId;
+
+	BF_Block* block;
+	BF_Block_Init(&block);
+
+	error = TC(BF_GetBlock(lh_info->fileDesc, head, block));
+	if (error != 0) return -1;
+
+	char* blockData = BF_Block_GetData(block);
+	HT_block_info* blockInfo = (HT_block_info*) blockData;
+
+	if (blockInfo->currentRecords < blockInfo->recordsCount) {
+		// If record fits in the head block, just place it inside
+		((Record*) LH_RECORDS(blockData))[blockInfo->currentRecords++] = record;
+		BF_Block_SetDirty(block);
+		returnBlockId = head;
+	} else {
+		// Otherwise a new head in front of it (reverse chaining, as in HT)
+		BF_Block* newBlock;
+		BF_Block_Init(&newBlock);
+
+		returnBlockId = LH_AllocateBlock(lh_info, newBlock, head);
+		if (returnBlockId == -1) return -1;
+
+		char* newBlockData = BF_Block_GetData(newBlock);
+		HT_block_info* newBlockInfo = (HT_block_info*) newBlockData;
+		((Record*) LH_RECORDS(newBlockData))[newBlockInfo->currentRecords++] = record;
+
+		error = TC(BF_UnpinBlock(newBlock));
+		if (error != 0) return -1;
+		BF_Block_Destroy(&newBlock);
+
+		lh_info->hashTable[bucket] = returnBlockId;
+	}
+
+	error = TC(BF_UnpinBlock(block));
+	if (error != 0) return -1;
+	BF_Block_Destroy(&block);
+
+	lh_info->records++;
+
+	// At most one split per insert, so there is never a long rehash pause
+	long capacity = (long) lh_info->numBuckets * lh_info->recordsPerBlock;
+	if ((long) lh_info->records * 100 > capacity * lh_info->maxLoad) {
+		error = LH_Split(lh_info);
+		if (error != 0) return -1;
+	}
+
+	return returnBlockId;
+}
+
+int LH_GetAllEntries(LH_info* lh_info, int* value) {
+	int error;
+	int blocksRead = 0;
+	BF_Block* block;
+	BF_Block_Init(&block);
+
+	int current = lh_info->hashTable[LH_Address(lh_info, *value)];
+
+	while (current != -1) {
+		error = TC(BF_GetBlock(lh_info->fileDesc, current, block));
+		if (error != 0) return -1;
+		blocksRead++;
+
+		char* blockData = BF_Block_GetData(block);
+		HT_block_info* blockInfo = (HT_block_info*) blockData;
+		Record* records = (Record*) LH_RECORDS(blockData);
+
+		for (int i = 0; i < blockInfo->currentRecords; i++)
+			if (records[i].id == *value)
+				printRecord(records[i]);
+
+		current = blockInfo->nextBlock;
+
+		error = TC(BF_UnpinBlock(block));
+		if (error != 0) return -1;
+	}
+
+	BF_Block_Destroy(&block);
+	return blocksRead;
+}
+
+int HashStatisticsLH(char* filename) {
+	LH_info* info = LH_OpenFile(filename);
+	if (info == NULL) return -1;
+
+	int blockCounter;
+	BF_GetBlockCounter(info->fileDesc, &blockCounter);
+
+	BF_Block* block;
+	BF_Block_Init(&block);
+
+	int totalNumberOfBlocks = 0;
+	int min = -1, max = 0;
+	int nofBucketsWithOverflow = 0;
+
+	for (int i = 0; i < info->numBuckets; i++) {
+		int blocksInBucket = 0;
+		int recordsInBucket = 0;
+
+		int current = info->hashTable[i];
+		while (current != -1) {
+			int error = TC(BF_GetBlock(info->fileDesc, current, block));
+			if (error != 0) return -1;
+
+			HT_block_info* blockInfo = (HT_block_info*) BF_Block_GetData(block);
+			recordsInBucket += blockInfo->currentRecords;
+			blocksInBucket++;
+			current = blockInfo->nextBlock;
+			BF_UnpinBlock(block);
+		}
+
+		if (min == -1 || recordsInBucket < min) min = recordsInBucket;
+		if (recordsInBucket > max) max = recordsInBucket;
+		totalNumberOfBlocks += blocksInBucket;
+		if (blocksInBucket != 1) nofBucketsWithOverflow++;
+	}
+
+	BF_Block_Destroy(&block);
+
+	printf("1. Blocks in the file: %d\n", blockCounter);
+	printf("2. Buckets: %d (level %d, split pointer %d)\n", info->numBuckets, info->level, info->next);
+	printf("3. Total number of records: %d\n", info->records);
+	printf("\t Average number of records per bucket: %d\n", info->records / info->numBuckets);
+	printf("\t Min number of records in a bucket: %d\n", min);
+	printf("\t Max number of records in a bucket: %d\n", max);
+	printf("4. Average number of blocks per bucket: %.2f\n", (double) totalNumberOfBlocks / info->numBuckets);
+	printf("5. Total Number of buckets with overflow blocks: %d\n", nofBucketsWithOverflow);
+
+	return LH_CloseFile(info);
+}
@@ -0,0 +1,680 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "bf.h"
+#include "lsm_tree.h"
+#include "record.h"
+#include "block_chain.h"
+#include "bloom_filter.h"
+#include <assert.h>
+
+// 	/*
+// 	<fileName>: block 0 LSM_info, then the chain of the LSM_run_info of every run (block_chain.h)
+//
+// 	<fileName>.<id>, one sorted run
+// 	_______________________________________________________________________________________
+// 	|	LSM_run_info	|	data block 1	|  ...	|	data block n	| fences  | filter	|
+// 	|	(block 0)		| LSM_block_info	|		|					| (chain) | (chain) |
+// 	|___________________|_Rec[0] Rec[1].._|_______|___________________|_________|_________|
+// 	*/
+
+#define LSM_RECORDS(blockData) ((Record*) ((blockData) + sizeof(LSM_block_info)))
+#define LSM_BLOCK_RECORDS ((BF_BLOCK_SIZE - (int) sizeof(LSM_block_info)) / (int) sizeof(Record))
+
+#define LSM_SKIP_LEVELS 16
+
+// A sorted run while the file is open, its fences and filter are kept in memory
+struct LSM_run {
+	LSM_run_info info;
+	int fileDesc;
+	int* fences;			// First id of every data block
+	unsigned char* filter;
+};
+
+// A record of the memtable, with one link per level of the skip list it is in
+typedef struct LSM_node {
+	Record record;
+	bool deleted;
+	struct LSM_node* next[];
+} LSM_node;
+
+struct LSM_memtable {
+	LSM_node* head;			// Sentinel, present in every level
+	int levels;				// Levels in use
+	int records;
+	unsigned int seed;
+};
+
+static LSM_memtable* LSM_MemtableCreate(void) {
+	LSM_memtable* memtable = malloc(sizeof(LSM_memtable));
+	memtable->head = calloc(1, sizeof(LSM_node) + LSM_SKIP_LEVELS * sizeof(LSM_node*));
+	memtable->levels = 1;
+	memtable->records = 0;
+	memtable->seed = 2463534242u;
+	return memtable;
+}
+
+static void LSM_MemtableClear(LSM_memtable* memtable) {
+	LSM_node* node = memtable->head->next[0];
+	while (node != NULL) {
+		LSM_node* next = node->next[0];
+		free(node);
+		node = next;
+	}
+	memset(memtable->head->next, 0, LSM_SKIP_LEVELS * sizeof(LSM_node*));
+	memtable->levels = 1;
+	memtable->records = 0;
+}
+
+// A node reaches each next level with probability 1/4
+static int LSM_RandomLevel(LSM_memtable* memtable) {
+	int level = 1;
+	while (level < LSM_SKIP_LEVELS) {
+		memtable->seed ^= memtable->seed << 13;
+		memtable->seed ^= memtable->seed >> 17;
+		memtable->seed ^= memtable->seed << 5;
+		if ((memtable->seed & 3) != 0) break;
+		level++;
+	}
+	return level;
+}
+
+// Puts record in the memtable, in place of the one with the same id if there is one
+static void LSM_MemtablePut(LSM_memtable* memtable, const Record* record, bool deleted) {
+	LSM_node* update[LSM_SKIP_LEVELS];
+	LSM_node* node = memtable->head;
+	for (int level = memtable->levels - 1; level >= 0; level--) {
+		while (node->next[level] != NULL && node->next[level]->record.id < record->id)
+			node = node->next[level];
+		update[level] = node;
+	}
+
+	node = node->next[0];
+	if (node != NULL && node->record.id == record->id) {
+		node->record = *record;
+		node->deleted = deleted;
+		return;
+	}
+
+	int levels = LSM_RandomLevel(memtable);
+	for (; memtable->levels < levels; memtable->levels++)
+		update[memtable->levels] = memtable->head;
+
+	node = malloc(sizeof(LSM_node) + levels * sizeof(LSM_node*));
+	node->record = *record;
+	node->deleted = deleted;
+	for (int level = 0; level < levels; level++) {
+		node->next[level] = update[level]->next[level];
+		update[level]->next[level] = node;
+	}
+	memtable->records++;
+}
+
+static LSM_node* LSM_MemtableFind(LSM_memtable* memtable, int value) {
+	LSM_node* node = memtable->head;
+	for (int level = memtable->levels - 1; level >= 0; level--)
+		while (node->next[level] != NULL && node->next[level]->record.id < value)
+			node = node->next[level];
+
+	node = node->next[0];
+	return node != NULL && node->record.id == value ? node : NULL;
+}
+
+static void LSM_RunName(LSM_info* lsm_info, int id, char* name) {
+	sprintf(name, "%s.%d", lsm_info->fileName, id);
+}
+
+// Opens the file of a run and loads its fences and filter
+static int LSM_OpenRun(LSM_info* lsm_info, int id, LSM_run* run) {
+	char name[strlen(lsm_info->fileName) + 16];
+	LSM_RunName(lsm_info, id, name);
+	int error = TC(BF_OpenFile(name, &run->fileDesc));
+	if (error != 0) return -1;
+
+	BF_Block* block;
+	BF_Block_Init(&block);
+	error = TC(BF_GetBlock(run->fileDesc, 0, block));
+	if (error != 0) return -1;
+	memcpy(&run->info, BF_Block_GetData(block), sizeof(LSM_run_info));
+	error = TC(BF_UnpinBlock(block));
+	if (error != 0) return -1;
+	BF_Block_Destroy(&block);
+
+	int size;
+	error = BC_Read(run->fileDesc, run->info.fenceBlock, (char**) &run->fences, &size);
+	if (error != 0 || size != (int) sizeof(int) * run->info.dataBlocks) return -1;
+	error = BC_Read(run->fileDesc, run->info.filterBlock, (char**) &run->filter, &size);
+	if (error != 0 || size != run->info.filterBytes) return -1;
+	return 0;
+}
+
+static int LSM_CloseRun(LSM_run* run) {
+	free(run->fences);
+	free(run->filter);
+	return TC(BF_CloseFile(run->fileDesc));
+}
+
+// Closes a run that was merged away and deletes its file
+static int LSM_DropRun(LSM_info* lsm_info, LSM_run* run) {
+	char name[strlen(lsm_info->fileName) + 16];
+	LSM_RunName(lsm_info, run->info.id, name);
+	if (LSM_CloseRun(run) != 0) return -1;
+	return remove(name);
+}
+
+// Writes the description of every run and the header, the runs it lists are complete
+static int LSM_WriteManifest(LSM_info* lsm_info) {
+	LSM_run_info infos[LSM_MAX_RUNS];
+	for (int i = 0; i < lsm_info->runCount; i++)
+		infos[i] = lsm_info->runs[i].info;
+
+	int error = BC_Write(lsm_info->fileDesc, &lsm_info->runsBlock, (char*) infos, sizeof(LSM_run_info) * lsm_info->runCount);
+	if (error != 0) return -1;
+
+	BF_Block* block;
+	BF_Block_Init(&block);
+	error = TC(BF_GetBlock(lsm_info->fileDesc, 0, block));
+	if (error != 0) return -1;
+
+	memcpy(BF_Block_GetData(block), lsm_info, sizeof(LSM_info));
+	BF_Block_SetDirty(block);
+	error = TC(BF_UnpinBlock(block));
+	if (error != 0) return -1;
+
+	BF_Block_Destroy(&block);
+	return 0;
+}
+
+int LSM_CreateFile(char *fileName, LSM_options options) {
+	int error;
+	int fileDescriptor;
+
+	if (options.memtableRecords < 0 || options.level0Runs < 0 || options.sizeRatio < 0 || options.bloomBitsPerKey < 0) return -1;
+	if (options.memtableRecords == 0) options.memtableRecords = 4096;
+	if (options.level0Runs == 0) options.level0Runs = 4;
+	if (options.sizeRatio == 0) options.sizeRatio = 10;
+	if (options.bloomBitsPerKey == 0) options.bloomBitsPerKey = 10;
+	if (options.level0Runs > LSM_MAX_RUNS / 2 || options.sizeRatio < 2) return -1;
+
+	error = TC(BF_CreateFile(fileName));
+	if (error != 0) return -1;
+
+	error = TC(BF_OpenFile(fileName, &fileDescriptor));
+	if (error != 0) return -1;
+
+	BF_Block* block;
+	BF_Block_Init(&block);
+
+	// Reserve block 0 for the header
+	error = TC(BF_AllocateBlock(fileDescriptor, block));
+	if (error != 0) return -1;
+	error = TC(BF_UnpinBlock(block));
+	if (error != 0) return -1;
+	BF_Block_Destroy(&block);
+
+	LSM_info info;
+	memset(&info, 0, sizeof(LSM_info));
+	info.fileDesc = fileDescriptor;
+	info.isHeapFile = false;
+	info.isHashFile = false;
+	info.isLsmFile = true;
+	info.options = options;
+	info.nextRun = 0;
+	info.runCount = 0;
+	info.runsBlock = -1;
+
+	error = LSM_WriteManifest(&info);
+	if (error != 0) return -1;
+
+	error = TC(BF_CloseFile(fileDescriptor));
+	if (error != 0) return -1;
+
+	return 0;
+}
+
+LSM_info* LSM_OpenFile(char *fileName) {
+	int error;
+	int fileDescriptor;
+
+	error = TC(BF_OpenFile(fileName, &fileDescriptor));
+	if (error != 0) return NULL;
+
+	BF_Block* block;
+	BF_Block_Init(&block);
+
+	error = TC(BF_GetBlock(fileDescriptor, 0, block));
+	if (error != 0) return NULL;
+
+	LSM_info* infoSaved = (LSM_info*) BF_Block_GetData(block);
+
+	// If the file is not an LSM file, return NULL
+	if (infoSaved->isHeapFile || infoSaved->isHashFile || !infoSaved->isLsmFile) {
+		BF_UnpinBlock(block);
+		return NULL;
+	}
+
+	LSM_info* toReturn = malloc(sizeof(LSM_info));
+	memcpy(toReturn, infoSaved, sizeof(LSM_info));
+	toReturn->fileDesc = fileDescriptor;
+	toReturn->fileName = strdup(fileName);
+	toReturn->runs = malloc(sizeof(LSM_run) * LSM_MAX_RUNS);
+	toReturn->memtable = LSM_MemtableCreate();
+
+	error = TC(BF_UnpinBlock(block));
+	if (error != 0) return NULL;
+	BF_Block_Destroy(&block);
+
+	// Every run is opened once, its fences and filter stay in memory
+	LSM_run_info* infos;
+	int size;
+	error = BC_Read(fileDescriptor, toReturn->runsBlock, (char**) &infos, &size);
+	if (error != 0 || size != (int) sizeof(LSM_run_info) * toReturn->runCount) return NULL;
+	for (int i = 0; i < toReturn->runCount; i++)
+		if (LSM_OpenRun(toReturn, infos[i].id, &toReturn->runs[i]) != 0) return NULL;
+	free(infos);
+
+	return toReturn;
+}
+
+// Writes the records of a new run one block after the other
+typedef struct {
+	LSM_info* lsm_info;
+	LSM_run run;
+	BF_Block* block;			// The data block being filled, pinned
+	LSM_block_info* current;	// Its data, NULL before the first record
+	int fenceCapacity;
+} LSM_writer;
+
+static int LSM_BeginRun(LSM_info* lsm_info, LSM_writer* writer, int level, long int expected) {
+	LSM_run* run = &writer->run;
+	memset(run, 0, sizeof(LSM_run));
+	run->info.id = lsm_info->nextRun++;
+	run->info.level = level;
+	run->info.fenceBlock = -1;
+	run->info.filterBlock = -1;
+	run->info.filterBytes = (expected * lsm_info->options.bloomBitsPerKey + 7) / 8;
+	if (run->info.filterBytes == 0) run->info.filterBytes = 1;
+	run->filter = calloc(run->info.filterBytes, 1);
+	writer->fenceCapacity = expected / LSM_BLOCK_RECORDS + 1;
+	run->fences = malloc(sizeof(int) * writer->fenceCapacity);
+
+	writer->lsm_info = lsm_info;
+	writer->current = NULL;
+	BF_Block_Init(&writer->block);
+
+	char name[strlen(lsm_info->fileName) + 16];
+	LSM_RunName(lsm_info, run->info.id, name);
+
+	// No manifest lists an id from nextRun on, a file with that name is left over from an older file
+	remove(name);
+	int error = TC(BF_CreateFile(name));
+	if (error != 0) return -1;
+	error = TC(BF_OpenFile(name, &run->fileDesc));
+	if (error != 0) return -1;
+
+	// Reserve block 0 for the description of the run
+	error = TC(BF_AllocateBlock(run->fileDesc, writer->block));
+	if (error != 0) return -1;
+	return TC(BF_UnpinBlock(writer->block));
+}
+
+static int LSM_Append(LSM_writer* writer, const Record* record, bool deleted) {
+	LSM_run* run = &writer->run;
+
+	// A full block is done with, the next one is appended right after it
+	if (writer->current == NULL || writer->current->count == LSM_BLOCK_RECORDS) {
+		if (writer->current != NULL) {
+			BF_Block_SetDirty(writer->block);
+			if (TC(BF_UnpinBlock(writer->block)) != 0) return -1;
+		}
+		if (TC(BF_AllocateBlock(run->fileDesc, writer->block)) != 0) return -1;
+		writer->current = (LSM_block_info*) BF_Block_GetData(writer->block);
+		writer->current->count = 0;
+		writer->current->deleted = 0;
+
+		if (run->info.dataBlocks == writer->fenceCapacity) {
+			writer->fenceCapacity *= 2;
+			run->fences = realloc(run->fences, sizeof(int) * writer->fenceCapacity);
+		}
+		run->fences[run->info.dataBlocks++] = record->id;
+	}
+
+	int i = writer->current->count++;
+	LSM_RECORDS((char*) writer->current)[i] = *record;
+	if (deleted) writer->current->deleted |= 1u << i;
+
+	if (run->info.records == 0) run->info.minKey = record->id;
+	run->info.maxKey = record->id;
+	run->info.records++;
+	BLOOM_Set(run->filter, run->info.filterBytes, (unsigned int) record->id);
+	return 0;
+}
+
+// Completes the run with its fences, filter and description. A run left empty is deleted, *written tells
+static int LSM_EndRun(LSM_writer* writer, bool* written) {
+	LSM_info* lsm_info = writer->lsm_info;
+	LSM_run* run = &writer->run;
+	int error;
+
+	if (writer->current != NULL) {
+		BF_Block_SetDirty(writer->block);
+		error = TC(BF_UnpinBlock(writer->block));
+		if (error != 0) return -1;
+	}
+
+	*written = run->info.records > 0;
+	if (!*written) {
+		BF_Block_Destroy(&writer->block);
+		return LSM_DropRun(lsm_info, run);
+	}
+
+	error = BC_Write(run->fileDesc, &run->info.fenceBlock, (char*) run->fences, sizeof(int) * run->info.dataBlocks);
+	if (error != 0) return -1;
+	error = BC_Write(run->fileDesc, &run->info.filterBlock, (char*) run->filter, run->info.filterBytes);
+	if (error != 0) return -1;
+
+	error = TC(BF_GetBlock(run->fileDesc, 0, writer->block));
+	if (error != 0) return -1;
+	memcpy(BF_Block_GetData(writer->block), &run->info, sizeof(LSM_run_info));
+	BF_Block_SetDirty(writer->block);
+	error = TC(BF_UnpinBlock(writer->block));
+	if (error != 0) return -1;
+	BF_Block_Destroy(&writer->block);
+
+	int blocks;
+	BF_GetBlockCounter(run->fileDesc, &blocks);
+	lsm_info->blocksWritten += blocks;
+	return 0;
+}
+
+// Reads the records of a run in id order, one pinned block at a time
+typedef struct {
+	LSM_run* run;
+	BF_Block* block;
+	int blockId;
+	int index;
+	LSM_block_info* current;	// NULL once every record has been read
+} LSM_cursor;
+
+static int LSM_CursorNext(LSM_cursor* cursor) {
+	if (cursor->current != NULL && ++cursor->index < cursor->current->count) return 0;
+
+	if (cursor->current != NULL && TC(BF_UnpinBlock(cursor->block)) != 0) return -1;
+	cursor->current = NULL;
+	if (++cursor->blockId > cursor->run->info.dataBlocks) return 0;
+
+	if (TC(BF_GetBlock(cursor->run->fileDesc, cursor->blockId, cursor->block)) != 0) return -1;
+	cursor->current = (LSM_block_info*) BF_Block_GetData(cursor->block);
+	cursor->index = 0;
+	return 0;
+}
+
+static Record* LSM_CursorRecord(LSM_cursor* cursor) {
+	return &LSM_RECORDS((char*) cursor->current)[cursor->index];
+}
+
+// Merges the runs, newest first, into one run of level. Of the versions of an id only the newest is
+// kept, and deletions are dropped once nothing older can be below them (bottom).
+static int LSM_Merge(LSM_info* lsm_info, LSM_run** inputs, int n, int level, bool bottom, LSM_run* output, bool* written) {
+	long int expected = 0;
+	for (int i = 0; i < n; i++)
+		expected += inputs[i]->info.records;
+
+	LSM_writer writer;
+	if (LSM_BeginRun(lsm_info, &writer, level, expected) != 0) return -1;
+
+	LSM_cursor cursors[LSM_MAX_RUNS];
+	for (int i = 0; i < n; i++) {
+		cursors[i].run = inputs[i];
+		cursors[i].blockId = 0;
+		cursors[i].current = NULL;
+		BF_Block_Init(&cursors[i].block);
+		if (LSM_CursorNext(&cursors[i]) != 0) return -1;
+	}
+
+	while ( true ) {
+		// The smallest id left, ties go to the newest run
+		int newest = -1;
+		for (int i = 0; i < n; i++)
+			if (cursors[i].current != NULL && (newest == -1 || LSM_CursorRecord(&cursors[i])->id < LSM_CursorRecord(&cursors[newest])->id))
+				newest = i;
+		if (newest == -1) break;
+
+		Record record = *LSM_CursorRecord(&cursors[newest]);
+		bool deleted = (cursors[newest].current->deleted >> cursors[newest].index & 1) != 0;
+		if (!(deleted && bottom))
+			if (LSM_Append(&writer, &record, deleted) != 0) return -1;
+
+		// Older versions of the id are skipped
+		for (int i = newest; i < n; i++)
+			if (cursors[i].current != NULL && LSM_CursorRecord(&cursors[i])->id == record.id)
+				if (LSM_CursorNext(&cursors[i]) != 0) return -1;
+	}
+
+	for (int i = 0; i < n; i++)
+		BF_Block_Destroy(&cursors[i].block);
+
+	if (LSM_EndRun(&writer, written) != 0) return -1;
+	*output = writer.run;
+	return 0;
+}
+
+// The position of the run of level (>= 1) in runs, or -1 if the level is empty
+static int LSM_FindLevel(LSM_info* lsm_info, int level) {
+	for (int i = 0; i < lsm_info->runCount; i++)
+		if (lsm_info->runs[i].info.level == level) return i;
+	return -1;
+}
+
+// Merges the runs at positions [first, first + n) of runs into one run of level, which takes their place
+static int LSM_Compact(LSM_info* lsm_info, int first, int n, int level) {
+	LSM_run* inputs[LSM_MAX_RUNS];
+	for (int i = 0; i < n; i++)
+		inputs[i] = &lsm_info->runs[first + i];
+
+	// Nothing older lies below the output if it goes to the last level
+	bool bottom = first + n == lsm_info->runCount;
+
+	LSM_run output;
+	bool written;
+	if (LSM_Merge(lsm_info, inputs, n, level, bottom, &output, &written) != 0) return -1;
+
+	LSM_run merged[LSM_MAX_RUNS];
+	memcpy(merged, lsm_info->runs + first, sizeof(LSM_run) * n);
+	memmove(lsm_info->runs + first + written, lsm_info->runs + first + n, sizeof(LSM_run) * (lsm_info->runCount - first - n));
+	if (written) lsm_info->runs[first] = output;
+	lsm_info->runCount += written - n;
+	lsm_info->compactions++;
+
+	// The manifest lists the new run before the old files go away
+	if (LSM_WriteManifest(lsm_info) != 0) return -1;
+	for (int i = 0; i < n; i++)
+		if (LSM_DropRun(lsm_info, &merged[i]) != 0) return -1;
+	return 0;
+}
+
+// Merges level 0 into level 1 once it has level0Runs runs, then every level that outgrew its size into the next
+static int LSM_CompactLevels(LSM_info* lsm_info) {
+	int level0 = 0;
+	while (level0 < lsm_info->runCount && lsm_info->runs[level0].info.level == 0)
+		level0++;
+
+	if (level0 >= lsm_info->options.level0Runs) {
+		int n = level0 + (LSM_FindLevel(lsm_info, 1) != -1);
+		if (LSM_Compact(lsm_info, 0, n, 1) != 0) return -1;
+	}
+
+	long int capacity = (long int) lsm_info->options.memtableRecords * lsm_info->options.level0Runs;
+	for (int level = 1; ; level++) {
+		capacity *= lsm_info->options.sizeRatio;
+		int position = LSM_FindLevel(lsm_info, level);
+		if (position == -1 || lsm_info->runs[position].info.records <= capacity) break;
+
+		// A run that has nothing below it moves down a level without being rewritten
+		if (LSM_FindLevel(lsm_info, level + 1) == -1) {
+			lsm_info->runs[position].info.level = level + 1;
+			if (LSM_WriteManifest(lsm_info) != 0) return -1;
+			continue;
+		}
+		if (LSM_Compact(lsm_info, position, 2, level + 1) != 0) return -1;
+	}
+	return 0;
+}
+
+int LSM_Flush(LSM_info* lsm_info) {
+	LSM_memtable* memtable = lsm_info->memtable;
+	if (memtable->records == 0) return 0;
+	if (lsm_info->runCount == LSM_MAX_RUNS) return -1;
+
+	// The memtable is already in id order, it is written as it is
+	LSM_writer writer;
+	if (LSM_BeginRun(lsm_info, &writer, 0, memtable->records) != 0) return -1;
+	bool bottom = lsm_info->runCount == 0;
+	for (LSM_node* node = memtable->head->next[0]; node != NULL; node = node->next[0])
+		if (!(node->deleted && bottom))
+			if (LSM_Append(&writer, &node->record, node->deleted) != 0) return -1;
+
+	bool written;
+	if (LSM_EndRun(&writer, &written) != 0) return -1;
+	LSM_MemtableClear(memtable);
+	lsm_info->flushes++;
+
+	// The newest run goes first
+	if (written) {
+		memmove(lsm_info->runs + 1, lsm_info->runs, sizeof(LSM_run) * lsm_info->runCount);
+		lsm_info->runs[0] = writer.run;
+		lsm_info->runCount++;
+		if (LSM_WriteManifest(lsm_info) != 0) return -1;
+	}
+
+	return LSM_CompactLevels(lsm_info);
+}
+
+int LSM_CloseFile(LSM_info* lsm_info) {
+	int error;
+	int fileDescriptor = lsm_info->fileDesc;
+
+	// Whatever is in memory becomes a run
+	error = LSM_Flush(lsm_info);
+	if (error != 0) return -1;
+	error = LSM_WriteManifest(lsm_info);
+	if (error != 0) return -1;
+
+	for (int i = 0; i < lsm_info->runCount; i++)
+		if (LSM_CloseRun(&lsm_info->runs[i]) != 0) return -1;
+
+	LSM_MemtableClear(lsm_info->memtable);
+	free(lsm_info->memtable->head);
+	free(lsm_info->memtable);
+	free(lsm_info->runs);
+	free(lsm_info->fileName);
+	free(lsm_info);
+
+	error = TC(BF_CloseFile(fileDescriptor));
+	if (error != 0) return -1;
+
+	return 0;
+}
+
+int LSM_InsertEntry(LSM_info* lsm_info, Record record) {
+	LSM_MemtablePut(lsm_info->memtable, &record, false);
+	if (lsm_info->memtable->records < lsm_info->options.memtableRecords) return 0;
+	return LSM_Flush(lsm_info);
+}
+
+int LSM_DeleteEntry(LSM_info* lsm_info, int value) {
+	Record record;
+	memset(&record, 0, sizeof(Record));
+	record.id = value;
+	LSM_MemtablePut(lsm_info->memtable, &record, true);
+	if (lsm_info->memtable->records < lsm_info->options.memtableRecords) return 0;
+	return LSM_Flush(lsm_info);
+}
+
+// Looks value up from the newest data to the oldest, the first version found is the current one.
+// Returns the blocks read, or -1. *found tells if a live record was found and copied to record.
+static int LSM_Lookup(LSM_info* lsm_info, int value, Record* record, bool* found) {
+	*found = false;
+	LSM_node* node = LSM_MemtableFind(lsm_info->memtable, value);
+	if (node != NULL) {
+		*found = !node->deleted;
+		*record = node->record;
+		return 0;
+	}
+
+	int blocksRead = 0;
+	BF_Block* block;
+	BF_Block_Init(&block);
+
+	for (int r = 0; r < lsm_info->runCount; r++) {
+		LSM_run* run = &lsm_info->runs[r];
+
+		// The key range and the filter rule most runs out without reading them
+		if (value < run->info.minKey || value > run->info.maxKey) continue;
+		if (!BLOOM_Test(run->filter, run->info.filterBytes, (unsigned int) value)) continue;
+
+		// The last block that starts at or before value is the only one that may hold it
+		int low = 0, high = run->info.dataBlocks;
+		while (high - low > 1) {
+			int middle = (low + high) / 2;
+			if (run->fences[middle] <= value) low = middle;
+			else high = middle;
+		}
+
+		int error = TC(BF_GetBlock(run->fileDesc, low + 1, block));
+		if (error != 0) return -1;
+		blocksRead++;
+
+		LSM_block_info* blockInfo = (LSM_block_info*) BF_Block_GetData(block);
+		Record* records = LSM_RECORDS((char*) blockInfo);
+		int i = 0;
+		while (i < blockInfo->count && records[i].id < value) i++;
+		bool present = i < blockInfo->count && records[i].id == value;
+		if (present) {
+			*found = (blockInfo->deleted >> i & 1) == 0;
+			*record = records[i];
+		}
+
+		error = TC(BF_UnpinBlock(block));
+		if (error != 0) return -1;
+		if (present) break;
+	}
+
+	BF_Block_Destroy(&block);
+	return blocksRead;
+}
+
+int LSM_GetEntry(LSM_info* lsm_info, int value, Record* record) {
+	bool found;
+	if (LSM_Lookup(lsm_info, value, record, &found) == -1) return -1;
+	return found ? 1 : 0;
+}
+
+int LSM_GetAllEntries(LSM_info* lsm_info, int* value) {
+	Record record;
+	bool found;
+	int blocksRead = LSM_Lookup(lsm_info, *value, &record, &found);
+	if (blocksRead != -1 && found) printRecord(record);
+	return blocksRead;
+}
+
+int StatisticsLSM(char* filename) {
+	LSM_info* info = LSM_OpenFile(filename);
+	if (info == NULL) return -1;
+
+	long int records = 0;
+	int blocks = 0;
+	printf("1. Runs: %d (flushes: %ld, compactions: %ld)\n", info->runCount, info->flushes, info->compactions);
+	for (int i = 0; i < info->runCount; i++) {
+		LSM_run_info* run = &info->runs[i].info;
+		printf("\t Level %d, run %d: %ld records in %d blocks, ids %d .. %d\n",
+			run->level, run->id, run->records, run->dataBlocks, run->minKey, run->maxKey);
+		records += run->records;
+		blocks += run->dataBlocks;
+	}
+	printf("2. Records in the runs: %ld, in %d data blocks\n", records, blocks);
+	printf("3. Blocks written by flushes and compactions: %ld\n", info->blocksWritten);
+
+	return LSM_CloseFile(info);
+}
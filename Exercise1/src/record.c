@@ -69,3 +69,156 @@ void printRecord(Record record){
 
 
 
+
+
+int recordSize(Record_Format format) {
+    if (format == ENCODED_FORMAT)
+        return sizeof(EncodedRecord);
+    if (format == SLOTTED_FORMAT)
+        return sizeof(int) + 3 + (15 - 1) + (20 - 1) + (20 - 1);
+    return sizeof(Record);
+}
+
+// Returns the code of value in values[], appending it if it is not there yet
+static int dictionaryCode(char* values, int width, int* count, const char* value) {
+    for (int i = 0; i < *count; i++)
+        if (strcmp(values + i * width, value) == 0)
+            return i;
+
+    if (*count == DICTIONARY_SIZE)
+        return -1;
+
+    // Truncate like the fixed layout would, the field is width bytes long
+    int length = strlen(value);
+    if (length > width - 1) length = width - 1;
+    memcpy(values + *count * width, value, length);
+    values[*count * width + length] = '\0';
+    return (*count)++;
+}
+
+int encodeRecord(Record_Dictionary* dictionary, Record record, EncodedRecord* encoded) {
+    int name = dictionaryCode((char*) dictionary->name, 15, &dictionary->names, record.name);
+    int surname = dictionaryCode((char*) dictionary->surname, 20, &dictionary->surnames, record.surname);
+    int city = dictionaryCode((char*) dictionary->city, 20, &dictionary->cities, record.city);
+    if (name == -1 || surname == -1 || city == -1)
+        return -1;
+
+    encoded->id = record.id;
+    encoded->name = name;
+    encoded->surname = surname;
+    encoded->city = city;
+    return 0;
+}
+
+Record decodeRecord(Record_Dictionary* dictionary, EncodedRecord encoded) {
+    Record record;
+    memcpy(record.record, "record", strlen("record")+1);
+    record.id = encoded.id;
+    memcpy(record.name, dictionary->name[encoded.name], sizeof(record.name));
+    memcpy(record.surname, dictionary->surname[encoded.surname], sizeof(record.surname));
+    memcpy(record.city, dictionary->city[encoded.city], sizeof(record.city));
+    return record;
+}
+
+// Writes value as [length (1 byte)][characters], without the terminating \0
+static char* putString(char* dest, const char* value, int width) {
+    int length = strnlen(value, width - 1);
+    *dest++ = (unsigned char) length;
+    memcpy(dest, value, length);
+    return dest + length;
+}
+
+static char* getString(char* src, char* value) {
+    int length = (unsigned char) *src++;
+    memcpy(value, src, length);
+    value[length] = '\0';
+    return src + length;
+}
+
+int serializeRecord(Record record, char* dest) {
+    char* pos = dest;
+    memcpy(pos, &record.id, sizeof(int));
+    pos += sizeof(int);
+    pos = putString(pos, record.name, sizeof(record.name));
+    pos = putString(pos, record.surname, sizeof(record.surname));
+    pos = putString(pos, record.city, sizeof(record.city));
+    return pos - dest;
+}
+
+Record deserializeRecord(char* src) {
+    Record record;
+    memcpy(record.record, "record", strlen("record")+1);
+    memcpy(&record.id, src, sizeof(int));
+    src += sizeof(int);
+    src = getString(src, record.name);
+    src = getString(src, record.surname);
+    src = getString(src, record.city);
+    return record;
+}
+
+int storeRecord(Record_Format format, Record_Dictionary* dictionary, Record record, char* dest) {
+    if (format == ENCODED_FORMAT) {
+        EncodedRecord encoded;
+        if (encodeRecord(dictionary, record, &encoded) != 0)
+            return -1;
+        memcpy(dest, &encoded, sizeof(EncodedRecord));
+        return sizeof(EncodedRecord);
+    }
+    if (format == SLOTTED_FORMAT)
+        return serializeRecord(record, dest);
+
+    memcpy(dest, &record, sizeof(Record));
+    return sizeof(Record);
+}
+
+Record loadRecord(Record_Format format, Record_Dictionary* dictionary, char* src) {
+    if (format == ENCODED_FORMAT)
+        return decodeRecord(dictionary, *((EncodedRecord*) src));
+    if (format == SLOTTED_FORMAT)
+        return deserializeRecord(src);
+    return *((Record*) src);
+}
+
+/*
+    Serialized dictionary:
+    [names (1 byte)] name\0 name\0 ... [surnames (1 byte)] surname\0 ... [cities (1 byte)] city\0 ...
+*/
+char* serializeDictionary(Record_Dictionary* dictionary, int* size) {
+    char* data = malloc(3 + sizeof(dictionary->name) + sizeof(dictionary->surname) + sizeof(dictionary->city));
+    char* pos = data;
+
+    int counts[3] = { dictionary->names, dictionary->surnames, dictionary->cities };
+    char* values[3] = { (char*) dictionary->name, (char*) dictionary->surname, (char*) dictionary->city };
+    int widths[3] = { 15, 20, 20 };
+
+    for (int a = 0; a < 3; a++) {
+        *pos++ = (unsigned char) counts[a];
+        for (int i = 0; i < counts[a]; i++) {
+            int length = strlen(values[a] + i * widths[a]) + 1;
+            memcpy(pos, values[a] + i * widths[a], length);
+            pos += length;
+        }
+    }
+
+    *size = pos - data;
+    return data;
+}
+
+void deserializeDictionary(Record_Dictionary* dictionary, char* data, int size) {
+    int* counts[3] = { &dictionary->names, &dictionary->surnames, &dictionary->cities };
+    char* values[3] = { (char*) dictionary->name, (char*) dictionary->surname, (char*) dictionary->city };
+    int widths[3] = { 15, 20, 20 };
+    char* pos = data;
+
+    for (int a = 0; a < 3; a++) {
+        *counts[a] = 0;
+        if (pos >= data + size) continue;
+
+        *counts[a] = (unsigned char) *pos++;
+        for (int i = 0; i < *counts[a]; i++) {
+            int length = strlen(pos) + 1;
+            memcpy(values[a] + i * widths[a], pos, length);
+            pos += length;
+        }
+    }
+}
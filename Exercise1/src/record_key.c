@@ -0,0 +1,78 @@
+#include <stdio.h>
+#include <string.h>
+
+#include "record_key.h"
+
+// Mixes the hash of one more attribute into the hash of a composite key
+static inline unsigned int RK_Combine(unsigned int hash, unsigned int part) {
+	return hash ^ (part + 0x9e3779b9u + (hash << 6) + (hash >> 2));
+}
+
+// Generic over key, but only ever called with a constant, so every copy keeps the branches of its own attributes
+static inline __attribute__((always_inline)) unsigned int RK_HashFields(Hash_Function function, const Record* record, Record_Key key) {
+	unsigned int hash = 0;
+	bool first = true;
+
+	if (key & RECORD_KEY(ID)) {
+		hash = HF_HashInt(function, record->id);
+		first = false;
+	}
+	if (key & RECORD_KEY(NAME)) {
+		unsigned int part = HF_HashString(function, record->name);
+		hash = first ? part : RK_Combine(hash, part);
+		first = false;
+	}
+	if (key & RECORD_KEY(SURNAME)) {
+		unsigned int part = HF_HashString(function, record->surname);
+		hash = first ? part : RK_Combine(hash, part);
+		first = false;
+	}
+	if (key & RECORD_KEY(CITY)) {
+		unsigned int part = HF_HashString(function, record->city);
+		hash = first ? part : RK_Combine(hash, part);
+	}
+	return hash;
+}
+
+static inline __attribute__((always_inline)) bool RK_EqualFields(const Record* a, const Record* b, Record_Key key) {
+	if ((key & RECORD_KEY(ID)) && a->id != b->id) return false;
+	if ((key & RECORD_KEY(NAME)) && strcmp(a->name, b->name) != 0) return false;
+	if ((key & RECORD_KEY(SURNAME)) && strcmp(a->surname, b->surname) != 0) return false;
+	if ((key & RECORD_KEY(CITY)) && strcmp(a->city, b->city) != 0) return false;
+	return true;
+}
+
+// One copy of the key functions per combination of attributes
+#define RK_SPECIALIZE(key)                                                                              \
+	static unsigned int RK_Hash##key(Hash_Function function, const Record* record) {                    \
+		return RK_HashFields(function, record, key);                                                    \
+	}                                                                                                   \
+	static bool RK_Equals##key(const Record* a, const Record* b) {                                      \
+		return RK_EqualFields(a, b, key);                                                               \
+	}
+
+RK_SPECIALIZE(1)  RK_SPECIALIZE(2)  RK_SPECIALIZE(3)  RK_SPECIALIZE(4)  RK_SPECIALIZE(5)
+RK_SPECIALIZE(6)  RK_SPECIALIZE(7)  RK_SPECIALIZE(8)  RK_SPECIALIZE(9)  RK_SPECIALIZE(10)
+RK_SPECIALIZE(11) RK_SPECIALIZE(12) RK_SPECIALIZE(13) RK_SPECIALIZE(14) RK_SPECIALIZE(15)
+
+static const Key_Operations operations[RECORD_KEYS] = {
+	{ NULL, NULL },
+	{ RK_Hash1, RK_Equals1 },   { RK_Hash2, RK_Equals2 },   { RK_Hash3, RK_Equals3 },
+	{ RK_Hash4, RK_Equals4 },   { RK_Hash5, RK_Equals5 },   { RK_Hash6, RK_Equals6 },
+	{ RK_Hash7, RK_Equals7 },   { RK_Hash8, RK_Equals8 },   { RK_Hash9, RK_Equals9 },
+	{ RK_Hash10, RK_Equals10 }, { RK_Hash11, RK_Equals11 }, { RK_Hash12, RK_Equals12 },
+	{ RK_Hash13, RK_Equals13 }, { RK_Hash14, RK_Equals14 }, { RK_Hash15, RK_Equals15 }
+};
+
+const Key_Operations* RK_Operations(Record_Key key) {
+	if (key == 0 || key >= RECORD_KEYS) return NULL;
+	return &operations[key];
+}
+
+void RK_Print(Record_Key key, const Record* record) {
+	const char* separator = "";
+	if (key & RECORD_KEY(ID))      { printf("%s%d", separator, record->id); separator = ", "; }
+	if (key & RECORD_KEY(NAME))    { printf("%s%s", separator, record->name); separator = ", "; }
+	if (key & RECORD_KEY(SURNAME)) { printf("%s%s", separator, record->surname); separator = ", "; }
+	if (key & RECORD_KEY(CITY))    { printf("%s%s", separator, record->city); }
+}
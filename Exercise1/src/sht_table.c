@@ -1,11 +1,19 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <pthread.h>
 
 #include "bf.h"
 #include "sht_table.h"
 #include "ht_table.h"
 #include "record.h"
+#include "block_chain.h"
+#include "slotted_page.h"
+#include "hash_function.h"
+#include "bloom_filter.h"
+#include "latch.h"
+#include "entry_set.h"
+#include "record_key.h"
 
 #include <assert.h>
 
@@ -19,14 +27,364 @@
   }
 
 typedef struct {
-  int blockId;
-  char name[16];
+  int blockId;		// The primary record's rid (HT_RID) instead, in an index with rids
+  char value[20];	// The indexed attribute of the record, its name by default
+  // The included columns, stored only in a covering index (SHT_options.include)
+  int id;
+  char name[15];
+  char surname[20];
+  char city[20];
 } secIndexEntry;
 
+// The columns a covering index can include, the indexed attribute is in every entry anyway
+#define SHT_INCLUDABLE (RECORD_KEY(ID) | RECORD_KEY(NAME) | RECORD_KEY(SURNAME) | RECORD_KEY(CITY))
+
+// The value of the indexed attribute of record
+static char* SHT_Value(SHT_info* sht_info, Record* record) {
+	switch (sht_info->attribute) {
+	case SURNAME: return record->surname;
+	case CITY: return record->city;
+	default: return record->name;
+	}
+}
+
+// Bytes of the value in an entry. Names keep the 16 bytes they always had, the longer attributes take 20
+static int SHT_ValueSize(const SHT_info* sht_info) {
+	return sht_info->attribute == NAME ? 16 : sizeof(((secIndexEntry*) 0)->value);
+}
+
+// The part of an index block after its SHT_block_info, where entries are kept
+#define SHT_ENTRY_AREA(blockData) ((blockData) + sizeof(SHT_block_info))
+#define SHT_ENTRY_AREA_SIZE (BF_BLOCK_SIZE - (int) sizeof(SHT_block_info))
+
+// With fingerprints the area starts with one tag per entry, followed by the entries
+#define SHT_TAGS(blockData) ((unsigned char*) SHT_ENTRY_AREA(blockData))
+#define SHT_ENTRIES(sht_info, blockData) (SHT_ENTRY_AREA(blockData) + (sht_info)->tagBytes)
+
+// Bytes of an entry of the index in a block. A slotted entry trades the padding of every string for its
+// length byte, so this is also the most a slotted entry takes.
+static int SHT_EntrySize(const SHT_info* sht_info) {
+	Record_Key include = sht_info->include;
+	int size = sizeof(int) + SHT_ValueSize(sht_info);
+	if (include & RECORD_KEY(ID)) size += sizeof(int);
+	if (include & RECORD_KEY(NAME)) size += sizeof(((secIndexEntry*) 0)->name);
+	if (include & RECORD_KEY(SURNAME)) size += sizeof(((secIndexEntry*) 0)->surname);
+	if (include & RECORD_KEY(CITY)) size += sizeof(((secIndexEntry*) 0)->city);
+	return size;
+}
+
+static int SHT_PackString(char* out, const char* value, int size, bool variable) {
+	if (!variable) {
+		memcpy(out, value, size);
+		return size;
+	}
+	int length = strlen(value);
+	out[0] = (unsigned char) length;
+	memcpy(out + 1, value, length);
+	return 1 + length;
+}
+
+static int SHT_UnpackString(const char* in, char* value, int size, bool variable) {
+	if (!variable) {
+		memcpy(value, in, size);
+		return size;
+	}
+	int length = (unsigned char) in[0];
+	memcpy(value, in + 1, length);
+	value[length] = '\0';
+	return 1 + length;
+}
+
+// Writes the entry as a block stores it: [blockId][value], then the included columns in the order id, name,
+// surname, city. The fixed layout keeps every string array whole, the slotted one each string after its length byte.
+static int SHT_PackEntry(SHT_info* sht_info, const secIndexEntry* entry, char* out) {
+	bool variable = sht_info->format == SLOTTED_FORMAT;
+	int n = sizeof(int);
+	memcpy(out, &entry->blockId, sizeof(int));
+	n += SHT_PackString(out + n, entry->value, SHT_ValueSize(sht_info), variable);
+	if (sht_info->include & RECORD_KEY(ID)) {
+		memcpy(out + n, &entry->id, sizeof(int));
+		n += sizeof(int);
+	}
+	if (sht_info->include & RECORD_KEY(NAME))
+		n += SHT_PackString(out + n, entry->name, sizeof(entry->name), variable);
+	if (sht_info->include & RECORD_KEY(SURNAME))
+		n += SHT_PackString(out + n, entry->surname, sizeof(entry->surname), variable);
+	if (sht_info->include & RECORD_KEY(CITY))
+		n += SHT_PackString(out + n, entry->city, sizeof(entry->city), variable);
+	return n;
+}
+
+static void SHT_UnpackEntry(SHT_info* sht_info, const char* in, secIndexEntry* entry) {
+	bool variable = sht_info->format == SLOTTED_FORMAT;
+	int n = sizeof(int);
+	memcpy(&entry->blockId, in, sizeof(int));
+	n += SHT_UnpackString(in + n, entry->value, SHT_ValueSize(sht_info), variable);
+	if (sht_info->include & RECORD_KEY(ID)) {
+		memcpy(&entry->id, in + n, sizeof(int));
+		n += sizeof(int);
+	}
+	if (sht_info->include & RECORD_KEY(NAME))
+		n += SHT_UnpackString(in + n, entry->name, sizeof(entry->name), variable);
+	if (sht_info->include & RECORD_KEY(SURNAME))
+		n += SHT_UnpackString(in + n, entry->surname, sizeof(entry->surname), variable);
+	if (sht_info->include & RECORD_KEY(CITY))
+		SHT_UnpackString(in + n, entry->city, sizeof(entry->city), variable);
+}
+
+// The entry of record, every included column is filled in and the index stores the ones it has
+static void SHT_MakeEntry(SHT_info* sht_info, secIndexEntry* entry, Record* record, int blockId) {
+	memset(entry, 0, sizeof(secIndexEntry));
+	entry->blockId = blockId;
+	strcpy(entry->value, SHT_Value(sht_info, record));
+	entry->id = record->id;
+	strcpy(entry->name, record->name);
+	strcpy(entry->surname, record->surname);
+	strcpy(entry->city, record->city);
+}
+
+// Initializes an empty index block that continues to nextBlock
+static void SHT_InitBlock(SHT_info* sht_info, char* blockData, int nextBlock) {
+	SHT_block_info* blockInfo = (SHT_block_info*) blockData;
+	blockInfo->recordsCount = sht_info->recordsPerBlock;
+	blockInfo->currentRecords = 0;
+	blockInfo->nextBlock = nextBlock;
+
+	if (sht_info->format == SLOTTED_FORMAT)
+		SP_Init(SHT_ENTRY_AREA(blockData), SHT_ENTRY_AREA_SIZE);
+}
+
+// Places the entry and its fingerprint in the block, returns -1 if it does not fit
+static int SHT_PlaceEntry(SHT_info* sht_info, char* blockData, secIndexEntry* entry, unsigned char tag) {
+	SHT_block_info* blockInfo = (SHT_block_info*) blockData;
+
+	if (sht_info->format == SLOTTED_FORMAT) {
+		// Variable length entry: [blockId][length (1 byte)][name characters], then the included columns
+		char tuple[sizeof(secIndexEntry)];
+		int length = SHT_PackEntry(sht_info, entry, tuple);
+
+		char* page = SHT_ENTRY_AREA(blockData);
+		if (SP_Insert(page, tuple, length) == -1) return -1;
+		blockInfo->currentRecords = SP_Slots(page);
+		return 0;
+	}
+
+	if (blockInfo->currentRecords >= blockInfo->recordsCount) return -1;
+	SHT_PackEntry(sht_info, entry, SHT_ENTRIES(sht_info, blockData) + blockInfo->currentRecords * SHT_EntrySize(sht_info));
+	if (sht_info->tagBytes > 0)
+		SHT_TAGS(blockData)[blockInfo->currentRecords] = tag;
+	blockInfo->currentRecords++;
+	return 0;
+}
+
+// Reads the i-th entry of the block, returns -1 if the slot is empty
+static int SHT_BlockEntry(SHT_info* sht_info, char* blockData, int i, secIndexEntry* entry) {
+	if (sht_info->format == SLOTTED_FORMAT) {
+		int length;
+		char* tuple = SP_Get(SHT_ENTRY_AREA(blockData), i, &length);
+		if (tuple == NULL) return -1;
+
+		SHT_UnpackEntry(sht_info, tuple, entry);
+		return 0;
+	}
+
+	SHT_UnpackEntry(sht_info, SHT_ENTRIES(sht_info, blockData) + i * SHT_EntrySize(sht_info), entry);
+	return 0;
+}
+
+static int SHT_BuildFromFile(char* sfileName, char* fileName);
+
+// The bucket of a name, with the hash function the index was created with
+static int SHT_Bucket(SHT_info* sht_info, char* name) {
+	unsigned int hash = HF_HashString(sht_info->hashFunction, name);
+	return HF_Reduce(sht_info->hashFunction, hash, sht_info->numBuckets);
+}
+
+
+// The entry of a value in the chain of its bucket, for indexes with posting lists
+typedef struct {
+  char value[20];
+  int postings;		// Newest block of the posting list
+  int count;		// Primary blocks in the posting list
+} SHT_keyEntry;
+
+#define SHT_KEYS(blockData) ((SHT_keyEntry*) SHT_ENTRY_AREA(blockData))
+#define SHT_POSTINGS(blockData) ((unsigned char*) (blockData) + sizeof(SHT_posting_info))
+#define SHT_POSTING_CAPACITY (BF_BLOCK_SIZE - (int) sizeof(SHT_posting_info))
+
+// Writes value as a zigzag varint, so that small differences of either sign take one byte. Returns its bytes
+static int SHT_PutVarint(unsigned char* out, int value) {
+	unsigned int zigzag = ((unsigned int) value << 1) ^ (unsigned int) (value >> 31);
+	int n = 0;
+	while (zigzag >= 0x80) {
+		out[n++] = (unsigned char) (zigzag | 0x80);
+		zigzag >>= 7;
+	}
+	out[n++] = (unsigned char) zigzag;
+	return n;
+}
+
+static int SHT_GetVarint(const unsigned char* in, int* value) {
+	unsigned int zigzag = 0;
+	int n = 0;
+	do {
+		zigzag |= (unsigned int) (in[n] & 0x7f) << (7 * n);
+	} while (in[n++] & 0x80);
+	*value = (int) (zigzag >> 1) ^ -(int) (zigzag & 1);
+	return n;
+}
+
+static void SHT_InitPostings(char* blockData, int nextBlock) {
+	SHT_posting_info* info = (SHT_posting_info*) blockData;
+	info->nextBlock = nextBlock;
+	info->bytes = 0;
+	info->last = 0;
+}
+
+// Appends blockId to the posting block, returns -1 if it does not fit
+static int SHT_AppendPosting(char* blockData, int blockId) {
+	SHT_posting_info* info = (SHT_posting_info*) blockData;
+	unsigned char encoded[5];
+	int n = SHT_PutVarint(encoded, blockId - info->last);
+	if (info->bytes + n > SHT_POSTING_CAPACITY) return -1;
+
+	memcpy(SHT_POSTINGS(blockData) + info->bytes, encoded, n);
+	info->bytes += n;
+	info->last = blockId;
+	return 0;
+}
+
+// Decodes the block numbers of the posting block into ids, which has room for SHT_POSTING_CAPACITY. Returns how many
+static int SHT_DecodePostings(char* blockData, int* ids) {
+	SHT_posting_info* info = (SHT_posting_info*) blockData;
+	int count = 0, previous = 0;
+	for (int i = 0; i < info->bytes; count++) {
+		int delta;
+		i += SHT_GetVarint(SHT_POSTINGS(blockData) + i, &delta);
+		previous += delta;
+		ids[count] = previous;
+	}
+	return count;
+}
+
+// Appends blockId to a growing array of block numbers
+static int SHT_PushBlock(int** blocks, int* count, int* capacity, int blockId) {
+	if (*count == *capacity) {
+		int* grown = realloc(*blocks, sizeof(int) * 2 * *capacity);
+		if (grown == NULL) return -1;
+		*blocks = grown;
+		*capacity *= 2;
+	}
+	(*blocks)[(*count)++] = blockId;
+	return 0;
+}
+
+// Appends every block number of the posting list that starts at first to blocks
+static int SHT_CollectPostings(SHT_info* sht_info, int first, int** blocks, int* count, int* capacity) {
+	int ids[SHT_POSTING_CAPACITY];
+	BF_Block* block;
+	BF_Block_Init(&block);
+
+	int error = 0;
+	while (first != -1 && error == 0) {
+		error = TC(LATCH_GetBlock(sht_info->fileDesc, first, block));
+		if (error != 0) break;
+		char* blockData = BF_Block_GetData(block);
+		int n = SHT_DecodePostings(blockData, ids);
+		first = ((SHT_posting_info*) blockData)->nextBlock;
+		error = TC(LATCH_UnpinBlock(block));
+
+		for (int i = 0; i < n && error == 0; i++)
+			error = SHT_PushBlock(blocks, count, capacity, ids[i]);
+	}
+
+	BF_Block_Destroy(&block);
+	return error;
+}
+
+// Finds the entry of name in the chain of bucket. If there is one, its block is left pinned in block
+// and its position in *keyBlock and *index, otherwise *index is -1 and nothing is pinned.
+static int SHT_FindKey(SHT_info* sht_info, int bucket, const char* name, BF_Block* block, int* keyBlock, int* index) {
+	int current = LATCH_LOAD(sht_info->hashTable[bucket]);
+	*index = -1;
+
+	while (current != -1) {
+		if (TC(LATCH_GetBlock(sht_info->fileDesc, current, block)) != 0) return -1;
+		char* blockData = BF_Block_GetData(block);
+		SHT_block_info* blockInfo = (SHT_block_info*) blockData;
+
+		for (int i = 0; i < blockInfo->currentRecords; i++) {
+			if (strcmp(SHT_KEYS(blockData)[i].value, name) != 0) continue;
+			*keyBlock = current;
+			*index = i;
+			return 0;
+		}
+
+		int next = blockInfo->nextBlock;
+		if (TC(LATCH_UnpinBlock(block)) != 0) return -1;
+		current = next;
+	}
+	return 0;
+}
+
+// Places the entry of a new name in the head block of bucket, or in a new head if it is full.
+// Call only with the bucket latch held.
+static int SHT_PlaceKey(SHT_info* sht_info, int bucket, SHT_keyEntry* key) {
+	BF_Block* block;
+	BF_Block_Init(&block);
+	int head = LATCH_LOAD(sht_info->hashTable[bucket]);
+	int newHead = -1;
+	int error = TC(LATCH_GetBlock(sht_info->fileDesc, head, block));
+	if (error != 0) goto cleanup;
+
+	char* blockData = BF_Block_GetData(block);
+	SHT_block_info* blockInfo = (SHT_block_info*) blockData;
+	if (blockInfo->currentRecords == blockInfo->recordsCount) {
+		error = TC(LATCH_UnpinBlock(block));
+		if (error != 0) goto cleanup;
+		error = TC(LATCH_AllocateBlock(sht_info->fileDesc, block, &newHead));
+		if (error != 0) goto cleanup;
+		blockData = BF_Block_GetData(block);
+		SHT_InitBlock(sht_info, blockData, head);	// Reverse chaining, as in the other layout
+		blockInfo = (SHT_block_info*) blockData;
+	}
+
+	SHT_KEYS(blockData)[blockInfo->currentRecords++] = *key;
+	LATCH_SetDirty(block);
+	error = TC(LATCH_UnpinBlock(block));
+	if (error == 0 && newHead != -1) LATCH_STORE(sht_info->hashTable[bucket], newHead);
+
+cleanup:
+	BF_Block_Destroy(&block);
+	return error;
+}
 
 int SHT_CreateSecondaryIndex(char *sfileName,  int buckets, char* fileName) {
+	SHT_options options = { 0 };
+	return SHT_CreateSecondaryIndexWithOptions(sfileName, buckets, fileName, options);
+}
+
+int SHT_CreateSecondaryIndexWithOptions(char *sfileName,  int buckets, char* fileName, SHT_options options) {
 	
 	int error;
+
+	// Index entries hold no dictionary-encodable record, only (name, blockId)
+	if (options.format == ENCODED_FORMAT) return -1;
+	if (options.filterBytes < 0 || options.filterBytes > BF_BLOCK_SIZE) return -1;
+	if (options.fingerprints && options.format == SLOTTED_FORMAT) return -1;
+	if (options.postings && (options.format != FIXED_FORMAT || options.fingerprints)) return -1;
+
+	// One string attribute is indexed, the name unless the options say otherwise
+	Record_Attribute attribute = NAME;
+	if (options.key == RECORD_KEY(SURNAME)) attribute = SURNAME;
+	else if (options.key == RECORD_KEY(CITY)) attribute = CITY;
+	else if (options.key != 0 && options.key != RECORD_KEY(NAME)) return -1;
+
+	// Included columns belong to one record, so every entry has to point to its own (rids)
+	Record_Key include = options.include & ~RECORD_KEY(attribute);
+	if ((include & ~SHT_INCLUDABLE) != 0) return -1;
+	if (include != 0 && (!options.rids || options.postings)) return -1;
+
 	int fileDescriptor;
 
 	error = TC(BF_CreateFile(sfileName));
@@ -44,18 +402,38 @@ int SHT_CreateSecondaryIndex(char *sfileName,  int buckets, char* fileName) {
   	info.numBuckets = buckets;
   	info.isHashFile = true;
 	info.isHeapFile = false;
+	info.format = options.format;
+	info.hashFunction = options.hash;
+	info.filterBytes = options.filterBytes;
+	info.filterBlock = -1;
+	info.postings = options.postings;
+	info.rids = options.rids;
+	info.attribute = attribute;
+	info.include = include;
+	info.latches = NULL;
+	info.entrySets = NULL;
 
   	// Although named "records", we hold a much smaller entity, a secIndexEntry struct, with only (name,blockId)
-  	info.recordsPerBlock = (sizeof(char) * BF_BLOCK_SIZE - sizeof(SHT_block_info)) / sizeof(secIndexEntry);
+	if (info.postings)
+		info.recordsPerBlock = SHT_ENTRY_AREA_SIZE / sizeof(SHT_keyEntry);
+	else if (info.format == SLOTTED_FORMAT)	// At least this many, shorter names fit more
+		info.recordsPerBlock = (SHT_ENTRY_AREA_SIZE - sizeof(SP_header)) / (SHT_EntrySize(&info) + sizeof(SP_slot));
+	else
+  		info.recordsPerBlock = SHT_ENTRY_AREA_SIZE / SHT_EntrySize(&info);
+
+	// One tag byte per entry, the tags are padded to whole groups of 16 compared at once
+	info.tagBytes = 0;
+	if (options.fingerprints) {
+		while (HF_TAG_BYTES(info.recordsPerBlock) + info.recordsPerBlock * SHT_EntrySize(&info) > SHT_ENTRY_AREA_SIZE)
+			info.recordsPerBlock--;
+		info.tagBytes = HF_TAG_BYTES(info.recordsPerBlock);
+	}
 	
-  	// totalSizeOfBuckets => How big the hashTable has to be
-  	int totalSizeOfBuckets = buckets * sizeof(int);
-  	// How much space is available in total for the hashTable
-  	int hashTableSize = (sizeof(char) * BF_BLOCK_SIZE - sizeof(SHT_info));
-
-	assert(totalSizeOfBuckets <= hashTableSize);
+	// The directory does not fit in block 0 for many buckets, it is kept in its own chain
+	info.directoryBlock = -1;
+	info.hashTable = malloc(sizeof(int) * buckets);
+	if (info.hashTable == NULL) return -1;
 
-  	// info.hashTable = malloc(sizeof(int) * buckets);
 	char* data = BF_Block_GetData(block);
 
   	// Allocate momory for the buckets
@@ -68,23 +446,19 @@ int SHT_CreateSecondaryIndex(char *sfileName,  int buckets, char* fileName) {
 		if (error != 0) return -1;
 
 
-		SHT_block_info blockInfo; // Create a SHT_block_info struct to write to the bucket
-		blockInfo.recordsCount = (sizeof(char) * BF_BLOCK_SIZE - sizeof(SHT_block_info)) / (sizeof(secIndexEntry)); // And can fit this many records inside
-		blockInfo.currentRecords = 0; // Has no records inside
-		blockInfo.nextBlock = -1; 	// Has no next block
-		
 		char* bucketData = BF_Block_GetData(bucket);  	        // Get the data of the bucket
-		memcpy(bucketData, &blockInfo, sizeof(SHT_block_info)); // Write the SHT_block_info struct to the bucket
+		SHT_InitBlock(&info, bucketData, -1);					// No records inside, and no next block
+		SHT_block_info* blockInfo = (SHT_block_info*) bucketData;
 
-		printf("Can hold: %d, holds: %d\n", blockInfo.recordsCount, blockInfo.currentRecords);
-		assert(blockInfo.currentRecords == 0);
+		// printf("Can hold: %d, holds: %d\n", blockInfo->recordsCount, blockInfo->currentRecords);
+		assert(blockInfo->currentRecords == 0);
 		
 		// last bucket is in position counter-1. so hashTable[i] = counter-1
 		int newBucketIn; BF_GetBlockCounter(fileDescriptor, &newBucketIn); // Get the position of the bucket
 		newBucketIn--; // Decrease it by one
 		
 		info.hashTable[i] = newBucketIn;
-		printf("Created bucket for [%d], saved in block: %d\n", i, info.hashTable[i]);
+		// printf("Created bucket for [%d], saved in block: %d\n", i, info.hashTable[i]);
 
 		BF_Block_SetDirty(bucket); 	 // Mark the block as dirty
 
@@ -95,6 +469,18 @@ int SHT_CreateSecondaryIndex(char *sfileName,  int buckets, char* fileName) {
 
 	}
 
+	// Empty Bloom filters for every bucket
+	if (info.filterBytes > 0) {
+		error = BLOOM_CreateFilters(fileDescriptor, buckets, info.filterBytes, &info.filterBlock);
+		if (error != 0) return -1;
+	}
+
+	// Write the directory, the header records where its chain starts
+	error = BC_Write(fileDescriptor, &info.directoryBlock, (char*) info.hashTable, sizeof(int) * buckets);
+	free(info.hashTable);
+	info.hashTable = NULL;
+	if (error != 0) return -1;
+
 	// Now copy in the first block the SHT_info
   	memcpy(data, &info, sizeof(SHT_info));
 
@@ -109,6 +495,11 @@ int SHT_CreateSecondaryIndex(char *sfileName,  int buckets, char* fileName) {
 
 	BF_Block_Destroy(&block);
 
+	// The index of an existing primary file starts out with all of its entries
+	if (fileName != NULL && SHT_BuildFromFile(sfileName, fileName) != 0) {
+		remove(sfileName);
+		return -1;
+	}
 	return 0;
 }
 
@@ -147,6 +538,19 @@ SHT_info* SHT_OpenSecondaryIndex(char *indexName){
 
 	BF_Block_Destroy(&block); // Destroy the block
 
+	// Cache the directory, so that finding a bucket costs no block reads
+	toReturn->hashTable = NULL;
+	int size;
+	error = BC_Read(fileDescriptor, toReturn->directoryBlock, (char**) &toReturn->hashTable, &size);
+	if (error != 0 || size != (int) sizeof(int) * toReturn->numBuckets) return NULL;
+
+	toReturn->latches = LATCH_Create();
+	if (toReturn->latches == NULL) return NULL;
+
+	// The sets of the stripes are loaded by the inserts that need them
+	toReturn->entrySets = calloc(LATCH_STRIPES, sizeof(Entry_Set*));
+	if (toReturn->entrySets == NULL) return NULL;
+
   	return toReturn;
 }
 
@@ -155,6 +559,10 @@ int SHT_CloseSecondaryIndex( SHT_info* SHT_inf ){
 	int error;
 	int fileDescriptor = SHT_inf->fileDesc; // Get the file descriptor
 	BF_Block* block;	BF_Block_Init(&block);
+
+	// Write back the directory before the header, which records where it starts
+	error = BC_Write(fileDescriptor, &SHT_inf->directoryBlock, (char*) SHT_inf->hashTable, sizeof(int) * SHT_inf->numBuckets);
+	if (error != 0) return -1;
 	
 	error = TC(BF_GetBlock(fileDescriptor, 0 , block)); // Get the first block
 	if (error != 0) return -1;
@@ -164,18 +572,7 @@ int SHT_CloseSecondaryIndex( SHT_info* SHT_inf ){
 	assert(SHT_inf != NULL);
 	assert(data != NULL);
 
-	memcpy(data, SHT_inf, sizeof(SHT_inf)); // Copy the data from the SHT_info struct to the first block
-	
-	// Below we assure that a deep copy is done
-	SHT_info* other_info = (SHT_info*) data;
-	
-	for(int i = 0; i < SHT_inf->numBuckets; i++) {
-		other_info->hashTable[i] = SHT_inf->hashTable[i];
-	}
-
-	SHT_info* info = (SHT_info*) data;
-	for(int i = 0; i < info->numBuckets; i++)
-		assert(info->hashTable[i] == other_info->hashTable[i]);
+	memcpy(data, SHT_inf, sizeof(SHT_info)); // Copy the data from the SHT_info struct to the first block
 
 	BF_Block_SetDirty(block);
 	error = TC(BF_UnpinBlock(block));
@@ -183,6 +580,11 @@ int SHT_CloseSecondaryIndex( SHT_info* SHT_inf ){
 	
 	BF_Block_Destroy(&block);
 
+	free(SHT_inf->hashTable);
+	LATCH_Destroy(SHT_inf->latches);
+	for (int i = 0; i < LATCH_STRIPES; i++)
+		ES_Destroy(SHT_inf->entrySets[i]);
+	free(SHT_inf->entrySets);
 	free(SHT_inf); // Free the memory of the SHT_info struct
 	error = TC(BF_CloseFile(fileDescriptor)); // Close the file
 	if (error != 0) return -1;
@@ -190,201 +592,591 @@ int SHT_CloseSecondaryIndex( SHT_info* SHT_inf ){
   	return 0;
 }
 
-int SHT_SecondaryInsertEntry(SHT_info* sht_info, Record record, int block_id){
-	int error;
+// Two independent 32-bit hashes of the name, two names that differ share both with probability 2^-64
+static unsigned long long SHT_NameKey(const char* name) {
+	return (unsigned long long) HF_HashString(XXHASH, name) << 32 | HF_HashString(CRC32C_HASH, name);
+}
+
+// Reads every <name, blockId> pair of the buckets of stripe into its set, with the stripe latch held
+static Entry_Set* SHT_LoadStripe(SHT_info* sht_info, int stripe) {
+	int error = 0;
+	BF_Block* block;
+	BF_Block_Init(&block);
+	bool pinned = false;
+	int capacity = 64;
+	int* postings = malloc(sizeof(int) * capacity);
+	Entry_Set* set = ES_Create();
+	if (set == NULL || postings == NULL) {
+		error = -1;
+		goto cleanup;
+	}
+
+	for (int b = stripe; b < sht_info->numBuckets; b += LATCH_STRIPES) {
+		int current = LATCH_LOAD(sht_info->hashTable[b]);
+		while (current != -1) {
+			error = TC(LATCH_GetBlock(sht_info->fileDesc, current, block));
+			if (error != 0) goto cleanup;
+			pinned = true;
+
+			char* blockData = BF_Block_GetData(block);
+			SHT_block_info* blockInfo = (SHT_block_info*) blockData;
+			for (int i = 0; i < blockInfo->currentRecords && sht_info->postings; i++) {
+				SHT_keyEntry* key = &SHT_KEYS(blockData)[i];
+				int count = 0;
+				error = SHT_CollectPostings(sht_info, key->postings, &postings, &count, &capacity);
+				if (error != 0) goto cleanup;
+				for (int p = 0; p < count; p++) {
+					if (ES_Insert(set, SHT_NameKey(key->value), postings[p]) == -1) {
+						error = -1;
+						goto cleanup;
+					}
+				}
+			}
+			for (int i = 0; i < blockInfo->currentRecords && !sht_info->postings; i++) {
+				secIndexEntry entry;
+				if (SHT_BlockEntry(sht_info, blockData, i, &entry) != 0) continue;
+				if (ES_Insert(set, SHT_NameKey(entry.value), entry.blockId) == -1) {
+					error = -1;
+					goto cleanup;
+				}
+			}
+
+			current = blockInfo->nextBlock;	// Read before the unpin, the frame may be reused right after it
+			pinned = false;
+			error = TC(LATCH_UnpinBlock(block));
+			if (error != 0) goto cleanup;
+		}
+	}
+
+cleanup:
+	if (pinned) LATCH_UnpinBlock(block);
+	BF_Block_Destroy(&block);
+	free(postings);
+	if (error != 0) {
+		ES_Destroy(set);
+		return NULL;
+	}
+	return set;
+}
+
+// Appends block_id to the posting list of the name of record, which the entry of the name may not have yet.
+// Call only with the latch of bucket hash held.
+static int SHT_InsertPosting(SHT_info* sht_info, Record record, int block_id, int hash, unsigned int valueHash) {
 	int fileDescriptor = sht_info->fileDesc;
-  	int buckets = sht_info->numBuckets;
-  	int recordsPerBlock = sht_info->recordsPerBlock;
-  	int* hashTable = sht_info->hashTable;
+	BF_Block* keys;
+	BF_Block* block;
+	BF_Block_Init(&keys);
+	BF_Block_Init(&block);
 
-  	int hash = hash_string(record.name) % buckets;
-  	int bucket = hashTable[hash];
+	int keyBlock, index;
+	bool keyPinned = false;	// The block with the entry of the name, left pinned by SHT_FindKey
+	char* value = SHT_Value(sht_info, &record);
+	int error = SHT_FindKey(sht_info, hash, value, keys, &keyBlock, &index);
+	if (error != 0) goto cleanup;
+	keyPinned = index != -1;
+
+	SHT_keyEntry newKey = { { 0 }, -1, 0 };
+	SHT_keyEntry* key = &newKey;
+	if (index != -1) {
+		key = &SHT_KEYS(BF_Block_GetData(keys))[index];
+	} else {
+		strcpy(newKey.value, value);
+	}
 
-  	secIndexEntry toInsert;
-  	toInsert.blockId = block_id;
-  	strcpy(toInsert.name, record.name);
+	// The newest block of the list takes the block number, or a new one goes in front of it
+	bool appended = false;
+	if (key->postings != -1) {
+		error = TC(LATCH_GetBlock(fileDescriptor, key->postings, block));
+		if (error != 0) goto cleanup;
+		appended = SHT_AppendPosting(BF_Block_GetData(block), block_id) == 0;
+		if (appended) LATCH_SetDirty(block);
+		error = TC(LATCH_UnpinBlock(block));
+		if (error != 0) goto cleanup;
+	}
+	if (!appended) {
+		int newBlock;
+		error = TC(LATCH_AllocateBlock(fileDescriptor, block, &newBlock));
+		if (error != 0) goto cleanup;
+		SHT_InitPostings(BF_Block_GetData(block), key->postings);
+		SHT_AppendPosting(BF_Block_GetData(block), block_id);
+		LATCH_SetDirty(block);
+		error = TC(LATCH_UnpinBlock(block));
+		if (error != 0) goto cleanup;
+		key->postings = newBlock;
+	}
+	key->count++;
 
+	if (index != -1) {
+		LATCH_SetDirty(keys);
+		keyPinned = false;
+		error = TC(LATCH_UnpinBlock(keys));
+		if (error != 0) goto cleanup;
+	} else {
+		error = SHT_PlaceKey(sht_info, hash, &newKey);
+		if (error != 0) goto cleanup;
+	}
 
-  	BF_Block* block; 		// Create a block
-	BF_Block* iterativeBlock;
-	BF_Block_Init(&block); // Initialize the block
-	BF_Block_Init(&iterativeBlock);
+	// Record the name in the filter of the bucket, so that lookups of other names can skip the chain
+	if (sht_info->filterBytes > 0)
+		error = BLOOM_Add(fileDescriptor, sht_info->filterBlock, sht_info->filterBytes, hash, valueHash);
 
-	error = TC(BF_GetBlock(fileDescriptor, bucket, block));
-	if (error != 0) return -1;
+cleanup:
+	if (keyPinned) LATCH_UnpinBlock(keys);
+	BF_Block_Destroy(&keys);
+	BF_Block_Destroy(&block);
+	return error;
+}
 
-	error = TC(BF_GetBlock(fileDescriptor, bucket, iterativeBlock));
-	if (error != 0) return -1;
+// An entry on its way into the index, with the hash of its value computed once for the bucket,
+// the fingerprint and the filter
+typedef struct {
+	Record* record;
+	int blockId;
+	unsigned int hash;
+} SHT_pending;
+
+static SHT_pending SHT_Pending(SHT_info* sht_info, Record* record, int blockId) {
+	SHT_pending pending = { record, blockId, HF_HashString(sht_info->hashFunction, SHT_Value(sht_info, record)) };
+	return pending;
+}
 
-	char* blockData = BF_Block_GetData(iterativeBlock);
+// Inserts the n entries of bucket hash, with its bucket latch held. The head of the chain stays pinned
+// from one entry to the next, so a batch reads and writes every block it fills once.
+static int SHT_InsertLatched(SHT_info* sht_info, int hash, SHT_pending* pending, int n) {
+	int error = 0;
+	int fileDescriptor = sht_info->fileDesc;
 
-  	SHT_block_info* blockInfoRead = (SHT_block_info *) blockData;
-  	SHT_block_info* first = blockInfoRead;
+	// A <value, blockId> pair is stored once, or GetAllEntries would visit the block more than once.
+	// The set of the stripe answers without walking the chain of the bucket.
+	Entry_Set** set = &sht_info->entrySets[hash & (LATCH_STRIPES - 1)];
+	if (*set == NULL && (*set = SHT_LoadStripe(sht_info, hash & (LATCH_STRIPES - 1))) == NULL) return -1;
+
+	BF_Block* block;
+	BF_Block_Init(&block);
+	int bucket = -1;	// The pinned head of the chain, once an entry needs it
 
-  	bool insertEntryInIndex = true;
-	bool iterated = false;
+	for (int p = 0; p < n; p++) {
+		int added = ES_Insert(*set, SHT_NameKey(SHT_Value(sht_info, pending[p].record)), pending[p].blockId);
+		if (added == -1) {
+			error = -1;
+			goto cleanup;
+		}
+		if (added == 0) continue;
+		if (sht_info->postings) {
+			error = SHT_InsertPosting(sht_info, *pending[p].record, pending[p].blockId, hash, pending[p].hash);
+			if (error != 0) goto cleanup;
+			continue;
+		}
 
-	// Before inserting, assert that the whole bucket chain does not already contain
-	// a entry of <name,bucketID>, which would create a problem in GetAllEntries
-	// as a block could be visited more than once
+		secIndexEntry toInsert;
+		SHT_MakeEntry(sht_info, &toInsert, pending[p].record, pending[p].blockId);
+		unsigned char tag = HF_Fingerprint(pending[p].hash);
 
-  	while ( true ) {
-		
-		// Iterate through all entries of the bucket
-		for(int i = 0; i < first->currentRecords; i++) {
-
-			// Check every entry in block
-			char* data = blockData +  sizeof(SHT_block_info) + i * (sizeof(secIndexEntry));
-			secIndexEntry entry = (secIndexEntry) *( (secIndexEntry*) data); // Cast the data to Record
-			
-			// Check if tuple <name, block_id> exists 
-      		if (entry.blockId == block_id && strcmp(entry.name, record.name) == 0) {
-        		insertEntryInIndex = false;
-        		// printf("\n\n\nThere already exists an entry: <%s,%d> in the index\n\n\n", record.name, block_id);
-        		break;
-      		}
+		if (bucket == -1) {
+			int head = LATCH_LOAD(sht_info->hashTable[hash]);
+			error = TC(LATCH_GetBlock(fileDescriptor, head, block));
+			if (error != 0) goto cleanup;
+			bucket = head;
 		}
 
-		// If we found an entry, break out of the while loop, stop searching more
-    	if (insertEntryInIndex == false) break;
+		// If the entry doesn't fit, a new block goes in front of the chain and becomes its head (reverse chaining)
+		if (SHT_PlaceEntry(sht_info, BF_Block_GetData(block), &toInsert, tag) != 0) {
+			LATCH_SetDirty(block);
+			int oldHead = bucket;
+			bucket = -1;
+			error = TC(LATCH_UnpinBlock(block));
+			if (error != 0) goto cleanup;
+
+			int newBlock;
+			error = TC(LATCH_AllocateBlock(fileDescriptor, block, &newBlock));
+			if (error != 0) goto cleanup;
+			SHT_InitBlock(sht_info, BF_Block_GetData(block), oldHead);
+			SHT_PlaceEntry(sht_info, BF_Block_GetData(block), &toInsert, tag);
+
+			bucket = newBlock;
+			LATCH_STORE(sht_info->hashTable[hash], bucket); // Set the bucket to the new block, once it is complete
+		}
 
-		// Check if there is a next block (overflow)
-		if ( first->nextBlock == -1) 
-			break;
-		else {
-      		// Before I get the next block in the chain, unpin the current one
-			if (iterated) {
-				error = TC(BF_UnpinBlock(iterativeBlock));
-				if (error != 0) return -1;
-			}
-			iterated = true;
-      		
-      		// Now get the next block
-			error = TC(BF_GetBlock(fileDescriptor, first->nextBlock, iterativeBlock));
-			if (error != 0) return -1;
+		// Record the value in the filter of the bucket, so that lookups of other values can skip the chain
+		if (sht_info->filterBytes > 0) {
+			error = BLOOM_Add(fileDescriptor, sht_info->filterBlock, sht_info->filterBytes, hash, pending[p].hash);
+			if (error != 0) goto cleanup;
+		}
+	}
+
+cleanup:
+	if (bucket != -1) {
+		LATCH_SetDirty(block);
+		if (TC(LATCH_UnpinBlock(block)) != 0) error = -1;
+	}
+	BF_Block_Destroy(&block);
+	return error;
+}
+
+int SHT_SecondaryInsertEntry(SHT_info* sht_info, Record record, int block_id){
+	SHT_pending pending = SHT_Pending(sht_info, &record, block_id);
+	int hash = HF_Reduce(sht_info->hashFunction, pending.hash, sht_info->numBuckets);
+
+	// Only the bucket of the value is latched, inserts into other buckets go on in parallel
+	LATCH_LockBucket(sht_info->latches, hash);
+	int error = SHT_InsertLatched(sht_info, hash, &pending, 1);
+	LATCH_UnlockBucket(sht_info->latches, hash);
+	return error;
+}
 
-			blockData = BF_Block_GetData(iterativeBlock);
-			first = (SHT_block_info*) blockData;
+int SHT_SecondaryInsertEntries(SHT_info* sht_info, Record* records, const int* block_ids, size_t n) {
+	SHT_pending* pending = malloc((n > 0 ? n : 1) * sizeof(SHT_pending));
+	int* buckets = malloc((n > 0 ? n : 1) * sizeof(int));
+	size_t* starts = calloc(sht_info->numBuckets + 1, sizeof(size_t));
+	SHT_pending* sorted = malloc((n > 0 ? n : 1) * sizeof(SHT_pending));
+	int error = pending == NULL || buckets == NULL || starts == NULL || sorted == NULL ? -1 : 0;
+
+	// Every value is hashed once, and the entries are grouped by bucket in their order (counting sort)
+	for (size_t i = 0; error == 0 && i < n; i++) {
+		pending[i] = SHT_Pending(sht_info, &records[i], block_ids[i]);
+		buckets[i] = HF_Reduce(sht_info->hashFunction, pending[i].hash, sht_info->numBuckets);
+		starts[buckets[i] + 1]++;
+	}
+	for (long b = 0; error == 0 && b < sht_info->numBuckets; b++)
+		starts[b + 1] += starts[b];
+	for (size_t i = 0; error == 0 && i < n; i++)
+		sorted[starts[buckets[i]]++] = pending[i];
+
+	// starts[b] now ends bucket b, and every bucket takes its latch once for all of its entries
+	size_t first = 0;
+	for (long b = 0; error == 0 && b < sht_info->numBuckets; first = starts[b++]) {
+		if (starts[b] == first) continue;
+		LATCH_LockBucket(sht_info->latches, b);
+		error = SHT_InsertLatched(sht_info, b, sorted + first, starts[b] - first);
+		LATCH_UnlockBucket(sht_info->latches, b);
+	}
+
+	free(pending);
+	free(buckets);
+	free(starts);
+	free(sorted);
+	return error;
+}
+
+// Removes the i-th entry of the block. In the fixed layout the last entry takes its place
+static void SHT_RemoveEntry(SHT_info* sht_info, char* blockData, int i) {
+	SHT_block_info* blockInfo = (SHT_block_info*) blockData;
+
+	if (sht_info->format == SLOTTED_FORMAT) {
+		char* page = SHT_ENTRY_AREA(blockData);
+		SP_Delete(page, i);
+		blockInfo->currentRecords = SP_Slots(page);
+		return;
+	}
+
+	int last = blockInfo->currentRecords - 1;
+	int size = SHT_EntrySize(sht_info);
+	if (i != last) {
+		memcpy(SHT_ENTRIES(sht_info, blockData) + i * size, SHT_ENTRIES(sht_info, blockData) + last * size, size);
+		if (sht_info->tagBytes > 0)
+			SHT_TAGS(blockData)[i] = SHT_TAGS(blockData)[last];
+	}
+	blockInfo->currentRecords--;
+}
+
+// Takes block_id out of the posting list of name, the posting block out of the list if it is left empty,
+// and the entry of the name out of its bucket once the list is empty.
+// Returns 1 if the block was in the list, 0 if not, -1 on error.
+static int SHT_DeletePosting(SHT_info* sht_info, char* name, int block_id, int hash) {
+	int ids[SHT_POSTING_CAPACITY];
+	BF_Block* keys;
+	BF_Block* block;
+	BF_Block_Init(&keys);
+	BF_Block_Init(&block);
+
+	int keyBlock, index;
+	bool keyPinned = false;	// The block with the entry of the name, left pinned by SHT_FindKey
+	bool removed = false;
+	int error = SHT_FindKey(sht_info, hash, name, keys, &keyBlock, &index);
+	if (error != 0 || index == -1) goto cleanup;
+	keyPinned = true;
+
+	char* keyData = BF_Block_GetData(keys);
+	SHT_keyEntry* key = &SHT_KEYS(keyData)[index];
+	int current = key->postings;
+	int previous = -1;	// The newer neighbour of current, -1 while current is the head of the list
+	while (current != -1 && !removed) {
+		error = TC(BF_GetBlock(sht_info->fileDesc, current, block));
+		if (error != 0) goto cleanup;
+		char* blockData = BF_Block_GetData(block);
+		int n = SHT_DecodePostings(blockData, ids);
+
+		// The block is encoded again without it, a difference never takes more bytes than the two it replaces
+		for (int i = 0; i < n && !removed; i++) {
+			if (ids[i] != block_id) continue;
+			SHT_InitPostings(blockData, ((SHT_posting_info*) blockData)->nextBlock);
+			for (int j = 0; j < n; j++)
+				if (j != i) SHT_AppendPosting(blockData, ids[j]);
+			BF_Block_SetDirty(block);
+			removed = true;
+		}
+
+		int next = ((SHT_posting_info*) blockData)->nextBlock;
+		bool emptied = removed && ((SHT_posting_info*) blockData)->bytes == 0;
+		error = TC(BF_UnpinBlock(block));
+		if (error != 0) goto cleanup;
+
+		// A block left without ids leaves the list, through the entry of the name if it was the head
+		if (emptied && previous == -1) {
+			key->postings = next;
+		} else if (emptied) {
+			error = TC(BF_GetBlock(sht_info->fileDesc, previous, block));
+			if (error != 0) goto cleanup;
+			((SHT_posting_info*) BF_Block_GetData(block))->nextBlock = next;
+			BF_Block_SetDirty(block);
+			error = TC(BF_UnpinBlock(block));
+			if (error != 0) goto cleanup;
 		}
+		previous = current;
+		current = next;
 	}
 
-	// Unpin the last one in the chain which was not unpinned
-	if (iterated) {
-		// printf("The iterative block has changed\n");
-		error = TC(BF_UnpinBlock(iterativeBlock));
-		if (error != 0) return -1;
-	} else {
-		// printf("Iterative block same as first\n");
+	// A name without blocks leaves the bucket, the last entry of the block takes its place
+	if (removed && --key->count == 0) {
+		SHT_block_info* blockInfo = (SHT_block_info*) keyData;
+		*key = SHT_KEYS(keyData)[--blockInfo->currentRecords];
 	}
 
-	// We have now asserted uniqueness inside the chain of blocks (whole "bucket")
-  	// So an entry like the one we want does not already exist inside
-	// and proceed with the insertion
+cleanup:
+	if (keyPinned) {
+		if (removed) BF_Block_SetDirty(keys);
+		if (TC(BF_UnpinBlock(keys)) != 0) error = -1;
+	}
+	BF_Block_Destroy(&keys);
+	BF_Block_Destroy(&block);
+	return error != 0 ? -1 : removed;
+}
 
-	if (insertEntryInIndex) {
+int SHT_SecondaryDeleteEntry(HT_info* ht_info, SHT_info* sht_info, Record record, int block_id) {
+	int error;
+	BF_Block* block;
+	BF_Block_Init(&block);
+	char* blockData;
 
-		int recordsInBlock = blockInfoRead->currentRecords;
-		
-    	// If records fits in block, just place it inside
-		if (recordsInBlock < blockInfoRead->recordsCount) {
-	  		// printf("No overflow in bucket: %d saved in block: %d\n", hash, bucket );
-	  		char* data = blockData +  sizeof(SHT_block_info) + recordsInBlock * (sizeof(secIndexEntry));
-	  		memcpy(data, &toInsert, sizeof(secIndexEntry));
-	  		blockInfoRead->currentRecords++;
-	  		BF_Block_SetDirty(block); // Mark the block as dirty
-	  	} else {
-
-	  		// If records doesn't fit in block, create a new block and place it there
-	  		BF_Block* newBlock; 		// Create a block
-	  		BF_Block_Init(&newBlock); // Initialize the block
-
-			error = TC(BF_AllocateBlock(fileDescriptor, newBlock)); // Allocate a block for the new record
-			if (error != 0) return -1;
+	// The entry stays while another record of the primary block has the same name. A rid is one record's alone
+	if (!sht_info->rids) {
+		error = TC(BF_GetBlock(ht_info->fileDesc, block_id, block));
+		if (error != 0) return -1;
 
-     		// Get block number of last allocated block ( = blockCounter - 1)
-	  		int blockCounter; BF_GetBlockCounter(fileDescriptor,&blockCounter ); // Get the number of the last allocated block
-	  		blockCounter--; // Get the number of the last allocated block
+		blockData = BF_Block_GetData(block);
+		bool shared = false;
+		for (int i = 0; i < ((HT_block_info*) blockData)->currentRecords && !shared; i++) {
+			Record other;
+			if (HT_BlockRecord(ht_info, blockData, i, &other) != 0) continue;
+			shared = strcmp(SHT_Value(sht_info, &other), SHT_Value(sht_info, &record)) == 0;
+		}
 
-	  		char* newBlockData = BF_Block_GetData(newBlock); // Get the data of the new block
-	  		SHT_block_info* newBlockInfo = (SHT_block_info *) newBlockData; // Cast the data to HT_block_info
-	  		
-			newBlockInfo->currentRecords = 1; // Set the current records to 1
+		error = TC(BF_UnpinBlock(block));
+		if (error != 0) return -1;
+		if (shared) {
+			BF_Block_Destroy(&block);
+			return 0;
+		}
+	}
 
-	  		// Connect newly allocated block with the previous block in place
-	  		newBlockInfo->nextBlock = bucket; // Set the next block to previous bucket (reverse chaining)		
-			newBlockInfo->recordsCount = (sizeof(char) * BF_BLOCK_SIZE  - sizeof(SHT_block_info) )/ sizeof(secIndexEntry); // Set the records count to the maximum number of records that can fit in a block
+	char* value = SHT_Value(sht_info, &record);
+	unsigned int valueHash = HF_HashString(sht_info->hashFunction, value);
+	int hash = HF_Reduce(sht_info->hashFunction, valueHash, sht_info->numBuckets);
+	if (sht_info->postings) {
+		int removed = SHT_DeletePosting(sht_info, value, block_id, hash);
+		Entry_Set* set = sht_info->entrySets[hash & (LATCH_STRIPES - 1)];
+		if (removed == 1 && set != NULL) ES_Remove(set, SHT_NameKey(value), block_id);
+		BF_Block_Destroy(&block);
+		return removed == -1 ? -1 : 0;
+	}
 
-	  		
-			char* data = newBlockData +  sizeof(SHT_block_info); // Get the data of the new block
-	  		memcpy(data, &toInsert, sizeof(secIndexEntry)); // Copy the data from the record to the new block
+	// Every <name, blockId> pair is stored once, the walk stops at it
+	unsigned char tag = HF_Fingerprint(valueHash);
+	int current = sht_info->hashTable[hash];
+	bool removed = false;
+	while (current != -1 && !removed) {
+		error = TC(BF_GetBlock(sht_info->fileDesc, current, block));
+		if (error != 0) return -1;
 
-			BF_Block_SetDirty(newBlock); // Mark the new block as dirty
+		blockData = BF_Block_GetData(block);
+		SHT_block_info* blockInfo = (SHT_block_info*) blockData;
+		for (int i = 0; i < blockInfo->currentRecords && !removed; i++) {
+			if (sht_info->tagBytes > 0 && SHT_TAGS(blockData)[i] != tag) continue;
 
-			error = TC(BF_UnpinBlock(newBlock)); // Unpin the new block because we don't need it anymore
-			if (error != 0) return -1;
+			secIndexEntry entry;
+			if (SHT_BlockEntry(sht_info, blockData, i, &entry) != 0) continue;
+			if (entry.blockId == block_id && strcmp(entry.value, value) == 0) {
+				SHT_RemoveEntry(sht_info, blockData, i);
+				BF_Block_SetDirty(block);
+				removed = true;
 
-			BF_Block_Destroy(&newBlock); // Destroy the new block
-	
-	  		sht_info->hashTable[hash] = blockCounter; // Set the bucket to the new block
-	  	}
-  	
+				Entry_Set* set = sht_info->entrySets[hash & (LATCH_STRIPES - 1)];
+				if (set != NULL) ES_Remove(set, SHT_NameKey(value), block_id);
+			}
+		}
+
+		current = blockInfo->nextBlock;
+		error = TC(BF_UnpinBlock(block));
+		if (error != 0) return -1;
 	}
-	BF_UnpinBlock(block); // Unpin the block because we don't need it anymore
-	BF_Block_Destroy(&block); // Destroy the block
-	BF_Block_Destroy(&iterativeBlock);
+
+	BF_Block_Destroy(&block);
 	return 0;
 }
 
+static int compareBlockIds(const void* a, const void* b) {
+	int x = *(const int*) a, y = *(const int*) b;
+	return (x > y) - (x < y);
+}
+
+// Prints the records named name of the primary blocks, each block read once and in ascending order,
+// so that the many blocks of a common name are read close to sequentially. Consumes blocks.
+static int SHT_FetchPrimary(HT_info* ht_info, SHT_info* sht_info, int* blocks, int count, char* name) {
+	qsort(blocks, count, sizeof(int), compareBlockIds);
+
+	BF_Block* block;
+	BF_Block_Init(&block);
+	int blocksRead = 0;
+
+	for (int b = 0; b < count; b++) {
+		if (b > 0 && blocks[b] == blocks[b - 1]) continue;
+
+		int error = TC(BF_GetBlock(ht_info->fileDesc, blocks[b], block));
+		if (error != 0) return -1;
+		blocksRead++;
+
+		// Iterate through all records of the block of the PRIMARY INDEX
+		// To find if there is a record inside, with the same name
+		HT_block_info* HT_header = (HT_block_info*) BF_Block_GetData(block);
+		for (int i = 0; i < HT_header->currentRecords; i++) {
+			Record record;
+			if (HT_BlockRecord(ht_info, (char*) HT_header, i, &record) != 0) continue; // Decode the data to Record
+			if (strcmp(name, SHT_Value(sht_info, &record)) == 0)
+				printf("%d \t\t %s \t %s \t %s \n", record.id, record.name, record.surname, record.city);
+		}
+
+		error = TC(BF_UnpinBlock(block));
+		if (error != 0) return -1;
+	}
+
+	BF_Block_Destroy(&block);
+	return blocksRead;
+}
+
+// SHT_FetchPrimary for an index of rids: every rid is its record's slot, no other record of the block is
+// decoded. The name is still compared, against a slot that a lost update of the index left stale.
+static int SHT_FetchRids(HT_info* ht_info, SHT_info* sht_info, int* rids, int count, char* name) {
+	qsort(rids, count, sizeof(int), compareBlockIds);
+
+	BF_Block* block;
+	BF_Block_Init(&block);
+	int blocksRead = 0, pinned = -1;
+
+	for (int r = 0; r < count; r++) {
+		if (r > 0 && rids[r] == rids[r - 1]) continue;
+
+		// Sorted rids keep the slots of a block together, so it is pinned once for all of them
+		int blockId = HT_RID_BLOCK(rids[r]);
+		if (blockId != pinned) {
+			if (pinned != -1 && TC(BF_UnpinBlock(block)) != 0) return -1;
+			if (TC(BF_GetBlock(ht_info->fileDesc, blockId, block)) != 0) return -1;
+			pinned = blockId;
+			blocksRead++;
+		}
+
+		char* blockData = BF_Block_GetData(block);
+		Record record;
+		if (HT_RID_SLOT(rids[r]) >= ((HT_block_info*) blockData)->currentRecords) continue;
+		if (HT_BlockRecord(ht_info, blockData, HT_RID_SLOT(rids[r]), &record) != 0) continue;
+		if (strcmp(name, SHT_Value(sht_info, &record)) == 0)
+			printf("%d \t\t %s \t %s \t %s \n", record.id, record.name, record.surname, record.city);
+	}
+
+	if (pinned != -1 && TC(BF_UnpinBlock(block)) != 0) return -1;
+	BF_Block_Destroy(&block);
+	return blocksRead;
+}
+
+// SHT_SecondaryGetAllEntries for an index with posting lists, whose filter has not ruled the name out
+static int SHT_GetPostings(HT_info* ht_info, SHT_info* sht_info, char* name, int hash) {
+	BF_Block* keys;
+	BF_Block_Init(&keys);
+
+	int keyBlock, index;
+	if (SHT_FindKey(sht_info, hash, name, keys, &keyBlock, &index) != 0) return -1;
+	if (index == -1) {
+		BF_Block_Destroy(&keys);
+		return 0;
+	}
+
+	SHT_keyEntry key = SHT_KEYS(BF_Block_GetData(keys))[index];
+	if (TC(BF_UnpinBlock(keys)) != 0) return -1;
+	BF_Block_Destroy(&keys);
+
+	int count = 0, capacity = key.count > 0 ? key.count : 1;
+	int* blocks = malloc(sizeof(int) * capacity);
+	if (blocks == NULL) return -1;
+	if (SHT_CollectPostings(sht_info, key.postings, &blocks, &count, &capacity) != 0) {
+		free(blocks);
+		return -1;
+	}
+	for (int i = 0; i < count; i++)
+		printf("Found entry: <%s,%d> in the index\n", key.value, blocks[i]);
+
+	int blocksRead = sht_info->rids ? SHT_FetchRids(ht_info, sht_info, blocks, count, name) : SHT_FetchPrimary(ht_info, sht_info, blocks, count, name);
+	free(blocks);
+	return blocksRead;
+}
+
 int SHT_SecondaryGetAllEntries(HT_info* ht_info, SHT_info* sht_info, char* name) {
 
 	int error;
-  	int hash = hash_string(name) % sht_info->numBuckets;
+  	int hash = SHT_Bucket(sht_info, name);
   	int bucket = sht_info->hashTable[hash];
+	unsigned int nameHash = HF_HashString(sht_info->hashFunction, name);
+	unsigned char tag = HF_Fingerprint(nameHash);
 
-  	BF_Block* block; 		// Create a block
-	BF_Block_Init(&block); 	// Initialize the block
-
-	error = TC(BF_GetBlock(sht_info->fileDesc, bucket, block));
-	if (error != 0) return -1;
+	// A negative answer of the filter means the name is not in the index, no block is read
+	if (sht_info->filterBytes > 0) {
+		int found = BLOOM_MayContain(sht_info->fileDesc, sht_info->filterBlock, sht_info->filterBytes, hash, nameHash);
+		if (found != 1) return found == 0 ? 0 : -1;
+	}
+	if (sht_info->postings) return SHT_GetPostings(ht_info, sht_info, name, hash);
 
-	char* blockData = BF_Block_GetData(block);
+	BF_Block* indexBlock;	// The current block of the index chain, pinned while its entries are read
+	BF_Block_Init(&indexBlock);
 
-  	error = TC(BF_UnpinBlock(block));
+	error = TC(BF_GetBlock(sht_info->fileDesc, bucket, indexBlock));
 	if (error != 0) return -1;
 
+	char* blockData = BF_Block_GetData(indexBlock);
+
   	SHT_block_info* blockInfoRead = (SHT_block_info *) blockData;
-  	int blocksRead = 0;
+
+	// The primary blocks of the name are gathered first, and read once the chain is done
+	int capacity = 64, count = 0;
+	int* blocks = malloc(sizeof(int) * capacity);
+	if (blocks == NULL) return -1;
 
   	// Go down the chain of blocks in the SECONDARY INDEX
   	while ( true ) {
     
+		// With fingerprints, only the entries whose tag matches are compared
+		unsigned long long candidates = ~0ull;
+		if (sht_info->tagBytes > 0)
+			candidates = HF_MatchTags(SHT_TAGS(blockData), blockInfoRead->currentRecords, tag);
+
     	// Iterate through all entries inside the bucket of the SECONDARY INDEX
     	for(int i = 0; i < blockInfoRead->currentRecords; i++) {
+			if (i < 64 && (candidates >> i & 1) == 0) continue;
       
       		// Check every entry inside the SECONDARY INDEX
-      		char* data = blockData +  sizeof(SHT_block_info) + i * (sizeof(secIndexEntry));
-      		secIndexEntry entry = (secIndexEntry) *( (secIndexEntry*) data); // Cast the data to Record
+      		secIndexEntry entry;
+      		if (SHT_BlockEntry(sht_info, blockData, i, &entry) != 0) continue;
 	
-     		if	(strcmp(entry.name, name) == 0) {
-        		printf("Found entry: <%s,%d> in the index\n", entry.name, entry.blockId); // Print the record
-        		error = TC(BF_GetBlock(ht_info->fileDesc, entry.blockId, block)); 		// Get the block of the record
-				if (error != 0) return -1;
-        		
-				HT_block_info* HT_header = (HT_block_info*) BF_Block_GetData(block);   // Get the data of the block
-        		blocksRead++; // Increase the number of blocks read
-
-        		// Iterate through all records of the block of the PRIMARY INDEX
-        		// To find if there is a record inside, with the same name
-        		for (int i = 0; i < HT_header->currentRecords; i++) { 
-					char* data = (char*) HT_header +  sizeof(HT_block_info) + i * (sizeof(Record)); 
-        		  	Record record = (Record) *( (Record*) data); // Cast the data to Record
-        		  	// If the name of the record is the same as the name we are looking for
-        		  	if ( strcmp(name, record.name ) == 0) {
-				    	    printf("%d \t\t %s \t %s \t %s \n", record.id, record.name, record.surname, record.city);
-        		    }
-        		}
-        		error = TC(BF_UnpinBlock(block));
-				if (error != 0) return -1;
+     		if	(strcmp(entry.value, name) == 0) {
+        		printf("Found entry: <%s,%d> in the index\n", entry.value, entry.blockId); // Print the record
+				if (SHT_PushBlock(&blocks, &count, &capacity, entry.blockId) != 0) return -1;
 			}
     	}
     	// Check if there is a next block (overflow)
@@ -392,23 +1184,442 @@ int SHT_SecondaryGetAllEntries(HT_info* ht_info, SHT_info* sht_info, char* name)
 			break; // If there is no next block, break the loop
 	  	else {
       		// Now get the next block
-			error = TC(BF_GetBlock(sht_info->fileDesc, blockInfoRead->nextBlock, block));
+			int nextBlock = blockInfoRead->nextBlock;
+			error = TC(BF_UnpinBlock(indexBlock));
+			if (error != 0) return -1;
+
+			error = TC(BF_GetBlock(sht_info->fileDesc, nextBlock, indexBlock));
+			if (error != 0) return -1;
 
-			blockData = BF_Block_GetData(block); // Get the data of the block
+			blockData = BF_Block_GetData(indexBlock); // Get the data of the block
 			blockInfoRead = (SHT_block_info*) blockData; // Cast the data to HT_block_info
 		}
 	}
 
+	error = TC(BF_UnpinBlock(indexBlock));
+	if (error != 0) return -1;
+	BF_Block_Destroy(&indexBlock);
+
+	int blocksRead = sht_info->rids ? SHT_FetchRids(ht_info, sht_info, blocks, count, name) : SHT_FetchPrimary(ht_info, sht_info, blocks, count, name);
+	free(blocks);
+	return blocksRead;
+}
+
+int SHT_SecondaryGetCovered(SHT_info* sht_info, char* name, Record_Key columns, SHT_Callback callback, void* context) {
+	if ((columns & ~(sht_info->include | RECORD_KEY(sht_info->attribute))) != 0) return -1;
+
+	int error;
+	int hash = SHT_Bucket(sht_info, name);
+	unsigned int nameHash = HF_HashString(sht_info->hashFunction, name);
+	unsigned char tag = HF_Fingerprint(nameHash);
+
+	if (sht_info->filterBytes > 0) {
+		int found = BLOOM_MayContain(sht_info->fileDesc, sht_info->filterBlock, sht_info->filterBytes, hash, nameHash);
+		if (found != 1) return found == 0 ? 0 : -1;
+	}
+
+	BF_Block* block;
+	BF_Block_Init(&block);
+	int blocksRead = 0;
+
+	// The entries answer the query themselves, the primary file is never opened
+	int current = sht_info->hashTable[hash];
+	while (current != -1) {
+		error = TC(BF_GetBlock(sht_info->fileDesc, current, block));
+		if (error != 0) return -1;
+		blocksRead++;
+
+		char* blockData = BF_Block_GetData(block);
+		SHT_block_info* blockInfo = (SHT_block_info*) blockData;
+		unsigned long long candidates = ~0ull;
+		if (sht_info->tagBytes > 0)
+			candidates = HF_MatchTags(SHT_TAGS(blockData), blockInfo->currentRecords, tag);
+
+		for (int i = 0; i < blockInfo->currentRecords; i++) {
+			if (i < 64 && (candidates >> i & 1) == 0) continue;
+
+			secIndexEntry entry;
+			if (SHT_BlockEntry(sht_info, blockData, i, &entry) != 0 || strcmp(entry.value, name) != 0) continue;
+
+			Record record;
+			memset(&record, 0, sizeof(Record));
+			strcpy(SHT_Value(sht_info, &record), entry.value);
+			if (sht_info->include & RECORD_KEY(ID)) record.id = entry.id;
+			if (sht_info->include & RECORD_KEY(NAME)) strcpy(record.name, entry.name);
+			if (sht_info->include & RECORD_KEY(SURNAME)) strcpy(record.surname, entry.surname);
+			if (sht_info->include & RECORD_KEY(CITY)) strcpy(record.city, entry.city);
+			callback(&record, entry.blockId, context);
+		}
+
+		current = blockInfo->nextBlock;
+		error = TC(BF_UnpinBlock(block));
+		if (error != 0) return -1;
+	}
+
 	BF_Block_Destroy(&block);
 	return blocksRead;
 }
 
+// An index entry tagged with its bucket, the unit of the bulk placement
+typedef struct {
+	int bucket;
+	secIndexEntry entry;
+} SHT_bulkEntry;
+
+static int compareBulkEntries(const void* a, const void* b) {
+	const SHT_bulkEntry* x = a;
+	const SHT_bulkEntry* y = b;
+	if (x->bucket != y->bucket) return x->bucket < y->bucket ? -1 : 1;
+	int names = strcmp(x->entry.value, y->entry.value);
+	if (names != 0) return names;
+	return (x->entry.blockId > y->entry.blockId) - (x->entry.blockId < y->entry.blockId);
+}
+
+// SHT_BulkPlace for an index with posting lists. The blocks of every name come sorted, so the differences are small.
+static int SHT_BulkPlacePostings(SHT_info* sht_info, SHT_bulkEntry* entries, size_t n) {
+	int fileDescriptor = sht_info->fileDesc;
+	BF_Block* block;
+	BF_Block_Init(&block);
+
+	size_t i = 0;
+	while (i < n) {
+		// Entries [i, last) have the same bucket and name
+		size_t last = i;
+		while (last < n && entries[last].bucket == entries[i].bucket && strcmp(entries[last].entry.value, entries[i].entry.value) == 0)
+			last++;
+
+		SHT_keyEntry key = { { 0 }, -1, 0 };
+		strcpy(key.value, entries[i].entry.value);
+		for (size_t j = i; j < last; j++) {
+			if (j > i && entries[j].entry.blockId == entries[j - 1].entry.blockId) continue;
+			key.count++;
+			if (key.postings != -1 && SHT_AppendPosting(BF_Block_GetData(block), entries[j].entry.blockId) == 0) continue;
+
+			// The list goes on in a new block, which points back to the full one
+			if (key.postings != -1) {
+				LATCH_SetDirty(block);
+				if (TC(LATCH_UnpinBlock(block)) != 0) return -1;
+			}
+			int newBlock;
+			if (TC(LATCH_AllocateBlock(fileDescriptor, block, &newBlock)) != 0) return -1;
+			SHT_InitPostings(BF_Block_GetData(block), key.postings);
+			SHT_AppendPosting(BF_Block_GetData(block), entries[j].entry.blockId);
+			key.postings = newBlock;
+		}
+		LATCH_SetDirty(block);
+		if (TC(LATCH_UnpinBlock(block)) != 0) return -1;
+
+		if (SHT_PlaceKey(sht_info, entries[i].bucket, &key) != 0) return -1;
+		if (sht_info->filterBytes > 0) {
+			unsigned int nameHash = HF_HashString(sht_info->hashFunction, key.value);
+			if (BLOOM_Add(fileDescriptor, sht_info->filterBlock, sht_info->filterBytes, entries[i].bucket, nameHash) != 0) return -1;
+		}
+		i = last;
+	}
+
+	BF_Block_Destroy(&block);
+	return 0;
+}
+
+// Places the n entries in an empty index, bucket by bucket. The entries come sorted, which brings equal
+// <name, blockId> pairs together, so duplicates are dropped without searching the chains.
+static int SHT_BulkPlace(SHT_info* sht_info, SHT_bulkEntry* entries, size_t n) {
+	int error;
+	int fileDescriptor = sht_info->fileDesc;
+
+	if (sht_info->postings) return SHT_BulkPlacePostings(sht_info, entries, n);
+
+	BF_Block* block;
+	BF_Block_Init(&block);
+
+	size_t i = 0;
+	while (i < n) {
+		int b = entries[i].bucket;
+
+		// The head of the bucket is filled first, the blocks allocated after it are consecutive
+		int current = sht_info->hashTable[b];
+		error = TC(BF_GetBlock(fileDescriptor, current, block));
+		if (error != 0) return -1;
+		char* blockData = BF_Block_GetData(block);
+
+		for (; i < n && entries[i].bucket == b; i++) {
+			if (i > 0 && compareBulkEntries(&entries[i - 1], &entries[i]) == 0) continue;
+
+			secIndexEntry* entry = &entries[i].entry;
+			unsigned int nameHash = HF_HashString(sht_info->hashFunction, entry->value);
+			unsigned char tag = HF_Fingerprint(nameHash);
+
+			if (SHT_PlaceEntry(sht_info, blockData, entry, tag) != 0) {
+				BF_Block_SetDirty(block);
+				error = TC(BF_UnpinBlock(block));
+				if (error != 0) return -1;
+
+				error = TC(BF_AllocateBlock(fileDescriptor, block));
+				if (error != 0) return -1;
+
+				int previous = current;
+				BF_GetBlockCounter(fileDescriptor, &current);
+				current--;
+
+				blockData = BF_Block_GetData(block);
+				SHT_InitBlock(sht_info, blockData, previous);	// Reverse chaining, as in inserts
+				SHT_PlaceEntry(sht_info, blockData, entry, tag);
+			}
+
+			if (sht_info->filterBytes > 0) {
+				error = BLOOM_Add(fileDescriptor, sht_info->filterBlock, sht_info->filterBytes, b, nameHash);
+				if (error != 0) return -1;
+			}
+		}
+
+		BF_Block_SetDirty(block);
+		error = TC(BF_UnpinBlock(block));
+		if (error != 0) return -1;
+
+		sht_info->hashTable[b] = current;
+	}
+
+	BF_Block_Destroy(&block);
+	return 0;
+}
+
+// Threads that scan the primary file when an index is built, each over its own range of primary buckets
+#define SHT_BUILD_THREADS 4
+
+// The entries one builder thread gathers from its primary buckets, each tagged with its index bucket
+typedef struct {
+	SHT_info* sht_info;
+	HT_info* ht_info;
+	int first;		// Primary buckets [first, last)
+	int last;
+	SHT_bulkEntry* entries;
+	size_t count;
+	size_t capacity;
+	int error;
+} SHT_buildPart;
+
+static void SHT_CollectEntry(int key, Record* record, int rid, void* context) {
+	(void) key;
+	SHT_buildPart* part = context;
+	if (part->error != 0) return;
+	if (part->count == part->capacity) {
+		size_t capacity = part->capacity == 0 ? 1024 : 2 * part->capacity;
+		SHT_bulkEntry* entries = realloc(part->entries, capacity * sizeof(SHT_bulkEntry));
+		if (entries == NULL) {
+			part->error = -1;
+			return;
+		}
+		part->entries = entries;
+		part->capacity = capacity;
+	}
+	SHT_bulkEntry* bulk = &part->entries[part->count++];
+	SHT_MakeEntry(part->sht_info, &bulk->entry, record, part->sht_info->rids ? rid : HT_RID_BLOCK(rid));
+	bulk->bucket = SHT_Bucket(part->sht_info, bulk->entry.value);
+}
+
+static void* SHT_BuildPart(void* argument) {
+	SHT_buildPart* part = argument;
+	if (HT_ScanBuckets(part->ht_info, part->first, part->last, SHT_CollectEntry, part) == -1) part->error = -1;
+	return NULL;
+}
+
+// Fills the empty, open index with the entries of the open primary file. The threads decode and hash the
+// records of their buckets side by side, the entries are then partitioned by index bucket with a counting
+// sort and every bucket is sorted on its own, so that its chain is written in one pass.
+static int SHT_Build(SHT_info* sht_info, HT_info* ht_info) {
+	int threads = ht_info->numBuckets < SHT_BUILD_THREADS ? ht_info->numBuckets : SHT_BUILD_THREADS;
+	SHT_buildPart parts[SHT_BUILD_THREADS];
+	pthread_t ids[SHT_BUILD_THREADS];
+	int error = 0, started = 0;
+
+	for (int t = 0; t < threads; t++) {
+		parts[t] = (SHT_buildPart) { sht_info, ht_info, 0, 0, NULL, 0, 0, 0 };
+		parts[t].first = (int) ((long) ht_info->numBuckets * t / threads);
+		parts[t].last = (int) ((long) ht_info->numBuckets * (t + 1) / threads);
+	}
+	for (; started < threads; started++)
+		if (pthread_create(&ids[started], NULL, SHT_BuildPart, &parts[started]) != 0) break;
+	for (int t = 0; t < started; t++)
+		pthread_join(ids[t], NULL);
+
+	// A thread that could not start leaves its buckets to this one
+	for (int t = started; t < threads; t++)
+		SHT_BuildPart(&parts[t]);
+
+	size_t n = 0;
+	for (int t = 0; t < threads; t++) {
+		if (parts[t].error != 0) error = -1;
+		n += parts[t].count;
+	}
+
+	size_t* starts = calloc(sht_info->numBuckets + 1, sizeof(size_t));
+	SHT_bulkEntry* entries = malloc((n > 0 ? n : 1) * sizeof(SHT_bulkEntry));
+	if (starts == NULL || entries == NULL) error = -1;
+
+	if (error == 0) {
+		for (int t = 0; t < threads; t++)
+			for (size_t i = 0; i < parts[t].count; i++)
+				starts[parts[t].entries[i].bucket + 1]++;
+		for (long b = 0; b < sht_info->numBuckets; b++)
+			starts[b + 1] += starts[b];
+
+		// starts[b] runs ahead as bucket b fills, and ends up at the start of bucket b + 1
+		for (int t = 0; t < threads; t++)
+			for (size_t i = 0; i < parts[t].count; i++)
+				entries[starts[parts[t].entries[i].bucket]++] = parts[t].entries[i];
+
+		size_t first = 0;
+		for (long b = 0; b < sht_info->numBuckets; b++) {
+			qsort(entries + first, starts[b] - first, sizeof(SHT_bulkEntry), compareBulkEntries);
+			first = starts[b];
+		}
+		error = SHT_BulkPlace(sht_info, entries, n);
+	}
+
+	for (int t = 0; t < threads; t++)
+		free(parts[t].entries);
+	free(starts);
+	free(entries);
+	return error;
+}
+
+static int SHT_BuildFromFile(char* sfileName, char* fileName) {
+	HT_info* ht_info = HT_OpenFile(fileName);
+	if (ht_info == NULL) return -1;
+	SHT_info* sht_info = SHT_OpenSecondaryIndex(sfileName);
+	int error = sht_info == NULL ? -1 : SHT_Build(sht_info, ht_info);
+
+	// Registered in the primary header, SHT_OpenFiles opens it along with the file
+	if (error == 0) error = HT_RegisterIndex(ht_info, sfileName);
+	if (sht_info != NULL && SHT_CloseSecondaryIndex(sht_info) != 0) error = -1;
+	if (HT_CloseFile(ht_info) != 0) error = -1;
+	return error;
+}
+
+int SHT_Reorganize(char* sfileName, int buckets, HT_info* ht_info, SHT_options options) {
+	char* newName = malloc(strlen(sfileName) + strlen(".reorg") + 1);
+	sprintf(newName, "%s.reorg", sfileName);
+	remove(newName);
+
+	// The entries come from the primary file, whose block numbers may have changed
+	int error = SHT_CreateSecondaryIndexWithOptions(newName, buckets, NULL, options);	// Built from the open file below
+	SHT_info* info = error == 0 ? SHT_OpenSecondaryIndex(newName) : NULL;
+	if (info == NULL) error = -1;
+	if (error == 0) error = SHT_Build(info, ht_info);
+	if (info != NULL && SHT_CloseSecondaryIndex(info) != 0) error = -1;
+
+	// The swap is a single rename, an index opened before it still reads the old blocks
+	if (error == 0 && rename(newName, sfileName) != 0) error = -1;
+	if (error != 0) remove(newName);
+
+	free(newName);
+	return error;
+}
+
+SHT_files* SHT_OpenFiles(char* fileName) {
+	SHT_files* files = malloc(sizeof(SHT_files));
+	if (files == NULL) return NULL;
+	files->info = HT_OpenFile(fileName);
+	if (files->info == NULL) {
+		free(files);
+		return NULL;
+	}
+
+	files->indexCount = 0;
+	files->indexes = malloc(sizeof(SHT_info*) * (files->info->indexCount + 1));
+	int error = files->indexes == NULL ? -1 : 0;
+	for (int i = 0; error == 0 && i < files->info->indexCount; i++) {
+		files->indexes[i] = SHT_OpenSecondaryIndex(files->info->indexNames + i * HT_INDEX_NAME_SIZE);
+		if (files->indexes[i] == NULL) error = -1;
+		else files->indexCount++;
+	}
+
+	if (error != 0) {
+		SHT_CloseFiles(files);
+		return NULL;
+	}
+	return files;
+}
+
+int SHT_CloseFiles(SHT_files* files) {
+	int error = 0;
+	for (int i = 0; i < files->indexCount; i++)
+		if (SHT_CloseSecondaryIndex(files->indexes[i]) != 0) error = -1;
+	if (HT_CloseFile(files->info) != 0) error = -1;
+	free(files->indexes);
+	free(files);
+	return error;
+}
+
+// An index of blocks gets the block of the rid, an index of rids the rid itself
+static int SHT_Pointer(SHT_info* sht_info, int rid) {
+	return sht_info->rids ? rid : HT_RID_BLOCK(rid);
+}
+
+int SHT_InsertEntries(SHT_files* files, Record* records, size_t n) {
+	int* rids = malloc(sizeof(int) * (n + 1));
+	int* pointers = malloc(sizeof(int) * (n + 1));
+	int error = rids == NULL || pointers == NULL ? -1 : 0;
+
+	for (size_t i = 0; error == 0 && i < n; i++)
+		if (HT_InsertEntryWithRid(files->info, records[i], &rids[i]) == -1) error = -1;
+
+	// Every index gets the whole batch, grouped by bucket
+	for (int i = 0; error == 0 && i < files->indexCount; i++) {
+		for (size_t r = 0; r < n; r++)
+			pointers[r] = SHT_Pointer(files->indexes[i], rids[r]);
+		error = SHT_SecondaryInsertEntries(files->indexes[i], records, pointers, n);
+	}
+
+	free(rids);
+	free(pointers);
+	return error;
+}
+
+typedef struct {
+	SHT_files* files;
+	int error;
+} SHT_maintenance;
+
+static void SHT_Unindex(int key, Record* record, int rid, void* context) {
+	(void) key;
+	SHT_maintenance* maintenance = context;
+	SHT_files* files = maintenance->files;
+	for (int i = 0; i < files->indexCount; i++)
+		if (SHT_SecondaryDeleteEntry(files->info, files->indexes[i], *record, SHT_Pointer(files->indexes[i], rid)) != 0)
+			maintenance->error = -1;
+}
+
+static void SHT_Reindex(Record* old, int oldRid, Record* updated, int newRid, void* context) {
+	SHT_maintenance* maintenance = context;
+	SHT_files* files = maintenance->files;
+	for (int i = 0; i < files->indexCount; i++) {
+		SHT_info* sht_info = files->indexes[i];
+		int from = SHT_Pointer(sht_info, oldRid);
+		int to = SHT_Pointer(sht_info, newRid);
+
+		// An index of blocks does not see a record that stays in its block with the same value
+		if (from == to && strcmp(SHT_Value(sht_info, old), SHT_Value(sht_info, updated)) == 0) continue;
+		if (SHT_SecondaryDeleteEntry(files->info, sht_info, *old, from) != 0) maintenance->error = -1;
+		if (SHT_SecondaryInsertEntry(sht_info, *updated, to) != 0) maintenance->error = -1;
+	}
+}
+
+int SHT_DeleteEntry(SHT_files* files, int id) {
+	SHT_maintenance maintenance = { files, 0 };
+	int deleted = HT_DeleteEntry(files->info, id, SHT_Unindex, SHT_Reindex, &maintenance);
+	return maintenance.error != 0 ? -1 : deleted;
+}
+
+int SHT_UpdateEntry(SHT_files* files, int id, Record record) {
+	SHT_maintenance maintenance = { files, 0 };
+	int updated = HT_UpdateEntry(files->info, id, record, SHT_Reindex, &maintenance);
+	return maintenance.error != 0 ? -1 : updated;
+}
+
 unsigned int hash_string(void* value) {
 	// djb2 hash function, απλή, γρήγορη, και σε γενικές γραμμές αποδοτική
-    unsigned int hash = 5381;
-    for (char* s = value; *s != '\0'; s++)
-		hash = (hash << 5) + hash + *s;			// hash = (hash * 33) + *s. Το foo << 5 είναι γρηγορότερη εκδοχή του foo * 32.
-    return hash;
+	return HF_HashString(DEFAULT_HASH, value);
 }
 
 int HashStatisticsSHT(char* filename) {
@@ -445,6 +1656,10 @@ int HashStatisticsSHT(char* filename) {
 	int buckets = info->numBuckets;
 	int recordsCount = 0;
 
+	// The bucket heads live in the directory chain, not in block 0
+	int* hashTable; int size;
+	if (BC_Read(fileDesc, info->directoryBlock, (char**) &hashTable, &size) != 0) return -1;
+
 	// for each bucket:
 	// MIN,MID AND MAX NUMBER OF RECORDS in buckets
 	// Go through each bucket, get number of records
@@ -466,7 +1681,7 @@ int HashStatisticsSHT(char* filename) {
 
 	for(int i = 0; i < buckets; i++) {
 		int error;
-		int bucket = info->hashTable[i];
+		int bucket = hashTable[i];
 		error = TC(BF_GetBlock(fileDesc, bucket, blockOfBucket));
 		if (error != 0) return -1;
 
@@ -531,6 +1746,7 @@ int HashStatisticsSHT(char* filename) {
 
 	free(blocksInBucket);
 	free(recordsInBuckets);
+	free(hashTable);
 	free(ptr);
 	
 	// Close file
@@ -0,0 +1,108 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "slotted_page.h"
+
+#define SLOT(page, i) ((SP_slot*) ((page) + sizeof(SP_header)) + (i))
+
+void SP_Init(char* page, int size) {
+	SP_header* header = (SP_header*) page;
+	header->size = size;
+	header->slots = 0;
+	header->freeStart = sizeof(SP_header);
+	header->freeEnd = size;
+	header->fragmented = 0;
+}
+
+// First empty slot that can be reused, or -1
+static int freeSlot(char* page) {
+	SP_header* header = (SP_header*) page;
+	for (int i = 0; i < header->slots; i++)
+		if (SLOT(page, i)->length == 0)
+			return i;
+	return -1;
+}
+
+int SP_Insert(char* page, const char* tuple, int length) {
+	SP_header* header = (SP_header*) page;
+	int slot = freeSlot(page);
+
+	// A new directory entry costs a slot on top of the tuple itself
+	int needed = length + (slot == -1 ? sizeof(SP_slot) : 0);
+	int contiguous = header->freeEnd - header->freeStart;
+
+	if (contiguous < needed) {
+		if (contiguous + header->fragmented < needed)
+			return -1;
+		SP_Compact(page);
+	}
+
+	if (slot == -1) {
+		slot = header->slots++;
+		header->freeStart += sizeof(SP_slot);
+	}
+
+	header->freeEnd -= length;
+	memcpy(page + header->freeEnd, tuple, length);
+	SLOT(page, slot)->offset = header->freeEnd;
+	SLOT(page, slot)->length = length;
+
+	return slot;
+}
+
+char* SP_Get(char* page, int slot, int* length) {
+	SP_header* header = (SP_header*) page;
+	if (slot < 0 || slot >= header->slots || SLOT(page, slot)->length == 0)
+		return NULL;
+
+	*length = SLOT(page, slot)->length;
+	return page + SLOT(page, slot)->offset;
+}
+
+void SP_Delete(char* page, int slot) {
+	SP_header* header = (SP_header*) page;
+	if (slot < 0 || slot >= header->slots || SLOT(page, slot)->length == 0)
+		return;
+
+	header->fragmented += SLOT(page, slot)->length;
+	SLOT(page, slot)->length = 0;
+
+	// Trailing empty slots can be dropped from the directory altogether
+	while (header->slots > 0 && SLOT(page, header->slots - 1)->length == 0) {
+		header->slots--;
+		header->freeStart -= sizeof(SP_slot);
+	}
+}
+
+void SP_Compact(char* page) {
+	SP_header* header = (SP_header*) page;
+	char* copy = malloc(header->size);
+	memcpy(copy, page, header->size);
+
+	// Rewrite every live tuple from the end of the page, keeping slot numbers
+	int end = header->size;
+	for (int i = 0; i < header->slots; i++) {
+		SP_slot* slot = SLOT(page, i);
+		if (slot->length == 0) continue;
+
+		end -= slot->length;
+		memcpy(page + end, copy + slot->offset, slot->length);
+		slot->offset = end;
+	}
+
+	header->freeEnd = end;
+	header->fragmented = 0;
+	free(copy);
+}
+
+int SP_Slots(char* page) {
+	return ((SP_header*) page)->slots;
+}
+
+int SP_FreeSpace(char* page) {
+	SP_header* header = (SP_header*) page;
+	int space = header->freeEnd - header->freeStart + header->fragmented;
+	if (freeSlot(page) == -1) space -= sizeof(SP_slot);
+	return space < 0 ? 0 : space;
+}